@@ -0,0 +1,79 @@
+// -*- C++ -*-
+//
+// This file is part of YODA -- Yet more Objects for Data Analysis
+// Copyright (C) 2008-2021 The YODA collaboration (see AUTHORS for details)
+//
+#include "YODA/Merge.h"
+#include "YODA/WriterYODA.h"
+#include "YODA/IO.h"
+#include <iostream>
+#include <cstring>
+
+using namespace std;
+
+
+namespace {
+
+  const char* USAGE =
+    "Usage: yodamerge-native [-o outfile] [-m PATT] [-M PATT] [-q|-v] <yodafile1> <yodafile2> ...\n"
+    "\n"
+    "Merge analysis objects from multiple YODA files, as yodamerge does, streaming\n"
+    "one file at a time so that only the merged objects are held in memory.\n"
+    "\n"
+    "Options:\n"
+    "  -o, --output PATH   write output to the specified path (default: stdout)\n"
+    "  -m, --match PATT    only merge objects whose path matches this regex\n"
+    "  -M, --unmatch PATT  exclude objects whose path matches this regex\n"
+    "  -v, --verbose       print extra merging details\n"
+    "  -q, --quiet         only print fatal errors\n"
+    "  -h, --help          show this message\n";
+
+}
+
+
+int main(int argc, char** argv) {
+  string outfile = "-";
+  vector<string> infiles, patterns, unpatterns;
+  int verbosity = 1;
+  for (int i = 1; i < argc; ++i) {
+    const string arg = argv[i];
+    const bool hasval = i+1 < argc;
+    if (arg == "-h" || arg == "--help") {
+      cout << USAGE;
+      return EXIT_SUCCESS;
+    } else if ((arg == "-o" || arg == "--output") && hasval) {
+      outfile = argv[++i];
+    } else if ((arg == "-m" || arg == "--match") && hasval) {
+      patterns.push_back(argv[++i]);
+    } else if ((arg == "-M" || arg == "--unmatch") && hasval) {
+      unpatterns.push_back(argv[++i]);
+    } else if (arg == "-v" || arg == "--verbose") {
+      verbosity = 2;
+    } else if (arg == "-q" || arg == "--quiet") {
+      verbosity = 0;
+    } else if (arg.size() > 1 && arg[0] == '-') {
+      cerr << "Unknown or incomplete option " << arg << "\n\n" << USAGE;
+      return EXIT_FAILURE;
+    } else {
+      infiles.push_back(arg);
+    }
+  }
+  if (infiles.empty()) {
+    cerr << USAGE;
+    return EXIT_FAILURE;
+  }
+
+  try {
+    vector<YODA::AnalysisObject*> aos = YODA::mergeFiles(infiles, patterns, unpatterns, verbosity);
+    // Progress goes to stderr, to keep stdout for the merged data
+    if (verbosity > 0) cerr << "Writing merged data to " << outfile << endl;
+    if (outfile == "-") YODA::WriterYODA::create().write(cout, aos);
+    else YODA::write(outfile, aos);
+    for (YODA::AnalysisObject* ao : aos) delete ao;
+  } catch (const exception& e) {
+    cerr << "yodamerge-native: " << e.what() << endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
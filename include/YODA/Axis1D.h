@@ -4,6 +4,11 @@
 #include "YODA/AnalysisObject.h"
 #include "YODA/Exceptions.h"
 #include "YODA/Bin.h"
+#include "YODA/Dbn0D.h"
+#include "YODA/Dbn1D.h"
+#include "YODA/Dbn2D.h"
+#include "YODA/DbnColumns.h"
+#include "YODA/Fillable.h"
 #include "YODA/Utils/MathUtils.h"
 #include "YODA/Utils/BinSearcher.h"
 #include <limits>
@@ -12,10 +17,22 @@
 namespace YODA {
 
 
+  /// Default number of fills from which an auto-binned axis chooses its bins
+  const size_t AUTOBIN_BUFFER_SIZE = 10000;
+
+
   /// @brief 1D bin container
   ///
   /// This class handles most of the low-level operations on an axis of bins
   /// arranged in a 1D line (including gaps).
+  ///
+  /// An axis may also be auto-binned: the first fills are queued, and the bin
+  /// edges are chosen from them with autospace, when the queue is full or
+  /// autoBook is called. The queued fills are then replayed into the new bins,
+  /// and later fills outside their range go to the outflows.
+  ///
+  /// The bin contents may also be held in columnar form, as a DbnColumns, for
+  /// faster whole-axis operations: see setColumnar.
   template <typename BIN1D, typename DBN>
   class Axis1D {
   public:
@@ -80,12 +97,26 @@ namespace YODA {
       addBins(bins);
     }
 
+
+    /// @brief Constructor for an auto-binned axis, of @a nbins bins chosen from the first @a nbuffer fills
+    ///
+    /// Quantile binning may give fewer than @a nbins bins, if many fills have the same value.
+    Axis1D(size_t nbins, AutoBinning mode, size_t nbuffer=AUTOBIN_BUFFER_SIZE)
+      : _locked(false), _autoNumBins(nbins), _autoMode(mode), _autoBufferSize(nbuffer)
+    {
+      if (nbins == 0) throw RangeError("An auto-binned axis needs at least one bin");
+      if (nbuffer == 0) throw RangeError("An auto-binned axis needs at least one fill to choose its bins");
+    }
+
+    /// @}
+
+
     /// @name Statistics accessor functions
     /// @{
 
     /// Get the number of bins on the axis
     size_t numBins() const {
-      return bins().size();
+      return _bins.size();
     }
 
     /// Return a vector of bins (const)
@@ -95,19 +126,20 @@ namespace YODA {
 
     /// Return a vector of bins (non-const)
     Bins& bins() {
+      _colsStale = true;
       return _bins;
     }
 
     /// Return the lowest-value bin edge on the axis
     double xMin() const {
       if (numBins() == 0) throw RangeError("This axis contains no bins and so has no defined range");
-      return bins().front().xMin();
+      return _bins.front().xMin();
     }
 
     /// Return the highest-value bin edge on the axis
     double xMax() const {
       if (numBins() == 0) throw RangeError("This axis contains no bins and so has no defined range");
-      return bins().back().xMax();
+      return _bins.back().xMax();
     }
 
     /// Return all the Nbin+1 bin edges on the axis
@@ -135,6 +167,7 @@ namespace YODA {
     /// Return a bin at a given index (non-const)
     BIN1D& bin(size_t index) {
       if (index >= numBins()) throw RangeError("YODA::Histo1D: index out of range!");
+      if (_columnar) _dirtyBins.push_back(index);
       return _bins[index];
     }
 
@@ -144,12 +177,29 @@ namespace YODA {
       return _bins[index];
     }
 
+    /// Midpoint of the bin at a given index
+    double binMid(size_t index) const {
+      if (index >= numBins()) throw RangeError("YODA::Histo1D: index out of range!");
+      return _bins[index].xMid();
+    }
+
     /// Returns an index of a bin at a given coord, -1 if no bin matches
     ssize_t binIndexAt(double coord) const {
       // Yes, this is robust even with an empty axis: there's always at least one outflow
       return _indexes[_binsearcher.index(coord)];
     }
 
+    /// @brief Look up the bin indices of @a n coordinates in one pass
+    ///
+    /// Each entry of @a out is set as for binIndexAt, i.e. -1 if no bin matches,
+    /// and NaNs are treated as underflows. The search is vectorised via BinSearcher::indices.
+    void binIndicesAt(size_t n, const double* coords, ssize_t* out) const {
+      // Search into the output array, then map the searcher indices to bin indices in place
+      size_t* ixs = reinterpret_cast<size_t*>(out);
+      _binsearcher.indices(coords, n, ixs);
+      for (size_t k = 0; k < n; ++k) out[k] = _indexes[ixs[k]];
+    }
+
     /// Return a bin at a given coordinate (non-const)
     BIN1D& binAt(double x) {
       const ssize_t index = binIndexAt(x);
@@ -204,6 +254,246 @@ namespace YODA {
       _overflow = dbn;
     }
 
+    /// Sum of the bin distributions, i.e. the total without the outflows and bin-gap fills
+    DBN binTotalDbn() const {
+      if (_columnar && _colsCurrent()) return _cols.total();
+      DBN rtn;
+      for (const Bin& b : _bins) rtn += b.dbn();
+      return rtn;
+    }
+
+    /// @}
+
+
+    /// @name Columnar storage
+    /// @{
+
+    /// @brief Hold the bin contents as one array per running sum, or as the bins vector
+    ///
+    /// With columnar storage, fills and the whole-axis operations scaleW, +=,
+    /// -=, reset and binTotalDbn work on the arrays, and each change is
+    /// written straight back to the bins it touches, so the bins vector is
+    /// always current and const reads never modify the axis. Bins changed
+    /// through the non-const bin() are re-read into the arrays at the next
+    /// fill or whole-axis operation, and all of them after the non-const
+    /// bins(). The results are identical in either form, down to the exact
+    /// counts of unit fills.
+    void setColumnar(bool columnar=true) {
+      _columnar = columnar;
+      _colsStale = true;
+      _dirtyBins.clear();
+      if (columnar) _syncCols();
+      else _cols.clear();
+    }
+
+    /// Whether the bin contents are held in columnar form
+    bool columnar() const { return _columnar; }
+
+    /// @brief Fill bin @a i
+    ///
+    /// The @a y coordinate is ignored for 1D distributions.
+    void _fillBin(size_t i, double x, double y, double weight, double fraction) {
+      if (_columnar) {
+        _syncCols();
+        _cols.fill(i, x, y, 0, weight, fraction);
+        _bins[i].dbn() = _cols.dbn(i);
+      } else {
+        _fillDbn(_bins[i].dbn(), AutoFill{x, y, weight, fraction});
+      }
+    }
+
+    /// @brief Fill a histogram axis with weight @a weight at @a x
+    ///
+    /// This is the fill of Histo1D and CountHisto1D, whose distribution types
+    /// differ only in the moments recorded, so is not for profile axes.
+    void _fillHisto(double x, double weight, double fraction) {
+      if ( std::isnan(x) ) {
+        if (_nanPolicy == FILL_THROW) throw RangeError("X is NaN");
+        _fillNaN(weight, fraction);
+        return;
+      }
+
+      // Hold back the fill if the bins are still to be chosen, which they can
+      // only be while there are none
+      if (_bins.empty()) {
+        if (!autoBinPending()) throw RangeError("This axis contains no bins and so has no defined range");
+        _bufferFill(x, 0, weight, fraction);
+        return;
+      }
+
+      // Find the bin, applying the gap policy before anything is filled
+      const double xmin = _bins.front().xMin(), xmax = _bins.back().xMax();
+      const bool inrange = inRange(x, xmin, xmax);
+      const ssize_t i = inrange ? binIndexAt(x) : -1;
+      if (inrange && i < 0) _fillGap(x, weight, fraction);
+
+      // Fill the overall distribution
+      const AutoFill f{x, 0, weight, fraction};
+      _fillDbn(_dbn, f);
+
+      // Fill the bins and overflows
+      /// Unify this with Profile1D's version, when binning and inheritance are reworked
+      if (inrange) {
+        if (i >= 0) _fillBin(i, x, 0, weight, fraction);
+      } else if (x < xmin) {
+        _fillDbn(_underflow, f);
+      } else if (x >= xmax) {
+        _fillDbn(_overflow, f);
+      }
+
+      // Lock the axis now that a fill has happened
+      _locked = true;
+    }
+
+    /// @brief Fill a histogram axis at @a n positions @a xs, as by _fillHisto at each in turn
+    ///
+    /// Null @a weights or @a fractions mean all 1.
+    void _fillHistoMany(size_t n, const double* xs, const double* weights, const double* fractions) {
+      // Queue fills one by one until any auto-binning is chosen
+      size_t nqueued = 0;
+      for (; nqueued < n && autoBinPending(); ++nqueued) {
+        _fillHisto(xs[nqueued], weights ? weights[nqueued] : 1.0, fractions ? fractions[nqueued] : 1.0);
+      }
+      if (nqueued > 0) {
+        if (nqueued < n) _fillHistoMany(n-nqueued, xs+nqueued, weights ? weights+nqueued : nullptr, fractions ? fractions+nqueued : nullptr);
+        return;
+      }
+
+      // An empty axis has no range: let the scalar fill handle it
+      if (numBins() == 0) {
+        for (size_t k = 0; k < n; ++k) _fillHisto(xs[k], weights ? weights[k] : 1.0, fractions ? fractions[k] : 1.0);
+        return;
+      }
+
+      const double xmin = xMin(), xmax = xMax();
+
+      // Look up the bin indices a chunk at a time, then accumulate in fill order
+      // so that every Dbn sees the same sequence as with scalar fills
+      bool filled = false;
+      ssize_t ibins[FILLMANY_CHUNK];
+      for (size_t k0 = 0; k0 < n; k0 += FILLMANY_CHUNK) {
+        const size_t nk = std::min(FILLMANY_CHUNK, n - k0);
+        binIndicesAt(nk, xs+k0, ibins);
+        for (size_t j = 0; j < nk; ++j) {
+          const size_t k = k0 + j;
+          const AutoFill f{xs[k], 0, weights ? weights[k] : 1.0, fractions ? fractions[k] : 1.0};
+          if (std::isnan(f.x)) {
+            if (_nanPolicy == FILL_THROW) {
+              if (filled) _locked = true;
+              throw RangeError("X is NaN");
+            }
+            _fillNaN(f.weight, f.fraction);
+            continue;
+          }
+          if (ibins[j] < 0 && f.x >= xmin && f.x < xmax) {
+            if (filled) _locked = true;
+            _fillGap(f.x, f.weight, f.fraction);
+          }
+          _fillDbn(_dbn, f);
+          filled = true;
+          if (ibins[j] >= 0) {
+            _fillBin(ibins[j], f.x, 0, f.weight, f.fraction);
+          } else if (f.x < xmin) {
+            _fillDbn(_underflow, f);
+          } else if (f.x >= xmax) {
+            _fillDbn(_overflow, f);
+          }
+        }
+      }
+
+      // Lock the axis if any entry was filled, as the scalar fill would have
+      if (filled) _locked = true;
+    }
+
+
+    /// @name NaN and bin-gap fill handling
+    /// @{
+
+    /// Policy for fills with a NaN coordinate
+    FillPolicy nanPolicy() const { return _nanPolicy; }
+    /// Set the policy for fills with a NaN coordinate
+    void setNanPolicy(FillPolicy policy) { _nanPolicy = policy; }
+
+    /// Policy for in-range fills which fall into a gap between bins
+    FillPolicy gapPolicy() const { return _gapPolicy; }
+    /// Set the policy for in-range fills which fall into a gap between bins
+    void setGapPolicy(FillPolicy policy) { _gapPolicy = policy; }
+
+    /// Weights of the NaN fills recorded under the FILL_COUNT policy
+    const Dbn0D& nanDbn() const { return _nanDbn; }
+
+    /// Weights of the bin-gap fills recorded under the FILL_COUNT policy
+    const Dbn0D& gapDbn() const { return _gapDbn; }
+
+    /// @brief Record a fill with a NaN coordinate
+    ///
+    /// @note The FILL_THROW policy is left to the caller, which knows which coordinate was NaN
+    void _fillNaN(double weight, double fraction) {
+      if (_nanPolicy == FILL_COUNT) _nanDbn.fill(weight, fraction);
+    }
+
+    /// Record an in-range fill at @a x which has no bin
+    void _fillGap(double x, double weight, double fraction) {
+      if (_gapPolicy == FILL_COUNT) {
+        _gapDbn.fill(weight, fraction);
+      } else if (_gapPolicy == FILL_THROW) {
+        std::stringstream ss;
+        ss << "Fill at x = " << x << " falls into a bin gap";
+        throw RangeError(ss.str());
+      }
+    }
+
+    /// @}
+
+
+    /// @name Auto-binning
+    /// @{
+
+    /// Whether the bins of an auto-binned axis are still to be chosen
+    bool autoBinPending() const { return _autoNumBins > 0; }
+
+    /// @brief Queue a fill of an auto-binned axis, choosing the bins when the queue is full
+    ///
+    /// The @a y coordinate is ignored for 1D distributions. NaN fills are not queued.
+    void _bufferFill(double x, double y, double weight, double fraction) {
+      _autoBuffer.push_back(AutoFill{x, y, weight, fraction});
+      if (_autoBuffer.size() >= _autoBufferSize) autoBook();
+    }
+
+    /// @brief Choose the bins of an auto-binned axis from the fills so far, and replay them
+    ///
+    /// This happens automatically when the queue is full, and otherwise must
+    /// be called explicitly, e.g. before writing out. Until then the axis has
+    /// no bins, and its reads see the unbooked state, with the queued fills in
+    /// none of the distributions. The axis is locked afterwards.
+    void autoBook() {
+      if (!autoBinPending()) return;
+      std::vector<AutoFill> fills;
+      fills.swap(_autoBuffer);
+      std::vector<double> xs;
+      xs.reserve(fills.size());
+      for (const AutoFill& f : fills) xs.push_back(f.x);
+      const std::vector<double> edges = autospace(_autoNumBins, xs, _autoMode);
+      _autoNumBins = 0;
+      addBins(edges);
+
+      // Replay the queued fills in their original order
+      const double xmin = edges.front(), xmax = edges.back();
+      for (const AutoFill& f : fills) {
+        const ssize_t i = binIndexAt(f.x);
+        if (i < 0 && f.x >= xmin && f.x < xmax) _fillGap(f.x, f.weight, f.fraction);
+        _fillDbn(_dbn, f);
+        if (i >= 0) {
+          _fillBin(i, f.x, f.y, f.weight, f.fraction);
+        } else if (f.x < xmin) {
+          _fillDbn(_underflow, f);
+        } else if (f.x >= xmax) {
+          _fillDbn(_overflow, f);
+        }
+      }
+      _locked = true;
+    }
+
     /// @}
 
 
@@ -215,7 +505,12 @@ namespace YODA {
       _dbn.reset();
       _underflow.reset();
       _overflow.reset();
+      _nanDbn.reset();
+      _gapDbn.reset();
       for (Bin& bin : _bins) bin.reset();
+      _cols.reset();
+      _dirtyBins.clear();
+      _autoBuffer.clear();
       _locked = false;
     }
 
@@ -313,7 +608,7 @@ namespace YODA {
     void rebinTo(const std::vector<double>& newedges) {
       if (newedges.size() < 2)
         throw UserError("Requested rebinning to an edge list which defines no bins");
-      const Utils::BinSearcher newbs(newedges);
+      const Utils::BinSearcher newbs(newedges, Utils::EST_LIN);
       const std::vector<double> eshared = newbs.shared_edges(_binsearcher);
       if (eshared.size() != newbs.size())
         throw BinningError("Requested rebinning to incompatible edges");
@@ -458,7 +753,15 @@ namespace YODA {
       _dbn.scaleW(scalefactor);
       _underflow.scaleW(scalefactor);
       _overflow.scaleW(scalefactor);
-      for (size_t i = 0; i < _bins.size(); ++i) _bins[i].scaleW(scalefactor);
+      _nanDbn.scaleW(scalefactor);
+      _gapDbn.scaleW(scalefactor);
+      if (_columnar) {
+        _syncCols();
+        _cols.scaleW(scalefactor);
+        _cols.copyTo(_bins);
+      } else {
+        for (size_t i = 0; i < _bins.size(); ++i) _bins[i].scaleW(scalefactor);
+      }
     }
 
     /// @}
@@ -502,13 +805,22 @@ namespace YODA {
     Axis1D<BIN1D,DBN>& operator += (const Axis1D<BIN1D,DBN>& toAdd) {
       if (*this != toAdd) throw LogicError("YODA::Histo1D: Cannot add axes with different binnings.");
 
-      for (size_t i = 0; i < _bins.size(); ++i) {
-        _bins[i] += toAdd.bins().at(i);
+      if (_columnar) {
+        _syncCols();
+        if (toAdd._columnar && toAdd._colsCurrent()) _cols += toAdd._cols;
+        else _cols += DbnColumns<DBN>(toAdd.bins());
+        _cols.copyTo(_bins);
+      } else {
+        for (size_t i = 0; i < _bins.size(); ++i) {
+          _bins[i] += toAdd.bins().at(i);
+        }
       }
 
       _dbn += toAdd._dbn;
       _underflow += toAdd._underflow;
       _overflow += toAdd._overflow;
+      _nanDbn += toAdd._nanDbn;
+      _gapDbn += toAdd._gapDbn;
       return *this;
     }
 
@@ -517,13 +829,22 @@ namespace YODA {
     Axis1D<BIN1D,DBN>& operator -= (const Axis1D<BIN1D,DBN>& toSubtract) {
       if (*this != toSubtract) throw LogicError("YODA::Histo1D: Cannot add axes with different binnings.");
 
-      for (size_t i = 0; i < _bins.size(); ++i) {
-        _bins[i] -= toSubtract.bins().at(i);
+      if (_columnar) {
+        _syncCols();
+        if (toSubtract._columnar && toSubtract._colsCurrent()) _cols -= toSubtract._cols;
+        else _cols -= DbnColumns<DBN>(toSubtract.bins());
+        _cols.copyTo(_bins);
+      } else {
+        for (size_t i = 0; i < _bins.size(); ++i) {
+          _bins[i] -= toSubtract.bins().at(i);
+        }
       }
 
       _dbn -= toSubtract._dbn;
       _underflow -= toSubtract._underflow;
       _overflow -= toSubtract._overflow;
+      _nanDbn -= toSubtract._nanDbn;
+      _gapDbn -= toSubtract._gapDbn;
       return *this;
     }
 
@@ -532,21 +853,50 @@ namespace YODA {
 
   private:
 
+    /// A fill queued before auto-binning, with y unused for 1D distributions
+    struct AutoFill {
+      double x, y, weight, fraction;
+    };
+
+    /// Fill a distribution from a queued fill, at the coordinates its type records
+    static void _fillDbn(DBN& d, const AutoFill& f) {
+      DbnMoments<DBN>::fill(d, f.x, f.y, 0, f.weight, f.fraction);
+    }
+
+    /// Whether the columnar form matches the bins vector
+    bool _colsCurrent() const {
+      return !_colsStale && _dirtyBins.empty();
+    }
+
+    /// Re-read the bins changed through non-const access into the columnar form
+    void _syncCols() {
+      if (_colsStale) {
+        _cols.assign(_bins);
+        _colsStale = false;
+      } else {
+        for (size_t i : _dirtyBins) _cols.set(i, _bins[i].dbn());
+      }
+      _dirtyBins.clear();
+    }
+
+
     /// Sort the given bins vector, and regenerate the bin searcher
     //
     /// The bin searcher is purely for searching, and is generated from
     /// the bins list only.
     void _updateAxis(Bins& bins) {
-      // Ensure that axis is not locked
-      if (_locked) {
+      // Ensure that axis is not locked, and that any auto-binning has been chosen
+      if (_locked || autoBinPending()) {
         throw LockError("Attempting to update a locked 1D axis");
       }
 
       // Get the new cuts and indexes (throws if overlaps), and set them on the searcher
       const std::pair< std::vector<double>, std::vector<long> > es_is = _mk_edges_indexes(bins);
-      _binsearcher = Utils::BinSearcher(es_is.first);
+      _binsearcher = Utils::BinSearcher(es_is.first, _binsearcher);
       _indexes = es_is.second;
       _bins = bins;
+      _colsStale = true;
+      _dirtyBins.clear();
     }
 
 
@@ -577,12 +927,26 @@ namespace YODA {
     /// Bins vector
     Bins _bins;
 
+    /// Columnar form of the bin contents, if enabled
+    bool _columnar = false;
+    DbnColumns<DBN> _cols;
+
+    /// Whether the columnar form is out of date as a whole, or for the listed bins
+    bool _colsStale = true;
+    std::vector<size_t> _dirtyBins;
+
     /// Total distribution
     DBN _dbn;
 
     /// Under- and overflows
     DBN _underflow, _overflow;
 
+    /// Records of NaN and bin-gap fills
+    Dbn0D _nanDbn, _gapDbn;
+
+    /// Treatment of NaN and bin-gap fills
+    FillPolicy _nanPolicy = FILL_THROW, _gapPolicy = FILL_IGNORE;
+
     // Binsearcher, for searching bins
     Utils::BinSearcher _binsearcher;
 
@@ -592,6 +956,14 @@ namespace YODA {
     /// Whether modifying bin edges is permitted
     bool _locked;
 
+    /// Auto-binning settings, with no bins left to choose once booked
+    size_t _autoNumBins = 0;
+    AutoBinning _autoMode = AUTOBIN_LIN;
+    size_t _autoBufferSize = 0;
+
+    /// Fills queued until the auto-binning is chosen
+    std::vector<AutoFill> _autoBuffer;
+
     /// @}
 
   };
@@ -4,6 +4,11 @@
 #include "YODA/AnalysisObject.h"
 #include "YODA/Exceptions.h"
 #include "YODA/Bin.h"
+#include "YODA/Dbn0D.h"
+#include "YODA/Dbn2D.h"
+#include "YODA/Dbn3D.h"
+#include "YODA/DbnColumns.h"
+#include "YODA/Fillable.h"
 #include "YODA/Utils/MathUtils.h"
 #include "YODA/Utils/Predicates.h"
 #include "YODA/Utils/BinSearcher.h"
@@ -13,10 +18,25 @@
 namespace YODA {
 
 
+  /// Ratio of sub-bin grid cells to bins above which Axis2D uses a sparse bin index
+  const size_t AXIS2D_SPARSE_RATIO = 16;
+
+  /// Default number of fills queued by Axis2D::setFillBuffer
+  const size_t FILLBUFFER_SIZE = 65536;
+
+
   /// @brief 2D bin container
   ///
   /// This class handles most of the low-level operations on an axis of bins
   /// arranged in a 2D grid (including gaps).
+  ///
+  /// Bins are located via a dense index over the grid of all distinct x and y
+  /// edges. Irregular binnings whose grid has more than AXIS2D_SPARSE_RATIO
+  /// cells per bin, e.g. staggered bins, instead use per-row lists of bin runs
+  /// along the other axis, which need memory proportional to the number of bins.
+  ///
+  /// The bin contents may also be held in columnar form, as a DbnColumns, for
+  /// faster whole-axis operations: see setColumnar.
   template <typename BIN2D, typename DBN>
   class Axis2D {
   public:
@@ -94,9 +114,14 @@ namespace YODA {
 
 
     void reset() {
+      _fillBuffer.clear();
       _dbn.reset();
+      _nanDbn.reset();
+      _gapDbn.reset();
       _outflows.assign(8, Outflow());
       for (Bin& bin : _bins) bin.reset();
+      _cols.reset();
+      _dirtyBins.clear();
       _locked = false;
     }
 
@@ -132,6 +157,7 @@ namespace YODA {
     /// x-edge and less than the lowest y-edge.
     ///
     Outflow& outflow(int ix, int iy) {
+      flushFills();
       return _outflows[_outflowIndex(ix, iy)];
     }
 
@@ -142,6 +168,7 @@ namespace YODA {
     /// x-edge and less than the lowest y-edge.
     ///
     const Outflow& outflow(int ix, int iy) const {
+      _checkFlushed();
       return _outflows[_outflowIndex(ix, iy)];
     }
 
@@ -158,6 +185,7 @@ namespace YODA {
     /// Scale each bin as if the entire x and y-axes had been scaled by
     /// their respective factors.
     void scaleXY(double sx, double sy) {
+      flushFills();
       _dbn.scaleXY(sx, sy);
       for (Outflow& outflow : _outflows)
         for (DBN& dbn : outflow)
@@ -171,13 +199,21 @@ namespace YODA {
     /// Rescale as if all fill weights had been different by factor @a
     /// scalefactor.
     void scaleW(double scalefactor) {
+      flushFills();
       _dbn.scaleW(scalefactor);
+      _nanDbn.scaleW(scalefactor);
+      _gapDbn.scaleW(scalefactor);
       for (Outflow& outflow : _outflows)
         for (DBN& dbn : outflow)
           dbn.scaleW(scalefactor);
-      for (Bin& bin : _bins)
-        bin.scaleW(scalefactor);
-      _updateAxis(_bins);
+      if (_columnar) {
+        _syncCols();
+        _cols.scaleW(scalefactor);
+        _cols.copyTo(_bins);
+      } else {
+        for (Bin& bin : _bins)
+          bin.scaleW(scalefactor);
+      }
     }
 
 
@@ -189,6 +225,7 @@ namespace YODA {
         throw RangeError("Bin index is out of range");
 
       // Temporarily unlock the axis during the update
+      flushFills();
       _bins.erase(_bins.begin() + i);
       _updateAxis(_bins);
     }
@@ -226,6 +263,13 @@ namespace YODA {
       /// @todo Beware the specialisation problems with vector<bool>...
       std::vector<bool> deleteMask(numBins(), false);
 
+      // The sparse index has no sub-bins to scan, but then there are few bins per sub-bin
+      if (_sparse) {
+        for (size_t i = 0; i < numBins(); ++i) deleteMask[i] = bin(i).fitsInside(xrange, yrange);
+        eraseBins(deleteMask);
+        return;
+      }
+
       for (size_t yi = yiLow; yi < yiHigh; yi++) {
         for (size_t xi = xiLow; xi < xiHigh; xi++) {
           ssize_t i = _indexes[_index(_nx, xi, yi)];
@@ -244,8 +288,8 @@ namespace YODA {
     void eraseBins(const std::vector<bool>& deleteMask) {
       Bins newBins;
       for (size_t i = 0; i < numBins(); i++)
-        if (!deleteMask[i]) newBins.push_back(bins(i));
-      _update(newBins);
+        if (!deleteMask[i]) newBins.push_back(bin(i));
+      _updateAxis(newBins);
     }
 
 
@@ -404,16 +448,37 @@ namespace YODA {
 
     /// Access bin by index
     Bin& bin(size_t i) {
+      flushFills();
+      if (_columnar) _dirtyBins.push_back(i);
       return _bins[i];
     }
 
     /// Access bin by index (const)
     const Bin& bin(size_t i) const {
+      _checkFlushed();
       return _bins[i];
     }
 
+    /// @brief Midpoint of the bin at a given index
+    ///
+    /// Only the edges are read, so queued fills are left as they are.
+    std::pair<double, double> binMid(size_t i) const {
+      return _bins[i].xyMid();
+    }
+
     /// Get the bin index of the bin containing point (x, y).
     int binIndexAt(double x, double y) const {
+      // Full regular grids compute the global index directly from the 1D indices
+      if (_regularGrid) {
+        if (!inRange(x, _xRange) || !inRange(y, _yRange)) return -1;
+        return (_binSearcherX.index(x) - 1) * (_ny - 1) + (_binSearcherY.index(y) - 1);
+      }
+
+      if (_sparse) {
+        if (!inRange(x, _xRange) || !inRange(y, _yRange)) return -1;
+        return _sparseMajorY ? _sparseIndex(_binSearcherY.index(y) - 1, x) : _sparseIndex(_binSearcherX.index(x) - 1, y);
+      }
+
       size_t xi = _binSearcherX.index(x) - 1;
       size_t yi = _binSearcherY.index(y) - 1;
       if (xi > _nx) return -1;
@@ -422,6 +487,34 @@ namespace YODA {
       return _indexes[_index(_nx, xi, yi)];
     }
 
+    /// @brief Look up the bin indices of @a n (x, y) points in one pass
+    ///
+    /// Each entry of @a out is set as for binIndexAt, i.e. -1 if no bin matches.
+    /// The x and y searches of irregular binnings are batched via BinSearcher::indices.
+    void binIndicesAt(size_t n, const double* xs, const double* ys, ssize_t* out) const {
+      // Full regular grids are cheaper point by point, with no searches to batch
+      if (_regularGrid) {
+        for (size_t k = 0; k < n; ++k) out[k] = binIndexAt(xs[k], ys[k]);
+        return;
+      }
+      size_t ixs[FILLMANY_CHUNK], iys[FILLMANY_CHUNK];
+      for (size_t k0 = 0; k0 < n; k0 += FILLMANY_CHUNK) {
+        const size_t nk = std::min(FILLMANY_CHUNK, n - k0);
+        // The sparse index needs only the row searches
+        if (!_sparse || !_sparseMajorY) _binSearcherX.indices(xs+k0, nk, ixs);
+        if (!_sparse || _sparseMajorY) _binSearcherY.indices(ys+k0, nk, iys);
+        for (size_t k = 0; k < nk; ++k) {
+          if (!inRange(xs[k0+k], _xRange) || !inRange(ys[k0+k], _yRange)) {
+            out[k0+k] = -1;
+          } else if (_sparse) {
+            out[k0+k] = _sparseMajorY ? _sparseIndex(iys[k] - 1, xs[k0+k]) : _sparseIndex(ixs[k] - 1, ys[k0+k]);
+          } else {
+            out[k0+k] = _indexes[_index(_nx, ixs[k] - 1, iys[k] - 1)];
+          }
+        }
+      }
+    }
+
     /// Get the bin containing point (x, y).
     Bin& binAt(double x, double y) {
       const int ret = binIndexAt(x, y);
@@ -439,25 +532,325 @@ namespace YODA {
 
     /// Return the total distribution (non-const)
     DBN& totalDbn() {
+      flushFills();
       return _dbn;
     }
     /// Return the total distribution (const)
     const DBN& totalDbn() const {
+      _checkFlushed();
       return _dbn;
     }
     /// Set the total distribution: CAREFUL!
     void setTotalDbn(const DBN& dbn) {
+      flushFills();
       _dbn = dbn;
     }
 
+    /// Sum of the bin distributions, i.e. the total without the outflows and bin-gap fills
+    DBN binTotalDbn() const {
+      _checkFlushed();
+      if (_columnar && _colsCurrent()) return _cols.total();
+      DBN rtn;
+      for (const Bin& b : _bins) rtn += b.dbn();
+      return rtn;
+    }
+
+
+    /// @name Columnar storage
+    /// @{
+
+    /// @brief Hold the bin contents as one array per running sum, or as the bins vector
+    ///
+    /// As for Axis1D::setColumnar, fills and the whole-axis operations scaleW,
+    /// +=, -=, reset and binTotalDbn then work on the arrays, and write the
+    /// bins they change straight back, so the bins vector is always current.
+    /// A flush of buffered fills writes back each filled bin once.
+    void setColumnar(bool columnar=true) {
+      flushFills();
+      _columnar = columnar;
+      _colsStale = true;
+      _dirtyBins.clear();
+      if (columnar) _syncCols();
+      else _cols.clear();
+    }
+
+    /// Whether the bin contents are held in columnar form
+    bool columnar() const { return _columnar; }
+
+    /// @brief Fill bin @a i
+    ///
+    /// The @a z coordinate is ignored for 2D distributions.
+    void _fillBin(size_t i, double x, double y, double z, double weight, double fraction) {
+      if (_columnar) {
+        _syncCols();
+        _cols.fill(i, x, y, z, weight, fraction);
+        _bins[i].dbn() = _cols.dbn(i);
+      } else {
+        _fillDbn(_bins[i].dbn(), BufferedFill{x, y, z, weight, fraction});
+      }
+    }
+
+    /// @brief Fill a histogram axis with weight @a weight at (@a x, @a y)
+    ///
+    /// This is the fill of Histo2D and CountHisto2D, whose distribution types
+    /// differ only in the moments recorded, so is not for profile axes.
+    void _fillHisto(double x, double y, double weight, double fraction) {
+      if ( std::isnan(x) || std::isnan(y) ) {
+        if (_nanPolicy == FILL_THROW) throw RangeError(std::isnan(x) ? "X is NaN" : "Y is NaN");
+        _fillNaN(weight, fraction);
+        return;
+      }
+
+      // Queue the fill if buffering, leaving the bin lookup to the flush
+      if (fillBufferSize() > 0) {
+        _bufferFill(x, y, 0, weight, fraction);
+        _locked = true;
+        return;
+      }
+
+      // Find the bin, applying the gap policy before anything is filled
+      const bool inrange = inRange(x, xMin(), xMax()) && inRange(y, yMin(), yMax());
+      const int i = inrange ? binIndexAt(x, y) : -1;
+      if (inrange && i < 0) _fillGap(x, y, weight, fraction);
+
+      // Fill the overall distribution
+      _fillDbn(_dbn, BufferedFill{x, y, 0, weight, fraction});
+
+      // Fill the bins and overflows
+      /// Unify this with Profile2D's version, when binning and inheritance are reworked
+      if (i >= 0) _fillBin(i, x, y, 0, weight, fraction);
+      /// @todo Reinstate! With outflow axis bin lookup
+      // else {
+      //   size_t ix(0), iy(0);
+      //   if (x <  xMin()) ix = -1; else if (x >= xMax()) ix = 1;
+      //   if (y <  yMin()) iy = -1; else if (y >= yMax()) iy = 1;
+      //   outflow(ix, iy).fill(x, y, weight, fraction);
+      // }
+
+      // Lock the axis now that a fill has happened
+      _locked = true;
+    }
+
+    /// @brief Fill the axis at @a n points (@a xs, @a ys), as by scalar fills at each in turn
+    ///
+    /// This is the batched fill of the histograms and profiles, with null @a zs
+    /// for histograms, whose distributions do not record z. Null @a weights or
+    /// @a fractions mean all 1. If fills are buffered, each is queued as a
+    /// scalar fill would be, so that the bins see the same fill order.
+    void _fillMany(size_t n, const double* xs, const double* ys, const double* zs,
+                   const double* weights, const double* fractions) {
+      // Look up the bin indices a chunk at a time, then accumulate in fill order
+      // so that every Dbn sees the same sequence as with scalar fills
+      const bool buffered = fillBufferSize() > 0;
+      bool filled = false;
+      ssize_t ibins[FILLMANY_CHUNK];
+      for (size_t k0 = 0; k0 < n; k0 += FILLMANY_CHUNK) {
+        const size_t nk = std::min(FILLMANY_CHUNK, n - k0);
+        if (!buffered) binIndicesAt(nk, xs+k0, ys+k0, ibins);
+        for (size_t j = 0; j < nk; ++j) {
+          const size_t k = k0 + j;
+          const BufferedFill f{xs[k], ys[k], zs ? zs[k] : 0, weights ? weights[k] : 1.0, fractions ? fractions[k] : 1.0};
+          if (std::isnan(f.x) || std::isnan(f.y) || std::isnan(f.z)) {
+            if (_nanPolicy == FILL_THROW) {
+              if (filled) _locked = true;
+              throw RangeError(std::isnan(f.x) ? "X is NaN" : std::isnan(f.y) ? "Y is NaN" : "Z is NaN");
+            }
+            _fillNaN(f.weight, f.fraction);
+            continue;
+          }
+          if (buffered) {
+            try {
+              _bufferFill(f.x, f.y, f.z, f.weight, f.fraction);
+            } catch (const RangeError&) {
+              if (filled) _locked = true;
+              throw;
+            }
+            filled = true;
+            continue;
+          }
+          if (ibins[j] < 0 && inRange(f.x, xMin(), xMax()) && inRange(f.y, yMin(), yMax())) {
+            if (filled) _locked = true;
+            _fillGap(f.x, f.y, f.weight, f.fraction);
+          }
+          _fillDbn(_dbn, f);
+          filled = true;
+          /// @todo Fill the outflows, as and when the scalar fill does
+          if (ibins[j] >= 0) _fillBin(ibins[j], f.x, f.y, f.z, f.weight, f.fraction);
+        }
+      }
+
+      // Lock the axis if any entry was filled, as the scalar fill would have
+      if (filled) _locked = true;
+    }
+
+    /// @}
+
+
+    /// @name NaN and bin-gap fill handling
+    /// @{
+
+    /// Policy for fills with a NaN coordinate
+    FillPolicy nanPolicy() const { return _nanPolicy; }
+    /// Set the policy for fills with a NaN coordinate
+    void setNanPolicy(FillPolicy policy) { _nanPolicy = policy; }
+
+    /// Policy for in-range fills which fall into a gap between bins
+    FillPolicy gapPolicy() const { return _gapPolicy; }
+    /// Set the policy for in-range fills which fall into a gap between bins
+    ///
+    /// Queued fills are flushed first, so that each fill sees the policy in force when it was made.
+    void setGapPolicy(FillPolicy policy) { flushFills(); _gapPolicy = policy; }
+
+    /// Weights of the NaN fills recorded under the FILL_COUNT policy
+    const Dbn0D& nanDbn() const { return _nanDbn; }
+
+    /// Weights of the bin-gap fills recorded under the FILL_COUNT policy
+    const Dbn0D& gapDbn() const { _checkFlushed(); return _gapDbn; }
+
+    /// @brief Record a fill with a NaN coordinate
+    ///
+    /// @note The FILL_THROW policy is left to the caller, which knows which coordinate was NaN
+    void _fillNaN(double weight, double fraction) {
+      if (_nanPolicy == FILL_COUNT) _nanDbn.fill(weight, fraction);
+    }
+
+    /// Record an in-range fill at (@a x, @a y) which has no bin
+    void _fillGap(double x, double y, double weight, double fraction) {
+      if (_gapPolicy == FILL_COUNT) {
+        _gapDbn.fill(weight, fraction);
+      } else if (_gapPolicy == FILL_THROW) {
+        std::stringstream ss;
+        ss << "Fill at (x, y) = (" << x << ", " << y << ") falls into a bin gap";
+        throw RangeError(ss.str());
+      }
+    }
+
+    /// @}
+
+
+    /// @name Buffered filling
+    /// @{
+
+    /// @brief Queue up to @a n fills, and accumulate them into the bins in bin order
+    ///
+    /// With many bins, fills in random bin order miss the cache. Queued fills are
+    /// looked up in bulk and accumulated with each bin's fills in their original
+    /// order, so the results are identical to direct filling. The queue is flushed
+    /// when full, by flushFills(), and by every non-const accessor and modifier.
+    /// Const reads never modify the axis: they throw a UserError while fills are
+    /// queued, so call flushFills() before reading or writing out a buffered axis
+    /// through a const reference. A size of 0 turns buffering off.
+    ///
+    /// @note Fills into bin gaps under FILL_THROW are found by the flush, which
+    /// accumulates all the other queued fills and then throws the RangeError of
+    /// the first refused one.
+    void setFillBuffer(size_t n=FILLBUFFER_SIZE) {
+      flushFills();
+      _fillBufferSize = n;
+      if (n == 0) std::vector<BufferedFill>().swap(_fillBuffer);
+    }
+
+    /// Maximum number of queued fills, or 0 if fills are not buffered
+    size_t fillBufferSize() const { return _fillBufferSize; }
+
+    /// @brief Queue a fill, flushing if the buffer is full
+    ///
+    /// The @a z coordinate is ignored for 2D distributions.
+    void _bufferFill(double x, double y, double z, double weight, double fraction) {
+      _fillBuffer.push_back(BufferedFill{x, y, z, weight, fraction});
+      if (_fillBuffer.size() >= _fillBufferSize) flushFills();
+    }
+
+    /// @brief Accumulate all queued fills
+    ///
+    /// Throws the RangeError of the first fill into a bin gap under FILL_THROW,
+    /// after accumulating the others.
+    void flushFills() {
+      if (_fillBuffer.empty()) return;
+      std::vector<BufferedFill> fills;
+      fills.swap(_fillBuffer);
+      const size_t n = fills.size();
+
+      // Look up all bin indices, and fill the total distribution in the original order
+      std::vector<ssize_t> ibins(n);
+      double xs[FILLMANY_CHUNK], ys[FILLMANY_CHUNK];
+      for (size_t k0 = 0; k0 < n; k0 += FILLMANY_CHUNK) {
+        const size_t nk = std::min(FILLMANY_CHUNK, n - k0);
+        for (size_t k = 0; k < nk; ++k) {
+          xs[k] = fills[k0+k].x;
+          ys[k] = fills[k0+k].y;
+        }
+        binIndicesAt(nk, xs, ys, ibins.data() + k0);
+      }
+
+      // Refuse the in-range fills into bin gaps under FILL_THROW, as direct fills would
+      std::vector<bool> refused;
+      size_t firstRefused = n;
+      if (_gapPolicy == FILL_THROW) {
+        refused.assign(n, false);
+        for (size_t k = 0; k < n; ++k) {
+          const BufferedFill& f = fills[k];
+          if (ibins[k] < 0 && inRange(f.x, _xRange) && inRange(f.y, _yRange)) {
+            refused[k] = true;
+            if (firstRefused == n) firstRefused = k;
+          }
+        }
+      }
+      for (size_t k = 0; k < n; ++k) {
+        if (firstRefused == n || !refused[k]) _fillDbn(_dbn, fills[k]);
+      }
+
+      // Order the fills by bin, keeping their order within each bin, then accumulate
+      std::vector<size_t> order;
+      order.reserve(n);
+      if (_bins.size() <= 4*n) {
+        std::vector<size_t> starts(_bins.size()+1, 0);
+        for (size_t k = 0; k < n; ++k) if (ibins[k] >= 0) ++starts[ibins[k]+1];
+        for (size_t i = 0; i < _bins.size(); ++i) starts[i+1] += starts[i];
+        order.resize(starts.back());
+        for (size_t k = 0; k < n; ++k) if (ibins[k] >= 0) order[starts[ibins[k]]++] = k;
+      } else {
+        for (size_t k = 0; k < n; ++k) if (ibins[k] >= 0) order.push_back(k);
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return ibins[a] < ibins[b]; });
+      }
+      if (_columnar) {
+        _syncCols();
+        for (size_t j = 0; j < order.size(); ++j) {
+          const BufferedFill& f = fills[order[j]];
+          const size_t i = ibins[order[j]];
+          _cols.fill(i, f.x, f.y, f.z, f.weight, f.fraction);
+          if (j+1 == order.size() || (size_t) ibins[order[j+1]] != i) _bins[i].dbn() = _cols.dbn(i);
+        }
+      } else {
+        for (size_t k : order) _fillDbn(_bins[ibins[k]].dbn(), fills[k]);
+      }
+
+      // Record the gap fills, or report the first refused one
+      if (_gapPolicy == FILL_COUNT) {
+        for (size_t k = 0; k < n; ++k) {
+          const BufferedFill& f = fills[k];
+          if (ibins[k] < 0 && inRange(f.x, _xRange) && inRange(f.y, _yRange)) _gapDbn.fill(f.weight, f.fraction);
+        }
+      }
+      if (firstRefused < n) {
+        const BufferedFill& f = fills[firstRefused];
+        _fillGap(f.x, f.y, f.weight, f.fraction);
+      }
+    }
+
+    /// @}
+
 
     /// Return the bins vector (non-const)
     Bins& bins() {
+      flushFills();
+      _colsStale = true;
       return _bins;
     }
 
     /// Return the bins vector (const)
     const Bins& bins() const {
+      _checkFlushed();
       return _bins;
     }
 
@@ -469,11 +862,12 @@ namespace YODA {
     // similar method?)
     bool operator == (const Axis2D& other) const {
       if (numBins() != other.numBins()) return false;
+      // The edges are always up to date, whatever the form of the bin contents
       for (size_t i = 0; i < numBins(); i++)
-        if (!(fuzzyEquals(bin(i).xMin(), other.bin(i).xMin()) &&
-              fuzzyEquals(bin(i).xMax(), other.bin(i).xMax()) &&
-              fuzzyEquals(bin(i).yMin(), other.bin(i).yMin()) &&
-              fuzzyEquals(bin(i).yMax(), other.bin(i).yMax())))
+        if (!(fuzzyEquals(_bins[i].xMin(), other._bins[i].xMin()) &&
+              fuzzyEquals(_bins[i].xMax(), other._bins[i].xMax()) &&
+              fuzzyEquals(_bins[i].yMin(), other._bins[i].yMin()) &&
+              fuzzyEquals(_bins[i].yMax(), other._bins[i].yMax())))
           return false;
       return true;
     }
@@ -489,10 +883,25 @@ namespace YODA {
       if (*this != toAdd) {
         throw LogicError("YODA::Axis2D: Cannot add axes with different binnings.");
       }
-      for (size_t i = 0; i < bins().size(); ++i) {
-        bin(i) += toAdd.bin(i);
+      flushFills();
+      if (!toAdd._fillBuffer.empty()) {
+        Axis2D<BIN2D, DBN> flushed(toAdd);
+        flushed.flushFills();
+        return *this += flushed;
+      }
+      if (_columnar) {
+        _syncCols();
+        if (toAdd._columnar && toAdd._colsCurrent()) _cols += toAdd._cols;
+        else _cols += DbnColumns<DBN>(toAdd.bins());
+        _cols.copyTo(_bins);
+      } else {
+        for (size_t i = 0; i < bins().size(); ++i) {
+          bin(i) += toAdd.bin(i);
+        }
       }
       _dbn += toAdd._dbn;
+      _nanDbn += toAdd._nanDbn;
+      _gapDbn += toAdd._gapDbn;
       return *this;
     }
 
@@ -501,16 +910,65 @@ namespace YODA {
       if (*this != toSubtract) {
         throw LogicError("YODA::Axis2D: Cannot add axes with different binnings.");
       }
-      for (size_t i = 0; i < bins().size(); ++i) {
-        bin(i) -= toSubtract.bin(i);
+      flushFills();
+      if (!toSubtract._fillBuffer.empty()) {
+        Axis2D<BIN2D, DBN> flushed(toSubtract);
+        flushed.flushFills();
+        return *this -= flushed;
+      }
+      if (_columnar) {
+        _syncCols();
+        if (toSubtract._columnar && toSubtract._colsCurrent()) _cols -= toSubtract._cols;
+        else _cols -= DbnColumns<DBN>(toSubtract.bins());
+        _cols.copyTo(_bins);
+      } else {
+        for (size_t i = 0; i < bins().size(); ++i) {
+          bin(i) -= toSubtract.bin(i);
+        }
       }
       _dbn -= toSubtract._dbn;
+      _nanDbn -= toSubtract._nanDbn;
+      _gapDbn -= toSubtract._gapDbn;
       return *this;
     }
 
 
   private:
 
+    /// A queued fill, with z unused for 2D distributions
+    struct BufferedFill {
+      double x, y, z, weight, fraction;
+    };
+
+    /// Fill a distribution from a queued fill, at the coordinates its type records
+    static void _fillDbn(DBN& d, const BufferedFill& f) {
+      DbnMoments<DBN>::fill(d, f.x, f.y, f.z, f.weight, f.fraction);
+    }
+
+    /// Whether the columnar form matches the bins vector
+    bool _colsCurrent() const {
+      return !_colsStale && _dirtyBins.empty();
+    }
+
+    /// Re-read the bins changed through non-const access into the columnar form
+    void _syncCols() {
+      if (_colsStale) {
+        _cols.assign(_bins);
+        _colsStale = false;
+      } else {
+        for (size_t i : _dirtyBins) _cols.set(i, _bins[i].dbn());
+      }
+      _dirtyBins.clear();
+    }
+
+
+    /// Refuse a const read while fills are queued
+    void _checkFlushed() const {
+      if (!_fillBuffer.empty())
+        throw UserError("Attempting to read a 2D axis with queued fills: call flushFills() first");
+    }
+
+
     void _checkUnlocked(void) {
       // Ensure that axis is not locked
       if (_locked)
@@ -532,6 +990,8 @@ namespace YODA {
       if (bins.size() == 0) {
         _binSearcherX = Utils::BinSearcher();
         _binSearcherY = Utils::BinSearcher();
+        _regularGrid = false;
+        _sparse = false;
         _nx = 0;
         _ny = 0;
         _xRange = std::make_pair(0, 0);
@@ -574,39 +1034,92 @@ namespace YODA {
       //std::cout << "Unique Axis2D edge list sizes: nx = " << nx << ", ny = " << ny << std::endl;
       assert(bins.size() <= (nx-1)*(ny-1) && "Input bins vector size must agree with computed number of unique bins");
 
-      // Create a sea of indices, starting with an all-gaps configuration
-      std::vector<ssize_t> indexes(N, -1);
-
-      // Iterate through bins and find out which
-      Utils::BinSearcher xSearcher(xedges);
-      Utils::BinSearcher ySearcher(yedges);
+      // Find the sub-bin index ranges of each bin
+      Utils::BinSearcher xSearcher(xedges, _binSearcherX);
+      Utils::BinSearcher ySearcher(yedges, _binSearcherY);
+      std::vector<size_t> xiMins(bins.size()), xiMaxs(bins.size()), yiMins(bins.size()), yiMaxs(bins.size());
+      size_t nxspans = 0, nyspans = 0;
       for (size_t i = 0; i < bins.size(); ++i) {
-        Bin& bin = bins[i];
-
-        // std::cout << "Bin #" << i << " edges: "
-        //           << "[(" << bin.xMin() << "," << bin.xMax() << "), "
-        //           << "(" << bin.yMin() << "," << bin.yMax() << ")] " << std::endl;
-
-        const size_t xiMin= xSearcher.index(bin.xMin()) - 1;
-        const size_t xiMax= xSearcher.index(bin.xMax()) - 1;
-        const size_t yiMin = ySearcher.index(bin.yMin()) - 1;
-        const size_t yiMax = ySearcher.index(bin.yMax()) - 1;
-
-        // std::cout << "Sub-bin range indices: x = " << xiMin << ".." << xiMax << ", y = " << yiMin << ".." << yiMax << std::endl;
+        xiMins[i] = xSearcher.index(bins[i].xMin()) - 1;
+        xiMaxs[i] = xSearcher.index(bins[i].xMax()) - 1;
+        yiMins[i] = ySearcher.index(bins[i].yMin()) - 1;
+        yiMaxs[i] = ySearcher.index(bins[i].yMax()) - 1;
+        nxspans += xiMaxs[i] - xiMins[i];
+        nyspans += yiMaxs[i] - yiMins[i];
+      }
 
-        // Loop over sub-bins in the edge list and assign indices / detect overlaps
-        for (size_t xi = xiMin; xi < xiMax; xi++) {
-          for (size_t yi = yiMin; yi < yiMax; yi++) {
-            const size_t ii = _index(nx, xi, yi);
-            if (indexes[ii] != -1) {
+      // Grids much larger than the bin count are indexed by runs of bins along the
+      // rows or columns of sub-bins, whichever needs fewer runs
+      const bool sparse = (nx-1)*(ny-1) > AXIS2D_SPARSE_RATIO * bins.size();
+      const bool majorY = nyspans <= nxspans;
+      std::vector<ssize_t> indexes;
+      std::vector<size_t> sparseOffsets;
+      std::vector<double> sparseEdges;
+      std::vector<ssize_t> sparseBins;
+      if (sparse) {
+        const std::vector<size_t>& majMins = majorY ? yiMins : xiMins;
+        const std::vector<size_t>& majMaxs = majorY ? yiMaxs : xiMaxs;
+        const std::vector<size_t>& minMins = majorY ? xiMins : yiMins;
+        const std::vector<size_t>& minMaxs = majorY ? xiMaxs : yiMaxs;
+        const std::vector<double>& minEdges = majorY ? xedges : yedges;
+        const size_t nmaj = (majorY ? ny : nx) - 1;
+
+        // Bucket the bins by row, then tile each row with bin and gap runs in order
+        std::vector< std::vector<size_t> > rows(nmaj);
+        for (size_t i = 0; i < bins.size(); ++i) {
+          for (size_t r = majMins[i]; r < majMaxs[i]; ++r) rows[r].push_back(i);
+        }
+        for (size_t r = 0; r < nmaj; ++r) {
+          std::vector<size_t>& row = rows[r];
+          std::sort(row.begin(), row.end(), [&](size_t a, size_t b) { return minMins[a] < minMins[b]; });
+          sparseOffsets.push_back(sparseEdges.size());
+          size_t cursor = 0;
+          for (size_t k = 0; k < row.size(); ++k) {
+            const size_t i = row[k];
+            if (minMins[i] < cursor) {
+              const Bin& bin = bins[i];
               std::stringstream ss;
               ss << "Bin edges overlap! Bin #" << i << " with edges "
                  << "[(" << bin.xMin() << "," << bin.xMax() << "), "
                  << "(" << bin.yMin() << "," << bin.yMax() << ")] "
-                 << "overlaps bin #" << indexes[ii] << " in sub-bin #" << ii;
+                 << "overlaps bin #" << row[k-1] << " in sub-bin row #" << r;
               throw RangeError(ss.str());
             }
-            indexes[ii] = i;
+            if (minMins[i] > cursor) {
+              sparseEdges.push_back(minEdges[cursor]);
+              sparseBins.push_back(-1);
+            }
+            sparseEdges.push_back(minEdges[minMins[i]]);
+            sparseBins.push_back(i);
+            cursor = minMaxs[i];
+          }
+          if (cursor < minEdges.size()-1) {
+            sparseEdges.push_back(minEdges[cursor]);
+            sparseBins.push_back(-1);
+          }
+        }
+        sparseOffsets.push_back(sparseEdges.size());
+
+      } else {
+        // Create a sea of indices, starting with an all-gaps configuration
+        indexes.assign(N, -1);
+
+        // Loop over sub-bins in the edge list and assign indices / detect overlaps
+        for (size_t i = 0; i < bins.size(); ++i) {
+          for (size_t xi = xiMins[i]; xi < xiMaxs[i]; xi++) {
+            for (size_t yi = yiMins[i]; yi < yiMaxs[i]; yi++) {
+              const size_t ii = _index(nx, xi, yi);
+              if (indexes[ii] != -1) {
+                const Bin& bin = bins[i];
+                std::stringstream ss;
+                ss << "Bin edges overlap! Bin #" << i << " with edges "
+                   << "[(" << bin.xMin() << "," << bin.xMax() << "), "
+                   << "(" << bin.yMin() << "," << bin.yMax() << ")] "
+                   << "overlaps bin #" << indexes[ii] << " in sub-bin #" << ii;
+                throw RangeError(ss.str());
+              }
+              indexes[ii] = i;
+            }
           }
         }
       }
@@ -619,10 +1132,36 @@ namespace YODA {
       _yRange = std::make_pair(yedges.front(), yedges.back());
 
       _indexes = indexes;
+      _sparse = sparse;
+      _sparseMajorY = majorY;
+      _sparseOffsets = sparseOffsets;
+      _sparseEdges = sparseEdges;
+      _sparseBins = sparseBins;
       _bins = bins;
+      _colsStale = true;
+      _dirtyBins.clear();
 
       _binSearcherX = xSearcher;
       _binSearcherY = ySearcher;
+
+      // Check for a gapless grid with arithmetic edge lookups, where bins are ordered in x then y
+      _regularGrid = !sparse && xSearcher.regular() && ySearcher.regular() && bins.size() == (nx-1)*(ny-1);
+      for (size_t xi = 0; _regularGrid && xi < nx-1; ++xi) {
+        for (size_t yi = 0; yi < ny-1; ++yi) {
+          if (indexes[_index(nx, xi, yi)] != (ssize_t) (xi*(ny-1) + yi)) {
+            _regularGrid = false;
+            break;
+          }
+        }
+      }
+    }
+
+
+    /// Bin index in sub-bin row @a r of the sparse index, at in-range position @a v along the row
+    ssize_t _sparseIndex(size_t r, double v) const {
+      const double* first = _sparseEdges.data() + _sparseOffsets[r];
+      const double* last = _sparseEdges.data() + _sparseOffsets[r+1];
+      return _sparseBins[std::upper_bound(first, last, v) - _sparseEdges.data() - 1];
     }
 
 
@@ -655,12 +1194,26 @@ namespace YODA {
     /// Bins vector
     Bins _bins;
 
+    /// Columnar form of the bin contents, if enabled
+    bool _columnar = false;
+    DbnColumns<DBN> _cols;
+
+    /// Whether the columnar form is out of date as a whole, or for the listed bins
+    bool _colsStale = true;
+    std::vector<size_t> _dirtyBins;
+
     /// Total distribution
     DBN _dbn;
 
     // Outflows
     Outflows _outflows;
 
+    /// Records of NaN and bin-gap fills
+    Dbn0D _nanDbn, _gapDbn;
+
+    /// Treatment of NaN and bin-gap fills
+    FillPolicy _nanPolicy = FILL_THROW, _gapPolicy = FILL_IGNORE;
+
     // Binsearcher, for searching bins
     Utils::BinSearcher _binSearcherX, _binSearcherY;
 
@@ -669,12 +1222,28 @@ namespace YODA {
     // Mapping from bin-searcher indices to bin indices (allowing gaps)
     std::vector<ssize_t> _indexes;
 
+    // Whether the bins form a full regular grid, indexed without _indexes
+    bool _regularGrid = false;
+
+    // Whether bins are indexed by runs along sub-bin rows instead of _indexes,
+    // with the rows along y (runs along x) or along x (runs along y)
+    bool _sparse = false, _sparseMajorY = true;
+
+    // Sparse index: run start offsets per row (plus the end), and the run start edges and bin indices (-1 for gaps)
+    std::vector<size_t> _sparseOffsets;
+    std::vector<double> _sparseEdges;
+    std::vector<ssize_t> _sparseBins;
+
     // Numbers of edges on axes (necessary for bounds checking and indexing)
     size_t _nx, _ny;
 
     /// Whether modifying bin edges is permitted
     bool _locked;
 
+    /// Queued fills, and the number at which they are flushed (0 for no buffering)
+    std::vector<BufferedFill> _fillBuffer;
+    size_t _fillBufferSize = 0;
+
     /// @}
 
   };
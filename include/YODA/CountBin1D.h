@@ -0,0 +1,66 @@
+// -*- C++ -*-
+//
+// This file is part of YODA -- Yet more Objects for Data Analysis
+// Copyright (C) 2008-2021 The YODA collaboration (see AUTHORS for details)
+//
+#ifndef YODA_CountBin1D_h
+#define YODA_CountBin1D_h
+
+#include "YODA/HistoBin1D.h"
+#include "YODA/Dbn0D.h"
+
+namespace YODA {
+
+
+  /// @brief A histogram bin which accumulates only the counts of its fills
+  ///
+  /// Like HistoBin1D, but with a Dbn0D moment set, i.e. only the number of
+  /// entries, sum of weights and sum of squared weights: the fill positions
+  /// are not recorded. This saves memory and fill time for histograms which
+  /// are only used for their heights and height errors.
+  class CountBin1D : public HistoBin1DT<Dbn0D> {
+  public:
+
+    /// Make a new, empty bin with a pair of edges.
+    CountBin1D(double lowedge, double highedge)
+      : HistoBin1DT<Dbn0D>(lowedge, highedge)
+    { }
+
+    /// Make a new, empty bin with a pair of edges.
+    CountBin1D(const std::pair<double,double>& edges)
+      : HistoBin1DT<Dbn0D>(edges)
+    { }
+
+    /// @brief Make a bin with all the components of a fill history.
+    ///
+    /// Mainly intended for internal persistency use.
+    CountBin1D(std::pair<double, double> edges, const Dbn0D& dbn)
+      : HistoBin1DT<Dbn0D>(edges, dbn)
+    { }
+
+    /// Copy constructor, also from the bin template
+    CountBin1D(const HistoBin1DT<Dbn0D>& cb)
+      : HistoBin1DT<Dbn0D>(cb)
+    { }
+
+  };
+
+
+  /// Add two bins
+  inline CountBin1D operator + (const CountBin1D& a, const CountBin1D& b) {
+    CountBin1D rtn(a);
+    rtn += b;
+    return rtn;
+  }
+
+  /// Subtract two bins
+  inline CountBin1D operator - (const CountBin1D& a, const CountBin1D& b) {
+    CountBin1D rtn(a);
+    rtn -= b;
+    return rtn;
+  }
+
+
+}
+
+#endif
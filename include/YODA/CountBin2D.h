@@ -0,0 +1,68 @@
+// -*- C++ -*-
+//
+// This file is part of YODA -- Yet more Objects for Data Analysis
+// Copyright (C) 2008-2021 The YODA collaboration (see AUTHORS for details)
+//
+#ifndef YODA_CountBin2D_h
+#define YODA_CountBin2D_h
+
+#include "YODA/HistoBin2D.h"
+#include "YODA/Dbn0D.h"
+
+namespace YODA {
+
+
+  /// @brief A 2D histogram bin which accumulates only the counts of its fills
+  ///
+  /// Like HistoBin2D, but with a Dbn0D moment set, i.e. only the number of
+  /// entries, sum of weights and sum of squared weights: the fill positions
+  /// are not recorded.
+  class CountBin2D : public HistoBin2DT<Dbn0D> {
+  public:
+
+    /// Make a new, empty bin with two pairs of edges.
+    CountBin2D(double xmin, double xmax, double ymin, double ymax)
+      : HistoBin2DT<Dbn0D>(xmin, xmax, ymin, ymax)
+    { }
+
+    /// Constructor accepting a set of all edges of a bin
+    CountBin2D(const std::pair<double,double>& xedges,
+               const std::pair<double,double>& yedges)
+      : HistoBin2DT<Dbn0D>(xedges, yedges)
+    { }
+
+    /// @brief Make a bin with all the components of a fill history.
+    ///
+    /// Mainly intended for internal persistency use.
+    CountBin2D(const std::pair<double, double>& xedges,
+               const std::pair<double, double>& yedges, const Dbn0D& dbn)
+      : HistoBin2DT<Dbn0D>(xedges, yedges, dbn)
+    { }
+
+    /// Copy constructor, also from the bin template
+    CountBin2D(const HistoBin2DT<Dbn0D>& cb)
+      : HistoBin2DT<Dbn0D>(cb)
+    { }
+
+  };
+
+
+  /// Bin addition operator
+  inline CountBin2D operator + (const CountBin2D& a, const CountBin2D& b) {
+    CountBin2D rtn(a);
+    rtn += b;
+    return rtn;
+  }
+
+
+  /// Bin subtraction operator
+  inline CountBin2D operator - (const CountBin2D& a, const CountBin2D& b) {
+    CountBin2D rtn(a);
+    rtn -= b;
+    return rtn;
+  }
+
+
+}
+
+#endif
@@ -0,0 +1,494 @@
+// -*- C++ -*-
+//
+// This file is part of YODA -- Yet more Objects for Data Analysis
+// Copyright (C) 2008-2021 The YODA collaboration (see AUTHORS for details)
+//
+#ifndef YODA_CountHisto1D_h
+#define YODA_CountHisto1D_h
+
+#include "YODA/AnalysisObject.h"
+#include "YODA/Binned.h"
+#include "YODA/Fillable.h"
+#include "YODA/CountBin1D.h"
+#include "YODA/Dbn0D.h"
+#include "YODA/Histo1D.h"
+#include "YODA/Scatter2D.h"
+#include "YODA/Axis1D.h"
+#include "YODA/Exceptions.h"
+#include <vector>
+#include <string>
+
+namespace YODA {
+
+
+  /// Convenience typedef
+  typedef Axis1D<CountBin1D, Dbn0D> CountHisto1DAxis;
+
+  /// @brief A one-dimensional histogram which accumulates only counts
+  ///
+  /// A lighter Histo1D, whose bins and outflows hold the Dbn0D moment set:
+  /// number of entries, sum of weights and sum of squared weights. Heights,
+  /// areas and their errors are as for Histo1D, but the fill positions are not
+  /// recorded, so there are no x means, variances etc. and the bin foci are the
+  /// bin midpoints. Each bin is two doubles smaller than a HistoBin1D, and a
+  /// fill updates three running sums rather than five.
+  ///
+  /// Use mkHisto1D to convert to a Histo1D, e.g. for operations which need x moments.
+  ///
+  /// @note The bins derive from the Dbn0D instance of the HistoBin1DT template,
+  /// as HistoBin1D does from its Dbn1D one, and fill() and fillMany() are Axis1D::_fillHisto and
+  /// _fillHistoMany, as for Histo1D, so bin arithmetic and the fill, NaN, gap and
+  /// auto-binning handling are shared. Only the class-level interface, i.e. the
+  /// constructors, integrals, whole-histogram operators and conversions, is
+  /// this class's own code alongside Histo1D's.
+  ///
+  /// Only the counts-only and the full moment sets are provided: an
+  /// intermediate "+x moments" tier without the cross terms, and lighter
+  /// ProfileBin2D/Dbn3D policies, are out of scope.
+  class CountHisto1D : public AnalysisObject, public Binned, public Fillable {
+  public:
+
+    /// Convenience typedefs
+    typedef CountHisto1DAxis Axis;
+    typedef Axis::Bins Bins;
+    typedef CountBin1D Bin;
+
+    typedef double FillType;
+    typedef FillType BinType;
+    typedef std::shared_ptr<CountHisto1D> Ptr;
+
+    /// @name Constructors
+    /// @{
+
+    /// Default constructor
+    CountHisto1D(const std::string& path="", const std::string& title="")
+      : AnalysisObject("CountHisto1D", path, title),
+        _axis()
+    { }
+
+
+    /// Constructor giving range and number of bins.
+    CountHisto1D(size_t nbins, double lower, double upper,
+                 const std::string& path="", const std::string& title="")
+      : AnalysisObject("CountHisto1D", path, title),
+        _axis(nbins, lower, upper)
+    { }
+
+
+    /// @brief Constructor giving explicit bin edges.
+    ///
+    /// For n bins, binedges.size() == n+1, the last one being the upper bound
+    /// of the last bin
+    CountHisto1D(const std::vector<double>& binedges,
+                 const std::string& path="", const std::string& title="")
+      : AnalysisObject("CountHisto1D", path, title),
+        _axis(binedges)
+    { }
+
+
+    /// Constructor accepting an explicit collection of bins.
+    CountHisto1D(const std::vector<Bin>& bins,
+                 const std::string& path="", const std::string& title="")
+      : AnalysisObject("CountHisto1D", path, title),
+        _axis(bins)
+    { }
+
+
+    /// Copy constructor with optional new path
+    CountHisto1D(const CountHisto1D& h, const std::string& path="");
+
+
+    /// Constructor from a Histo1D, dropping its x moments, with optional new path
+    CountHisto1D(const Histo1D& h, const std::string& path="");
+
+
+    /// @brief State-setting constructor
+    ///
+    /// Intended principally for internal persistency use.
+    CountHisto1D(const std::vector<CountBin1D>& bins,
+                 const Dbn0D& dbn_tot, const Dbn0D& dbn_uflow, const Dbn0D& dbn_oflow,
+                 const std::string& path="", const std::string& title="")
+      : AnalysisObject("CountHisto1D", path, title),
+        _axis(bins, dbn_tot, dbn_uflow, dbn_oflow)
+    { }
+
+
+    /// Assignment operator
+    CountHisto1D& operator = (const CountHisto1D& h1) {
+      AnalysisObject::operator = (h1); //< AO treatment of paths etc.
+      _axis = h1._axis;
+      return *this;
+    }
+
+    /// Make a copy on the stack
+    CountHisto1D clone() const {
+      return CountHisto1D(*this);
+    }
+
+    /// Make a copy on the heap, via 'new'
+    CountHisto1D* newclone() const {
+      return new CountHisto1D(*this);
+    }
+
+    /// @}
+
+
+    /// Fill dimension of this data object
+    size_t dim() const { return 1; }
+
+    /// Fill dimension of this data object
+    size_t fillDim() const { return 1; }
+
+
+    /// @name Modifiers
+    /// @{
+
+    /// @brief Reset the histogram.
+    ///
+    /// Keep the binning but set all bin contents and related quantities to zero
+    virtual void reset() {
+      _axis.reset();
+    }
+
+    /// Fill histo by value and weight, optionally as a fractional fill
+    virtual void fill(double x, double weight=1.0, double fraction=1.0);
+
+    /// @brief Fill histo from arrays of @a n values, weights and fractions
+    ///
+    /// Equivalent to a loop of fill() calls, as for Histo1D::fillMany.
+    virtual void fillMany(size_t n, const double* xs,
+                          const double* weights=nullptr, const double* fractions=nullptr);
+
+    /// Fill histo from vectors of values, weights and fractions (the last two may be empty)
+    void fillMany(const std::vector<double>& xs,
+                  const std::vector<double>& weights=std::vector<double>(),
+                  const std::vector<double>& fractions=std::vector<double>()) {
+      _checkFillSizes(xs.size(), weights.size(), fractions.size());
+      fillMany(xs.size(), xs.data(),
+               weights.empty() ? nullptr : weights.data(),
+               fractions.empty() ? nullptr : fractions.data());
+    }
+
+    /// Fill histo bin i with the given weight, optionally as a fractional fill
+    virtual void fillBin(size_t i, double weight=1.0, double fraction=1.0);
+
+
+    /// Rescale as if all fill weights had been different by factor @a scalefactor.
+    void scaleW(double scalefactor) {
+      setAnnotation("ScaledBy", annotation<double>("ScaledBy", 1.0) * scalefactor);
+      _axis.scaleW(scalefactor);
+    }
+
+
+    /// Normalize the (visible) histo area to the @a normto value.
+    ///
+    /// As for Histo1D::normalize.
+    void normalize(double normto=1.0, bool includeoverflows=true) {
+      const double oldintegral = integral(includeoverflows);
+      if (oldintegral == 0) throw WeightError("Attempted to normalize a histogram with null area");
+      scaleW(normto / oldintegral);
+    }
+
+
+    /// Merge together the bin range with indices from @a from to @a to, inclusive
+    void mergeBins(size_t from, size_t to) {
+      _axis.mergeBins(from, to);
+    }
+
+    /// Merge every group of n bins, starting from the LHS
+    void rebinBy(unsigned int n, size_t begin=0, size_t end=UINT_MAX) {
+      _axis.rebinBy(n, begin, end);
+    }
+    /// Overloaded alias for rebinBy
+    void rebin(unsigned int n, size_t begin=0, size_t end=UINT_MAX) {
+      rebinBy(n, begin, end);
+    }
+
+    /// Rebin to the given list of bin edges
+    void rebinTo(const std::vector<double>& newedges) {
+      _axis.rebinTo(newedges);
+    }
+    /// Overloaded alias for rebinTo
+    void rebin(const std::vector<double>& newedges) {
+      rebinTo(newedges);
+    }
+
+    /// @}
+
+
+    /// @name NaN and bin-gap fill handling
+    /// @{
+
+    /// Policy for fills with a NaN coordinate (default FILL_THROW)
+    FillPolicy nanPolicy() const { return _axis.nanPolicy(); }
+    /// Set the policy for fills with a NaN coordinate
+    void setNanPolicy(FillPolicy policy) { _axis.setNanPolicy(policy); }
+
+    /// Policy for in-range fills which fall into a bin gap (default FILL_IGNORE)
+    FillPolicy gapPolicy() const { return _axis.gapPolicy(); }
+    /// Set the policy for in-range fills which fall into a bin gap
+    void setGapPolicy(FillPolicy policy) { _axis.setGapPolicy(policy); }
+
+    /// Weights of the NaN fills recorded under the FILL_COUNT policy
+    const Dbn0D& nanDbn() const { return _axis.nanDbn(); }
+
+    /// Weights of the bin-gap fills recorded under the FILL_COUNT policy
+    const Dbn0D& gapDbn() const { return _axis.gapDbn(); }
+
+    /// @}
+
+
+    /// @name Columnar storage
+    /// @{
+
+    /// @brief Hold the bin contents as one array per running sum, for fast whole-histo operations
+    ///
+    /// See Axis1D::setColumnar for details.
+    void setColumnar(bool columnar=true) { _axis.setColumnar(columnar); }
+
+    /// Whether the bin contents are held in columnar form
+    bool columnar() const { return _axis.columnar(); }
+
+    /// @}
+
+
+    /// @name Bin accessors
+    /// @{
+
+    /// Number of bins (not counting under/overflow)
+    size_t numBins() const { return _axis.numBins(); }
+
+    /// Number of bins on the x (only) axis (not counting under/overflow)
+    size_t numBinsX() const { return numBins(); }
+
+    /// Low edge of this histo's axis
+    double xMin() const { return _axis.xMin(); }
+
+    /// High edge of this histo's axis
+    double xMax() const { return _axis.xMax(); }
+
+    /// check if binning is the same as different CountHisto1D
+    bool sameBinning(const CountHisto1D& h1) {
+      return _axis == h1._axis;
+    }
+
+    /// All bin edges on this histo's axis
+    ///
+    /// @note This only returns the finite edges, i.e. -inf and +inf are removed
+    std::vector<double> xEdges() const { return _axis.xEdges(); }
+
+    /// All bin widths on this histo's axis
+    ///
+    /// @note This only returns the finite edges, i.e. -inf and +inf are removed
+    std::vector<double> xWidths() const { return _axis.xWidths(); }
+
+    /// Access the bin vector
+    std::vector<YODA::CountBin1D>& bins() { return _axis.bins(); }
+    /// Access the bin vector (const version)
+    const std::vector<YODA::CountBin1D>& bins() const { return _axis.bins(); }
+
+
+    /// Access a bin by index (non-const version)
+    CountBin1D& bin(size_t index) { return _axis.bin(index); }
+    /// Access a bin by index (const version)
+    const CountBin1D& bin(size_t index) const { return _axis.bin(index); }
+
+
+    /// Access a bin index by coordinate
+    int binIndexAt(double x) {
+      return _axis.binIndexAt(x);
+    }
+
+    /// Access a bin by coordinate (const version)
+    const CountBin1D& binAt(double x) const { return _axis.binAt(x); }
+
+
+    /// Access summary distribution, including gaps and overflows (non-const version)
+    Dbn0D& totalDbn() { return _axis.totalDbn(); }
+    /// Access summary distribution, including gaps and overflows (const version)
+    const Dbn0D& totalDbn() const { return _axis.totalDbn(); }
+    /// Set summary distribution, mainly for persistency: CAREFUL!
+    void setTotalDbn(const Dbn0D& dbn) { _axis.setTotalDbn(dbn); }
+
+
+    /// Access underflow (non-const version)
+    Dbn0D& underflow() { return _axis.underflow(); }
+    /// Access underflow (const version)
+    const Dbn0D& underflow() const { return _axis.underflow(); }
+    /// Set underflow distribution, mainly for persistency: CAREFUL!
+    void setUnderflow(const Dbn0D& dbn) { _axis.setUnderflow(dbn); }
+
+
+    /// Access overflow (non-const version)
+    Dbn0D& overflow() { return _axis.overflow(); }
+    /// Access overflow (const version)
+    const Dbn0D& overflow() const { return _axis.overflow(); }
+    /// Set overflow distribution, mainly for persistency: CAREFUL!
+    void setOverflow(const Dbn0D& dbn) { _axis.setOverflow(dbn); }
+
+    /// @}
+
+
+    /// @name Bin adding and removing
+    /// @{
+
+    /// Add a new bin specifying its lower and upper bound
+    void addBin(double from, double to) { _axis.addBin(from, to); }
+
+    /// Add new bins by specifying a vector of edges
+    void addBins(std::vector<double> edges) { _axis.addBins(edges); }
+
+    /// Add a new bin, perhaps already populated: CAREFUL!
+    void addBin(const CountBin1D& b) { _axis.addBin(b); }
+
+    /// @brief Bins addition operator
+    ///
+    /// Add multiple bins without resetting
+    void addBins(const Bins& bins) {
+      _axis.addBins(bins);
+    }
+
+    /// Remove a bin
+    void rmBin(size_t index) { _axis.eraseBin(index); }
+
+    /// @}
+
+
+    /// @name Whole histo data
+    /// @{
+
+    /// Get the total area (sumW) of the histogram
+    double integral(bool includeoverflows=true) const { return sumW(includeoverflows); }
+
+    /// @brief Get the integrated area of the histogram between bins @a binindex1 and @a binindex2.
+    ///
+    /// @note The area of bin @a binindex2 _is_ included in the returned value.
+    double integralRange(size_t binindex1, size_t binindex2) const {
+      assert(binindex2 >= binindex1);
+      if (binindex1 >= numBins()) throw RangeError("binindex1 is out of range");
+      if (binindex2 >= numBins()) throw RangeError("binindex2 is out of range");
+      double rtn = 0;
+      for (size_t i = binindex1; i <= binindex2; ++i) {
+        rtn += bin(i).sumW();
+      }
+      return rtn;
+    }
+
+    /// @brief Get the integrated area of the histogram up to bin @a binindex.
+    ///
+    /// @note The area of bin @a binindex _is_ included in the returned
+    /// value. To not include the underflow, set includeunderflow=false.
+    double integralTo(size_t binindex, bool includeunderflow=true) const {
+      double rtn = includeunderflow ? underflow().sumW() : 0;
+      rtn += integralRange(0, binindex);
+      return rtn;
+    }
+
+    /// Get the number of fills
+    double numEntries(bool includeoverflows=true) const;
+
+    /// Get the effective number of fills
+    double effNumEntries(bool includeoverflows=true) const;
+
+    /// Get sum of weights in histo
+    double sumW(bool includeoverflows=true) const;
+
+    /// Get sum of squared weights in histo
+    double sumW2(bool includeoverflows=true) const;
+
+    /// @}
+
+
+    /// @name Adding and subtracting histograms
+    /// @{
+
+    /// @brief Add another histogram to this one
+    ///
+    /// @note Adding histograms will unset any ScaledBy attribute from prevous calls to scaleW or normalize.
+    CountHisto1D& operator += (const CountHisto1D& toAdd) {
+      if (hasAnnotation("ScaledBy")) rmAnnotation("ScaledBy");
+      _axis += toAdd._axis;
+      return *this;
+    }
+
+    /// @brief Subtract another histogram from this one
+    ///
+    /// @note Subtracting histograms will unset any ScaledBy attribute from prevous calls to scaleW or normalize.
+    CountHisto1D& operator -= (const CountHisto1D& toSubtract) {
+      if (hasAnnotation("ScaledBy")) rmAnnotation("ScaledBy");
+      _axis -= toSubtract._axis;
+      return *this;
+    }
+
+    /// @}
+
+
+  private:
+
+    /// @name Bin data
+    /// @{
+
+    /// Definition of bin edges and contents
+    Axis1D<CountBin1D, Dbn0D> _axis;
+
+    /// @}
+
+  };
+
+
+  /// @name Combining histos: global operators
+  /// @{
+
+  /// Add two histograms
+  inline CountHisto1D add(const CountHisto1D& first, const CountHisto1D& second) {
+    CountHisto1D tmp = first;
+    if (first.path() != second.path()) tmp.setPath("");
+    tmp += second;
+    return tmp;
+  }
+
+  /// Add two histograms
+  inline CountHisto1D operator + (const CountHisto1D& first, const CountHisto1D& second) {
+    return add(first, second);
+  }
+
+  /// Subtract two histograms
+  inline CountHisto1D subtract(const CountHisto1D& first, const CountHisto1D& second) {
+    CountHisto1D tmp = first;
+    if (first.path() != second.path()) tmp.setPath("");
+    tmp -= second;
+    return tmp;
+  }
+
+  /// Subtract two histograms
+  inline CountHisto1D operator - (const CountHisto1D& first, const CountHisto1D& second) {
+    return subtract(first, second);
+  }
+
+  /// @}
+
+
+  /// @name Conversions
+  /// @{
+
+  /// @brief Convert to a Histo1D
+  ///
+  /// The counts are copied exactly. The missing x moments are filled in as if
+  /// all in-range fills had been at their bin midpoints, so the bin foci are
+  /// the bin midpoints, and the under- and overflow fills at the low and high
+  /// axis edges. The total distribution gets the sum of these moments, with
+  /// any remaining total weight, i.e. that of bin-gap fills, at the bins' mean.
+  Histo1D mkHisto1D(const CountHisto1D& h);
+
+  /// @brief Make a Scatter2D representation of a counts-only histogram
+  ///
+  /// As for the Histo1D version, with the points at the bin midpoints.
+  Scatter2D mkScatter(const CountHisto1D& h, bool binwidthdiv=true,
+                      double uflow_binwidth=-1, double oflow_binwidth=-1);
+
+  /// @}
+
+
+}
+
+#endif
@@ -0,0 +1,465 @@
+// -*- C++ -*-
+//
+// This file is part of YODA -- Yet more Objects for Data Analysis
+// Copyright (C) 2008-2021 The YODA collaboration (see AUTHORS for details)
+//
+#ifndef YODA_CountHisto2D_h
+#define YODA_CountHisto2D_h
+
+#include "YODA/AnalysisObject.h"
+#include "YODA/Fillable.h"
+#include "YODA/Binned.h"
+#include "YODA/CountBin2D.h"
+#include "YODA/Dbn0D.h"
+#include "YODA/Histo2D.h"
+#include "YODA/Axis2D.h"
+#include "YODA/Scatter3D.h"
+#include "YODA/Exceptions.h"
+#include <vector>
+#include <tuple>
+
+namespace YODA {
+
+
+  /// Convenience typedef
+  typedef Axis2D<CountBin2D, Dbn0D> CountHisto2DAxis;
+
+
+  /// @brief A two-dimensional histogram which accumulates only counts
+  ///
+  /// A lighter Histo2D, whose bins hold the Dbn0D moment set: number of
+  /// entries, sum of weights and sum of squared weights. Volumes, heights and
+  /// their errors are as for Histo2D, but there are no x or y means, variances
+  /// etc. and the bin foci are the bin midpoints. Each bin is five doubles
+  /// smaller than a HistoBin2D, and a fill updates three running sums rather
+  /// than eight.
+  ///
+  /// Use mkHisto2D to convert to a Histo2D, e.g. for operations which need x and y moments.
+  ///
+  /// @note The bins derive from the Dbn0D instance of the HistoBin2DT template,
+  /// as HistoBin2D does from its Dbn2D one, and the fills are Axis2D::_fillHisto and
+  /// _fillMany, as for Histo2D. As for CountHisto1D, only the class-level
+  /// interface is separate code, and a tier with x and y but no cross moments,
+  /// or a lighter Profile2D, is out of scope.
+  class CountHisto2D : public AnalysisObject, public Fillable, public Binned {
+  public:
+
+    /// Convenience typedefs
+    typedef CountHisto2DAxis Axis;
+    typedef Axis::Bins Bins;
+    typedef CountBin2D Bin;
+    typedef Axis::Outflows Outflows;
+
+    typedef std::tuple<double, double> FillType;
+    typedef FillType BinType;
+    typedef std::shared_ptr<CountHisto2D> Ptr;
+
+
+    /// @name Constructors
+    /// @{
+
+    /// Default constructor
+    CountHisto2D(const std::string& path="", const std::string& title="")
+      : AnalysisObject("CountHisto2D", path, title),
+        _axis()
+    { }
+
+
+    /// Constructor giving range and number of bins.
+    CountHisto2D(size_t nbinsX, double lowerX, double upperX,
+                 size_t nbinsY, double lowerY, double upperY,
+                 const std::string& path="", const std::string& title="")
+      : AnalysisObject("CountHisto2D", path, title),
+        _axis(nbinsX, std::make_pair(lowerX, upperX),  nbinsY, std::make_pair(lowerY, upperY))
+    { }
+
+
+    /// Constructor accepting the bin edges on X and Y axis.
+    CountHisto2D(const std::vector<double>& xedges, const std::vector<double>& yedges,
+                 const std::string& path="", const std::string& title="")
+      : AnalysisObject("CountHisto2D", path, title),
+        _axis(xedges, yedges)
+    { }
+
+
+    /// Copy constructor with optional new path
+    CountHisto2D(const CountHisto2D& h, const std::string& path="");
+
+    /// Constructor from a Histo2D, dropping its x and y moments, with optional new path
+    CountHisto2D(const Histo2D& h, const std::string& path="");
+
+    /// @brief State-setting constructor
+    ///
+    /// Mainly intended for internal persistency use.
+    CountHisto2D(const std::vector<CountBin2D>& bins,
+                 const Dbn0D& totalDbn,
+                 const Outflows& outflows,
+                 const std::string& path="", const std::string& title="")
+      : AnalysisObject("CountHisto2D", path, title),
+        _axis(bins, totalDbn, outflows)
+    { }
+
+
+    /// Assignment operator
+    CountHisto2D& operator = (const CountHisto2D& h2) {
+      AnalysisObject::operator = (h2); //< AO treatment of paths etc.
+      _axis = h2._axis;
+      return *this;
+    }
+
+
+    /// Make a copy on the stack
+    CountHisto2D clone() const {
+      return CountHisto2D(*this);
+    }
+
+    /// Make a copy on the heap, via 'new'
+    CountHisto2D* newclone() const {
+      return new CountHisto2D(*this);
+    }
+
+    /// @}
+
+
+    /// Fill dimension of this data object
+    size_t dim() const { return 2; }
+
+    /// Fill dimension of this data object
+    size_t fillDim() const { return 2; }
+
+
+    /// @name Modifiers
+    /// @{
+
+    /// Fill histo with weight at (x,y)
+    virtual void fill(double x, double y, double weight=1.0, double fraction=1.0);
+
+    /// Fill histo with weight at the coordinates tuple
+    virtual void fill(const FillType & xs, double weight=1.0, double fraction=1.0) {
+      fill(std::get<0>(xs), std::get<1>(xs), weight, fraction);
+    }
+
+    /// @brief Fill histo from arrays of @a n x and y values, weights and fractions
+    ///
+    /// Equivalent to a loop of fill() calls, as for Histo2D::fillMany.
+    virtual void fillMany(size_t n, const double* xs, const double* ys,
+                          const double* weights=nullptr, const double* fractions=nullptr);
+
+    /// Fill histo from vectors of x and y values, weights and fractions (the last two may be empty)
+    void fillMany(const std::vector<double>& xs, const std::vector<double>& ys,
+                  const std::vector<double>& weights=std::vector<double>(),
+                  const std::vector<double>& fractions=std::vector<double>()) {
+      if (ys.size() != xs.size()) throw UserError("Mismatched x and y array sizes in fillMany");
+      _checkFillSizes(xs.size(), weights.size(), fractions.size());
+      fillMany(xs.size(), xs.data(), ys.data(),
+               weights.empty() ? nullptr : weights.data(),
+               fractions.empty() ? nullptr : fractions.data());
+    }
+
+    /// Fill histo x-y bin i with the given weight
+    virtual void fillBin(size_t i, double weight=1.0, double fraction=1.0);
+
+
+    /// @brief Reset the histogram.
+    ///
+    /// Keep the binning but set all bin contents and related quantities to zero
+    void reset() {
+      _axis.reset();
+    }
+
+    /// Rescale as if all fill weights had been different by factor @a scalefactor.
+    void scaleW(double scalefactor) {
+      setAnnotation("ScaledBy", annotation<double>("ScaledBy", 1.0) * scalefactor);
+      _axis.scaleW(scalefactor);
+    }
+
+    /// Normalize the (visible) histo "volume" to the @a normto value.
+    ///
+    /// As for Histo2D::normalize.
+    void normalize(double normto=1.0, bool includeoverflows=true) {
+      flushFills();
+      const double oldintegral = integral(includeoverflows);
+      if (oldintegral == 0) throw WeightError("Attempted to normalize a histogram with null area");
+      scaleW(normto / oldintegral);
+    }
+
+    /// @}
+
+
+    /// @name Bin adding and removing
+    /// @{
+
+    /// @brief Bin addition operator
+    ///
+    /// Add a bin to an axis described by its x and y ranges.
+    void addBin(Axis::EdgePair1D xrange, Axis::EdgePair1D yrange) {
+       _axis.addBin(xrange, yrange);
+    }
+
+    /// @brief Bin addition operator
+    ///
+    /// Add a bin, possibly already populated
+    void addBin(const Bin& bin) {
+      _axis.addBin(bin);
+    }
+
+    /// @brief Bins addition operator
+    ///
+    /// Add multiple bins from edge cuts without resetting
+    void addBins(const Axis::Edges& xcuts, const Axis::Edges& ycuts) {
+      _axis.addBins(xcuts, ycuts);
+    }
+
+    /// @brief Bins addition operator
+    ///
+    /// Add multiple bins without resetting
+    void addBins(const Bins& bins) {
+      _axis.addBins(bins);
+    }
+
+    /// Remove a bin
+    void rmBin(size_t index) {
+      _axis.eraseBin(index);
+    }
+
+    /// @}
+
+
+    /// @name NaN and bin-gap fill handling
+    /// @{
+
+    /// Policy for fills with a NaN coordinate (default FILL_THROW)
+    FillPolicy nanPolicy() const { return _axis.nanPolicy(); }
+    /// Set the policy for fills with a NaN coordinate
+    void setNanPolicy(FillPolicy policy) { _axis.setNanPolicy(policy); }
+
+    /// Policy for in-range fills which fall into a bin gap (default FILL_IGNORE)
+    FillPolicy gapPolicy() const { return _axis.gapPolicy(); }
+    /// Set the policy for in-range fills which fall into a bin gap
+    void setGapPolicy(FillPolicy policy) { _axis.setGapPolicy(policy); }
+
+    /// Weights of the NaN fills recorded under the FILL_COUNT policy
+    const Dbn0D& nanDbn() const { return _axis.nanDbn(); }
+
+    /// Weights of the bin-gap fills recorded under the FILL_COUNT policy
+    const Dbn0D& gapDbn() const { return _axis.gapDbn(); }
+
+    /// @}
+
+
+    /// @name Buffered filling
+    /// @{
+
+    /// @brief Queue up to @a n fills and accumulate them in bin order, for large binnings
+    ///
+    /// See Axis2D::setFillBuffer for details.
+    void setFillBuffer(size_t n=FILLBUFFER_SIZE) { _axis.setFillBuffer(n); }
+
+    /// Maximum number of queued fills, or 0 if fills are not buffered
+    size_t fillBufferSize() const { return _axis.fillBufferSize(); }
+
+    /// Accumulate all queued fills now
+    void flushFills() { _axis.flushFills(); }
+
+    /// @}
+
+
+    /// @name Columnar storage
+    /// @{
+
+    /// @brief Hold the bin contents as one array per running sum, for fast whole-histo operations
+    ///
+    /// See Axis2D::setColumnar for details.
+    void setColumnar(bool columnar=true) { _axis.setColumnar(columnar); }
+
+    /// Whether the bin contents are held in columnar form
+    bool columnar() const { return _axis.columnar(); }
+
+    /// @}
+
+
+    /// @name Bin accessors
+    /// @{
+
+    /// All bin edges on this histo's x axis
+    std::vector<double> xEdges() const { return _axis.xEdges(); }
+
+    /// All bin edges on this histo's y axis
+    std::vector<double> yEdges() const { return _axis.yEdges(); }
+
+    /// All bin widths on this histo's x axis
+    std::vector<double> xWidths() const { return _axis.xWidths(); }
+
+    /// All bin widths on this histo's y axis
+    std::vector<double> yWidths() const { return _axis.yWidths(); }
+
+    /// Low x edge of this histo's axis
+    double xMin() const { return _axis.xMin(); }
+
+    /// High x edge of this histo's axis
+    double xMax() const { return _axis.xMax(); }
+
+    /// Low y edge of this histo's axis
+    double yMin() const { return _axis.yMin(); }
+
+    /// High y edge of this histo's axis
+    double yMax() const { return _axis.yMax(); }
+
+
+    /// check if binning is the same as different CountHisto2D
+    bool sameBinning(const CountHisto2D& h2) {
+      return _axis == h2._axis;
+    }
+
+    /// Access the bin vector (non-const version)
+    std::vector<YODA::CountBin2D>& bins() { return _axis.bins(); }
+    /// Access the bin vector (const version)
+    const std::vector<YODA::CountBin2D>& bins() const { return _axis.bins(); }
+
+
+    /// Access a bin by index (non-const version)
+    CountBin2D& bin(size_t index) { return _axis.bin(index); }
+    /// Access a bin by index (const version)
+    const CountBin2D& bin(size_t index) const { return _axis.bin(index); }
+
+
+    /// Access a bin index by coordinate
+    int binIndexAt(double x, double y) { return _axis.binIndexAt(x, y); }
+
+    /// Access a bin by coordinate (const version)
+    const CountBin2D& binAt(double x, double y) const { return _axis.binAt(x, y); }
+
+
+    /// Number of bins
+    size_t numBins() const { return _axis.numBins(); }
+
+    /// Number of bins along the x axis
+    size_t numBinsX() const { return _axis.numBinsX(); }
+
+    /// Number of bins along the y axis
+    size_t numBinsY() const { return _axis.numBinsY(); }
+
+
+    /// Access summary distribution, including gaps and overflows (non-const version)
+    Dbn0D& totalDbn() { return _axis.totalDbn(); }
+    /// Access summary distribution, including gaps and overflows (const version)
+    const Dbn0D& totalDbn() const { return _axis.totalDbn(); }
+    /// Set summary distribution, including gaps and overflows
+    void setTotalDbn(const Dbn0D& dbn) { _axis.setTotalDbn(dbn); }
+
+    /// @}
+
+
+    /// @name Whole histo data
+    /// @{
+
+    /// Get the total volume of the histogram
+    double integral(bool includeoverflows=true) const { return sumW(includeoverflows); }
+
+    /// Get the number of fills (fractional fills are possible)
+    double numEntries(bool includeoverflows=true) const;
+
+    /// Get the effective number of fills
+    double effNumEntries(bool includeoverflows=true) const;
+
+    /// Get the sum of weights in histo
+    double sumW(bool includeoverflows=true) const;
+
+    /// Get the sum of squared weights in histo
+    double sumW2(bool includeoverflows=true) const;
+
+    /// @}
+
+
+    /// @name Adding and subtracting histograms
+    /// @{
+
+    /// @brief Add another histogram to this one
+    ///
+    /// @note Adding histograms will unset any ScaledBy attribute from prevous calls to scaleW or normalize.
+    CountHisto2D& operator += (const CountHisto2D& toAdd) {
+      if (hasAnnotation("ScaledBy")) rmAnnotation("ScaledBy");
+      _axis += toAdd._axis;
+      return *this;
+    }
+
+    /// @brief Subtract another histogram from this one
+    ///
+    /// @note Subtracting histograms will unset any ScaledBy attribute from prevous calls to scaleW or normalize.
+    CountHisto2D& operator -= (const CountHisto2D& toSubtract) {
+      if (hasAnnotation("ScaledBy")) rmAnnotation("ScaledBy");
+      _axis -= toSubtract._axis;
+      return *this;
+    }
+
+    /// @}
+
+
+  private:
+
+    /// @name Bin data
+    /// @{
+
+    /// Definition of bin edges and contents
+    Axis2D<CountBin2D, Dbn0D> _axis;
+
+    /// @}
+
+  };
+
+
+  /// @name Combining histos: global operators
+  /// @{
+
+  /// Add two histograms
+  inline CountHisto2D add(const CountHisto2D& first, const CountHisto2D& second) {
+    CountHisto2D tmp = first;
+    if (first.path() != second.path()) tmp.setPath("");
+    tmp += second;
+    return tmp;
+  }
+
+  /// Add two histograms
+  inline CountHisto2D operator + (const CountHisto2D& first, const CountHisto2D& second) {
+    return add(first, second);
+  }
+
+  /// Subtract two histograms
+  inline CountHisto2D subtract(const CountHisto2D& first, const CountHisto2D& second) {
+    CountHisto2D tmp = first;
+    if (first.path() != second.path()) tmp.setPath("");
+    tmp -= second;
+    return tmp;
+  }
+
+  /// Subtract two histograms
+  inline CountHisto2D operator - (const CountHisto2D& first, const CountHisto2D& second) {
+    return subtract(first, second);
+  }
+
+  /// @}
+
+
+  /// @name Conversions
+  /// @{
+
+  /// @brief Convert to a Histo2D
+  ///
+  /// The counts are copied exactly. The missing moments are filled in as if
+  /// all in-range fills had been at their bin midpoints, so the bin foci are
+  /// the bin midpoints. The total distribution gets the sum of the bin moments,
+  /// with the total weight outside the bins, whose fill positions are not
+  /// recorded, at the bins' mean.
+  Histo2D mkHisto2D(const CountHisto2D& h);
+
+  /// @brief Make a Scatter3D representation of a counts-only histogram
+  ///
+  /// As for the Histo2D version, with the points at the bin midpoints.
+  Scatter3D mkScatter(const CountHisto2D& h, bool binareadiv=true);
+
+  /// @}
+
+
+}
+
+#endif
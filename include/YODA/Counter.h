@@ -110,6 +110,22 @@ namespace YODA {
       fill(weight, fraction);
     }
 
+    /// @brief Fill from arrays of @a n weights and fractions
+    ///
+    /// Null @a weights or @a fractions pointers are treated as all-1.
+    virtual void fillMany(size_t n, const double* weights, const double* fractions=nullptr) {
+      for (size_t k = 0; k < n; ++k) {
+        _dbn.fill(weights ? weights[k] : 1.0, fractions ? fractions[k] : 1.0);
+      }
+    }
+
+    /// Fill from vectors of weights and fractions (the latter may be empty)
+    void fillMany(const std::vector<double>& weights,
+                  const std::vector<double>& fractions=std::vector<double>()) {
+      _checkFillSizes(weights.size(), 0, fractions.size());
+      fillMany(weights.size(), weights.data(), fractions.empty() ? nullptr : fractions.data());
+    }
+
     /// @brief Reset the histogram.
     ///
     /// Keep the binning but set all bin contents and related quantities to zero
@@ -9,6 +9,7 @@
 #include "YODA/Exceptions.h"
 #include "YODA/Utils/MathUtils.h"
 #include <cmath>
+#include <cstdint>
 
 namespace YODA {
 
@@ -25,6 +26,14 @@ namespace YODA {
   /// aggregate of the supplied weights.  It is used to provide this information
   /// in the Counter class and in Dbn1D, Dbn2D, etc. (which themselves are used
   /// to implement histogram and profile bins).
+  ///
+  /// Fills of unit weight and fraction are counted in an exact 64-bit
+  /// integer, kept next to the floating-point sums of all the other fills,
+  /// and numEntries, sumW and sumW2 add the two. Pure unit-fill counts thus
+  /// have no rounding drift above 2^53, whatever the mix of fills. Rescaling
+  /// folds the count into the floating-point sums. The split is invisible to
+  /// readers, writers and arithmetic, and the columnar bin storage of
+  /// DbnColumns keeps the count in the same way.
   class Dbn0D {
   public:
 
@@ -39,21 +48,27 @@ namespace YODA {
 
     /// @brief Constructor to set a distribution with a pre-filled state.
     ///
-    /// Principally designed for internal persistency use.
+    /// Principally designed for internal persistency use. Equal, integral and
+    /// non-negative sums, as unit fills produce, go to the unit-fill count.
     Dbn0D(double numEntries, double sumW, double sumW2)
-      : _numEntries(numEntries),
+      : _unitFills(0),
+        _numEntries(numEntries),
         _sumW(sumW),
         _sumW2(sumW2)
-    { }
+    {
+      if (sumW == numEntries && sumW2 == numEntries && numEntries >= 0 &&
+          numEntries < 18446744073709551616.0 && numEntries == std::floor(numEntries)) {
+        _unitFills = static_cast<uint64_t>(numEntries);
+        _numEntries = _sumW = _sumW2 = 0;
+      }
+    }
 
 
     /// Copy constructor
     ///
     /// Sets all the parameters using the ones provided from an existing Dbn0D.
     Dbn0D(const Dbn0D& toCopy) {
-      _numEntries = toCopy._numEntries;
-      _sumW = toCopy._sumW;
-      _sumW2 = toCopy._sumW2;
+      *this = toCopy;
     }
 
 
@@ -61,6 +76,7 @@ namespace YODA {
     ///
     /// Sets all the parameters using the ones provided from an existing Dbn0D.
     Dbn0D& operator=(const Dbn0D& toCopy) {
+      _unitFills = toCopy._unitFills;
       _numEntries = toCopy._numEntries;
       _sumW = toCopy._sumW;
       _sumW2 = toCopy._sumW2;
@@ -77,6 +93,10 @@ namespace YODA {
     ///
     /// @todo Be careful about negative weights.
     void fill(double weight=1.0, double fraction=1.0) {
+      if (weight == 1.0 && fraction == 1.0) {
+        ++_unitFills;
+        return;
+      }
       _numEntries += fraction;
       _sumW += fraction*weight;
       _sumW2 += fraction*weight*weight;
@@ -85,16 +105,28 @@ namespace YODA {
 
     /// Reset the internal counters.
     void reset() {
+      _unitFills = 0;
       _numEntries = 0;
       _sumW = 0;
       _sumW2 = 0;
     }
 
+    /// @brief Set the count of unit fills to @a n, keeping the other sums
+    ///
+    /// For storage which keeps the exact count itself, such as DbnColumns.
+    void setUnitFills(uint64_t n) {
+      _unitFills = n;
+    }
+
 
     /// Rescale as if all fill weights had been different by factor @a scalefactor.
     void scaleW(double scalefactor) {
-      _sumW *= scalefactor;
-      _sumW2 *= scalefactor*scalefactor;
+      if (scalefactor == 1.0) return;
+      const double n = static_cast<double>(_unitFills);
+      _unitFills = 0;
+      _numEntries += n;
+      _sumW = (_sumW + n)*scalefactor;
+      _sumW2 = (_sumW2 + n)*(scalefactor*scalefactor);
     }
 
     /// @}
@@ -105,23 +137,35 @@ namespace YODA {
 
     /// Number of entries (number of times @c fill was called, ignoring weights)
     double numEntries() const {
-      return _numEntries;
+      return static_cast<double>(_unitFills) + _numEntries;
     }
 
     /// Effective number of entries \f$ = (\sum w)^2 / \sum w^2 \f$
     double effNumEntries() const {
-      if (_sumW2 == 0) return 0;
-      return _sumW*_sumW / _sumW2;
+      const double sw2 = sumW2();
+      if (sw2 == 0) return 0;
+      const double sw = sumW();
+      return sw*sw / sw2;
     }
 
     /// The sum of weights
     double sumW() const {
-      return _sumW;
+      return static_cast<double>(_unitFills) + _sumW;
     }
 
     /// The sum of weights squared
     double sumW2() const {
-      return _sumW2;
+      return static_cast<double>(_unitFills) + _sumW2;
+    }
+
+    /// Whether all the fills have had unit weight and fraction
+    bool isUnweighted() const {
+      return _numEntries == 0 && _sumW == 0 && _sumW2 == 0;
+    }
+
+    /// Exact number of fills of unit weight and fraction
+    uint64_t numUnitFills() const {
+      return _unitFills;
     }
 
     /// @}
@@ -169,13 +213,16 @@ namespace YODA {
     /// @name Storage
     /// @{
 
-    /// Number of times fill() has been called on this object
+    /// Exact number of fills of unit weight and fraction
+    uint64_t _unitFills;
+
+    /// Number of all the other fills
     double _numEntries;
 
-    /// Sum of weights
+    /// Sum of the weights of all the other fills
     double _sumW;
 
-    /// Sum of squared weights
+    /// Sum of the squared weights of all the other fills
     double _sumW2;
 
     /// @}
@@ -76,6 +76,11 @@ namespace YODA {
     /// @brief Contribute a sample at @a val with weight @a weight.
     void fill(double val, double weight=1.0, double fraction=1.0) {
       _dbnW.fill(weight, fraction);
+      if (weight == 1.0 && fraction == 1.0) {
+        _sumWX += val;
+        _sumWX2 += val*val;
+        return;
+      }
       _sumWX += fraction*weight*val;
       _sumWX2 += fraction*weight*val*val;
     }
@@ -88,6 +93,13 @@ namespace YODA {
       _sumWX2 = 0;
     }
 
+    /// @brief Set the count of unit fills to @a n, keeping the other sums
+    ///
+    /// For storage which keeps the exact count itself, such as DbnColumns.
+    void setUnitFills(uint64_t n) {
+      _dbnW.setUnitFills(n);
+    }
+
 
     /// Rescale as if all fill weights had been different by factor @a scalefactor.
     void scaleW(double scalefactor) {
@@ -158,6 +170,16 @@ namespace YODA {
       return _dbnW.sumW2();
     }
 
+    /// Whether all the fills have had unit weight and fraction
+    bool isUnweighted() const {
+      return _dbnW.isUnweighted();
+    }
+
+    /// Exact number of fills of unit weight and fraction
+    uint64_t numUnitFills() const {
+      return _dbnW.numUnitFills();
+    }
+
     /// The sum of x*weight
     double sumWX() const {
       return _sumWX;
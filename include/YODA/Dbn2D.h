@@ -84,6 +84,15 @@ namespace YODA {
     }
 
 
+    /// @brief Set the count of unit fills to @a n, keeping the other sums
+    ///
+    /// For storage which keeps the exact count itself, such as DbnColumns.
+    void setUnitFills(uint64_t n) {
+      _dbnX.setUnitFills(n);
+      _dbnY.setUnitFills(n);
+    }
+
+
     /// Rescale as if all fill weights had been different by factor @a scalefactor.
     void scaleW(double scalefactor) {
       _dbnX.scaleW(scalefactor);
@@ -182,6 +191,16 @@ namespace YODA {
       return _dbnX.sumW2();
     }
 
+    /// Whether all the fills have had unit weight and fraction
+    bool isUnweighted() const {
+      return _dbnX.isUnweighted();
+    }
+
+    /// Exact number of fills of unit weight and fraction
+    uint64_t numUnitFills() const {
+      return _dbnX.numUnitFills();
+    }
+
     /// The sum of x*weight
     double sumWX() const {
       return _dbnX.sumWX();
@@ -0,0 +1,328 @@
+// -*- C++ -*-
+//
+// This file is part of YODA -- Yet more Objects for Data Analysis
+// Copyright (C) 2008-2021 The YODA collaboration (see AUTHORS for details)
+//
+#ifndef YODA_DbnColumns_h
+#define YODA_DbnColumns_h
+
+#include "YODA/DbnMoments.h"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace YODA {
+
+
+  /// @brief Structure-of-arrays storage of the distributions of a set of bins
+  ///
+  /// Each running sum of the distributions is held in its own contiguous
+  /// column, and the columns are laid out one after another. Whole-set
+  /// operations are then simple loops over plain arrays, which the compiler
+  /// vectorises: scaleW touches only the weighted sums, and addition and
+  /// subtraction are one pass each over the whole block. Every operation gives
+  /// results identical to the same operation on the distributions one by one.
+  ///
+  /// As in Dbn0D, the fills of unit weight and fraction are counted in an
+  /// exact integer, in a separate count column, and the numEntries, sumW and
+  /// sumW2 columns hold the sums of all the other fills. Rescaling folds the
+  /// counts into those columns, exactly as Dbn0D does.
+  template <typename DBN>
+  class DbnColumns {
+  public:
+
+    typedef DbnMoments<DBN> Moments;
+
+
+    /// @name Constructors and conversions
+    /// @{
+
+    /// Empty constructor
+    DbnColumns() : _n(0) { }
+
+    /// Constructor from the distributions of a vector of bins
+    template <typename BINS>
+    explicit DbnColumns(const BINS& bins) : _n(0) {
+      assign(bins);
+    }
+
+    /// Replace the contents with the distributions of a vector of bins
+    template <typename BINS>
+    void assign(const BINS& bins) {
+      _n = bins.size();
+      _data.assign(Moments::N*_n, 0.0);
+      _counts.assign(_n, 0);
+      for (size_t i = 0; i < _n; ++i) set(i, bins[i].dbn());
+    }
+
+    /// Replace distribution @a i
+    void set(size_t i, const DBN& d) {
+      DBN w = d;
+      _counts[i] = w.numUnitFills();
+      w.setUnitFills(0);
+      double m[Moments::N];
+      Moments::get(w, m);
+      for (size_t k = 0; k < Moments::N; ++k) _data[k*_n + i] = m[k];
+    }
+
+    /// Write the distributions back into a vector of bins of the same size
+    template <typename BINS>
+    void copyTo(BINS& bins) const {
+      for (size_t i = 0; i < _n; ++i) bins[i].dbn() = dbn(i);
+    }
+
+    /// Drop the contents
+    void clear() {
+      _n = 0;
+      std::vector<double>().swap(_data);
+      std::vector<uint64_t>().swap(_counts);
+    }
+
+    /// @}
+
+
+    /// @name Access
+    /// @{
+
+    /// Number of distributions
+    size_t size() const { return _n; }
+
+    /// Distribution @a i
+    DBN dbn(size_t i) const {
+      double m[Moments::N];
+      for (size_t k = 0; k < Moments::N; ++k) m[k] = _data[k*_n + i];
+      DBN rtn = Moments::make(m);
+      rtn.setUnitFills(rtn.numUnitFills() + _counts[i]);
+      return rtn;
+    }
+
+    /// @brief Column of moment @a k, as for DbnMoments
+    ///
+    /// The first three columns exclude the unit fills, which are in the count column.
+    const double* column(size_t k) const { return _data.data() + k*_n; }
+
+    /// @brief Sum of all the distributions
+    ///
+    /// Each column is summed in order, exactly as adding the distributions one by one.
+    DBN total() const {
+      double m[Moments::N];
+      for (size_t k = 0; k < Moments::N; ++k) {
+        const double* c = column(k);
+        double s = 0;
+        for (size_t i = 0; i < _n; ++i) s += c[i];
+        m[k] = s;
+      }
+      uint64_t count = 0;
+      for (size_t i = 0; i < _n; ++i) count += _counts[i];
+      DBN rtn = Moments::make(m);
+      rtn.setUnitFills(rtn.numUnitFills() + count);
+      return rtn;
+    }
+
+    /// @}
+
+
+    /// @name Modifiers
+    /// @{
+
+    /// Fill distribution @a i, with the unused trailing coordinates ignored
+    void fill(size_t i, double x, double y, double z, double weight, double fraction) {
+      double* c[Moments::N];
+      for (size_t k = 0; k < Moments::N; ++k) c[k] = _data.data() + k*_n;
+      if (weight == 1.0 && fraction == 1.0) {
+        const double n = c[0][i], sw = c[1][i], sw2 = c[2][i];
+        ++_counts[i];
+        Moments::fill(c, i, x, y, z, weight, fraction);
+        c[0][i] = n; c[1][i] = sw; c[2][i] = sw2;
+        return;
+      }
+      Moments::fill(c, i, x, y, z, weight, fraction);
+    }
+
+    /// Reset all the distributions
+    void reset() {
+      std::fill(_data.begin(), _data.end(), 0.0);
+      std::fill(_counts.begin(), _counts.end(), 0);
+    }
+
+    /// Rescale all the distributions as if all fill weights had been different by @a scalefactor
+    void scaleW(double scalefactor) {
+      if (scalefactor == 1.0) return;
+      const double sf2 = scalefactor*scalefactor;
+      double* d = _data.data();
+      for (size_t i = 0; i < _n; ++i) {
+        const double n = static_cast<double>(_counts[i]);
+        d[i] += n; d[_n + i] += n; d[2*_n + i] += n;
+      }
+      std::fill(_counts.begin(), _counts.end(), 0);
+      for (size_t j = _n; j < 2*_n; ++j) d[j] *= scalefactor;
+      for (size_t j = 2*_n; j < 3*_n; ++j) d[j] *= sf2;
+      for (size_t j = 3*_n; j < Moments::N*_n; ++j) d[j] *= scalefactor;
+    }
+
+    /// Add the distributions of another set of the same size
+    DbnColumns& operator += (const DbnColumns& other) {
+      for (size_t i = 0; i < _n; ++i) _counts[i] += other._counts[i];
+      double* d = _data.data();
+      const double* o = other._data.data();
+      for (size_t j = 0; j < Moments::N*_n; ++j) d[j] += o[j];
+      return *this;
+    }
+
+    /// @brief Subtract the distributions of another set of the same size
+    ///
+    /// As for the distributions themselves, the entry counts and sumW2 still add.
+    DbnColumns& operator -= (const DbnColumns& other) {
+      double* d = _data.data();
+      const double* o = other._data.data();
+      const uint64_t* oc = other._counts.data();
+      for (size_t i = 0; i < _n; ++i) {
+        const double on = static_cast<double>(oc[i]);
+        d[i] += on + o[i];
+        d[_n + i] -= on + o[_n + i];
+        d[2*_n + i] += on + o[2*_n + i];
+      }
+      for (size_t j = 3*_n; j < Moments::N*_n; ++j) d[j] -= o[j];
+      return *this;
+    }
+
+    /// @}
+
+
+  private:
+
+    /// Number of distributions
+    size_t _n;
+
+    /// The moment columns, one after another
+    std::vector<double> _data;
+
+    /// Exact numbers of unit fills of the distributions
+    std::vector<uint64_t> _counts;
+
+  };
+
+
+
+  /// @brief Storage of the distributions of a set of rows, each for several weight streams
+  ///
+  /// The rows are e.g. the bins and flows of a multi-weight histogram. Moment k
+  /// of row i is a contiguous block of one value per weight stream, so that a
+  /// fill of a row with a dense vector of stream weights is one vectorisable
+  /// loop per moment, with the same arithmetic as DBN::fill for each stream.
+  /// As in DbnColumns, the unit fills of each stream are counted in a
+  /// separate block of exact integers.
+  template <typename DBN>
+  class MultiDbns {
+  public:
+
+    typedef DbnMoments<DBN> Moments;
+
+
+    /// @name Constructors
+    /// @{
+
+    /// Empty constructor
+    MultiDbns() : _nrows(0), _nstreams(0) { }
+
+    /// Constructor of @a nrows empty distributions for each of @a nstreams weight streams
+    MultiDbns(size_t nrows, size_t nstreams)
+      : _nrows(nrows), _nstreams(nstreams),
+        _data(Moments::N*nrows*nstreams, 0.0),
+        _counts(nrows*nstreams, 0)
+    { }
+
+    /// @}
+
+
+    /// @name Access
+    /// @{
+
+    /// Number of rows
+    size_t numRows() const { return _nrows; }
+
+    /// Number of weight streams
+    size_t numStreams() const { return _nstreams; }
+
+    /// Distribution of row @a i for weight stream @a s
+    DBN dbn(size_t i, size_t s) const {
+      double m[Moments::N];
+      for (size_t k = 0; k < Moments::N; ++k) m[k] = _data[(k*_nrows + i)*_nstreams + s];
+      DBN rtn = Moments::make(m);
+      rtn.setUnitFills(rtn.numUnitFills() + _counts[i*_nstreams + s]);
+      return rtn;
+    }
+
+    /// Set the distribution of row @a i for weight stream @a s
+    void setDbn(size_t i, size_t s, const DBN& d) {
+      DBN w = d;
+      _counts[i*_nstreams + s] = w.numUnitFills();
+      w.setUnitFills(0);
+      double m[Moments::N];
+      Moments::get(w, m);
+      for (size_t k = 0; k < Moments::N; ++k) _data[(k*_nrows + i)*_nstreams + s] = m[k];
+    }
+
+    /// @}
+
+
+    /// @name Modifiers
+    /// @{
+
+    /// Fill row @a i once, with one weight per stream from @a weights
+    void fill(size_t i, double x, double y, double z, const double* weights, double fraction) {
+      double* c[Moments::N];
+      for (size_t k = 0; k < Moments::N; ++k) c[k] = _data.data() + (k*_nrows + i)*_nstreams;
+      Moments::fillStreams(c, _counts.data() + i*_nstreams, _nstreams, x, y, z, weights, fraction);
+    }
+
+    /// Reset all the distributions
+    void reset() {
+      std::fill(_data.begin(), _data.end(), 0.0);
+      std::fill(_counts.begin(), _counts.end(), 0);
+    }
+
+    /// Rescale weight stream @a s as if all its fill weights had been different by @a scalefactor
+    void scaleW(size_t s, double scalefactor) {
+      if (scalefactor == 1.0) return;
+      for (size_t i = 0; i < _nrows; ++i) {
+        uint64_t& count = _counts[i*_nstreams + s];
+        const double n = static_cast<double>(count);
+        for (size_t k = 0; k < 3; ++k) _data[(k*_nrows + i)*_nstreams + s] += n;
+        count = 0;
+      }
+      for (size_t k = 1; k < Moments::N; ++k) {
+        const double sf = (k == 2) ? scalefactor*scalefactor : scalefactor;
+        for (size_t i = 0; i < _nrows; ++i) _data[(k*_nrows + i)*_nstreams + s] *= sf;
+      }
+    }
+
+    /// Add the distributions of another set of the same shape
+    MultiDbns& operator += (const MultiDbns& other) {
+      double* d = _data.data();
+      const double* o = other._data.data();
+      for (size_t j = 0; j < _data.size(); ++j) d[j] += o[j];
+      for (size_t j = 0; j < _counts.size(); ++j) _counts[j] += other._counts[j];
+      return *this;
+    }
+
+    /// @}
+
+
+  private:
+
+    /// Number of rows and weight streams
+    size_t _nrows, _nstreams;
+
+    /// The moment blocks, by moment, then row, then stream
+    std::vector<double> _data;
+
+    /// Exact numbers of unit fills, by row, then stream
+    std::vector<uint64_t> _counts;
+
+  };
+
+
+}
+
+#endif
@@ -0,0 +1,163 @@
+// -*- C++ -*-
+//
+// This file is part of YODA -- Yet more Objects for Data Analysis
+// Copyright (C) 2008-2021 The YODA collaboration (see AUTHORS for details)
+//
+#ifndef YODA_DbnMoments_h
+#define YODA_DbnMoments_h
+
+#include "YODA/Dbn0D.h"
+#include "YODA/Dbn1D.h"
+#include "YODA/Dbn2D.h"
+#include "YODA/Dbn3D.h"
+
+namespace YODA {
+
+
+  /// @brief Layout of the running sums of a distribution type, for columnar storage
+  ///
+  /// The N moments are in the order of the type's raw-sums constructor, i.e.
+  /// numEntries, sumW and sumW2 first, then the coordinate moments. fill()
+  /// updates moment columns @a c at row @a i with the same arithmetic as the
+  /// type's own fill(), with the unused trailing coordinates ignored, and
+  /// the overload taking a distribution fills it through its own fill(), so
+  /// that code generic in the distribution type can fill at (x, y, z).
+  /// fillStreams() does the same for one fill at @a n weights, with column
+  /// @a c[k] holding moment k of each weight stream, in loops over the
+  /// streams, and with @a u holding the unit-fill count of each stream, as in Dbn0D.
+  template <typename DBN>
+  struct DbnMoments;
+
+
+  /// @brief Moment layout of Dbn0D, the counts-only set
+  ///
+  /// The moments are plain floating-point sums: DbnColumns and MultiDbns keep
+  /// the exact unit-fill count of Dbn0D in a column of its own.
+  template <>
+  struct DbnMoments<Dbn0D> {
+    static const size_t N = 3;
+    static void get(const Dbn0D& d, double* m) {
+      m[0] = d.numEntries(); m[1] = d.sumW(); m[2] = d.sumW2();
+    }
+    static Dbn0D make(const double* m) {
+      return Dbn0D(m[0], m[1], m[2]);
+    }
+    static void fill(Dbn0D& d, double, double, double, double w, double f) {
+      d.fill(w, f);
+    }
+    static void fill(double* const* c, size_t i, double, double, double, double w, double f) {
+      c[0][i] += f; c[1][i] += f*w; c[2][i] += f*w*w;
+    }
+    static void fillStreams(double* const* c, uint64_t* u, size_t n, double, double, double, const double* w, double f) {
+      double* c0 = c[0], * c1 = c[1], * c2 = c[2];
+      for (size_t s = 0; s < n; ++s) {
+        const bool unit = (w[s] == 1.0 && f == 1.0);
+        const double fs = unit ? 0.0 : f;
+        u[s] += unit;
+        c0[s] += fs;
+        c1[s] += fs*w[s];
+        c2[s] += fs*w[s]*w[s];
+      }
+    }
+  };
+
+
+  /// Moment layout of Dbn1D
+  template <>
+  struct DbnMoments<Dbn1D> {
+    static const size_t N = 5;
+    static void get(const Dbn1D& d, double* m) {
+      m[0] = d.numEntries(); m[1] = d.sumW(); m[2] = d.sumW2();
+      m[3] = d.sumWX(); m[4] = d.sumWX2();
+    }
+    static Dbn1D make(const double* m) {
+      return Dbn1D(m[0], m[1], m[2], m[3], m[4]);
+    }
+    static void fill(Dbn1D& d, double x, double, double, double w, double f) {
+      d.fill(x, w, f);
+    }
+    static void fill(double* const* c, size_t i, double x, double, double, double w, double f) {
+      c[0][i] += f; c[1][i] += f*w; c[2][i] += f*w*w;
+      c[3][i] += f*w*x; c[4][i] += f*w*x*x;
+    }
+    static void fillStreams(double* const* c, uint64_t* u, size_t n, double x, double y, double z, const double* w, double f) {
+      DbnMoments<Dbn0D>::fillStreams(c, u, n, x, y, z, w, f);
+      double* c3 = c[3], * c4 = c[4];
+      for (size_t s = 0; s < n; ++s) c3[s] += f*w[s]*x;
+      for (size_t s = 0; s < n; ++s) c4[s] += f*w[s]*x*x;
+    }
+  };
+
+
+  /// Moment layout of Dbn2D
+  template <>
+  struct DbnMoments<Dbn2D> {
+    static const size_t N = 8;
+    static void get(const Dbn2D& d, double* m) {
+      m[0] = d.numEntries(); m[1] = d.sumW(); m[2] = d.sumW2();
+      m[3] = d.sumWX(); m[4] = d.sumWX2(); m[5] = d.sumWY(); m[6] = d.sumWY2();
+      m[7] = d.sumWXY();
+    }
+    static Dbn2D make(const double* m) {
+      return Dbn2D(m[0], m[1], m[2], m[3], m[4], m[5], m[6], m[7]);
+    }
+    static void fill(Dbn2D& d, double x, double y, double, double w, double f) {
+      d.fill(x, y, w, f);
+    }
+    static void fill(double* const* c, size_t i, double x, double y, double, double w, double f) {
+      c[0][i] += f; c[1][i] += f*w; c[2][i] += f*w*w;
+      c[3][i] += f*w*x; c[4][i] += f*w*x*x;
+      c[5][i] += f*w*y; c[6][i] += f*w*y*y;
+      c[7][i] += f*w*x*y;
+    }
+    static void fillStreams(double* const* c, uint64_t* u, size_t n, double x, double y, double z, const double* w, double f) {
+      DbnMoments<Dbn1D>::fillStreams(c, u, n, x, y, z, w, f);
+      double* c5 = c[5], * c6 = c[6], * c7 = c[7];
+      for (size_t s = 0; s < n; ++s) c5[s] += f*w[s]*y;
+      for (size_t s = 0; s < n; ++s) c6[s] += f*w[s]*y*y;
+      for (size_t s = 0; s < n; ++s) c7[s] += f*w[s]*x*y;
+    }
+  };
+
+
+  /// Moment layout of Dbn3D
+  template <>
+  struct DbnMoments<Dbn3D> {
+    static const size_t N = 12;
+    static void get(const Dbn3D& d, double* m) {
+      m[0] = d.numEntries(); m[1] = d.sumW(); m[2] = d.sumW2();
+      m[3] = d.sumWX(); m[4] = d.sumWX2(); m[5] = d.sumWY(); m[6] = d.sumWY2();
+      m[7] = d.sumWZ(); m[8] = d.sumWZ2();
+      m[9] = d.sumWXY(); m[10] = d.sumWXZ(); m[11] = d.sumWYZ();
+    }
+    static Dbn3D make(const double* m) {
+      return Dbn3D(m[0], m[1], m[2], m[3], m[4], m[5], m[6], m[7], m[8], m[9], m[10], m[11]);
+    }
+    static void fill(Dbn3D& d, double x, double y, double z, double w, double f) {
+      d.fill(x, y, z, w, f);
+    }
+    static void fill(double* const* c, size_t i, double x, double y, double z, double w, double f) {
+      c[0][i] += f; c[1][i] += f*w; c[2][i] += f*w*w;
+      c[3][i] += f*w*x; c[4][i] += f*w*x*x;
+      c[5][i] += f*w*y; c[6][i] += f*w*y*y;
+      c[7][i] += f*w*z; c[8][i] += f*w*z*z;
+      c[9][i] += f*w*x*y; c[10][i] += f*w*x*z; c[11][i] += f*w*y*z;
+    }
+    static void fillStreams(double* const* c, uint64_t* u, size_t n, double x, double y, double z, const double* w, double f) {
+      DbnMoments<Dbn1D>::fillStreams(c, u, n, x, y, z, w, f);
+      double* c5 = c[5], * c6 = c[6], * c7 = c[7], * c8 = c[8];
+      for (size_t s = 0; s < n; ++s) c5[s] += f*w[s]*y;
+      for (size_t s = 0; s < n; ++s) c6[s] += f*w[s]*y*y;
+      for (size_t s = 0; s < n; ++s) c7[s] += f*w[s]*z;
+      for (size_t s = 0; s < n; ++s) c8[s] += f*w[s]*z*z;
+      double* c9 = c[9], * c10 = c[10], * c11 = c[11];
+      for (size_t s = 0; s < n; ++s) c9[s] += f*w[s]*x*y;
+      for (size_t s = 0; s < n; ++s) c10[s] += f*w[s]*x*z;
+      for (size_t s = 0; s < n; ++s) c11[s] += f*w[s]*y*z;
+    }
+  };
+
+
+}
+
+#endif
@@ -12,6 +12,16 @@
 namespace YODA {
 
 
+  /// Number of entries whose bin indices are looked up together in batched fills
+  const size_t FILLMANY_CHUNK = 512;
+
+  /// @brief Treatment of fills with NaN coordinates or which fall into bin gaps
+  ///
+  /// FILL_THROW raises a RangeError, FILL_COUNT records the fill weight in a
+  /// dedicated Dbn0D, and FILL_IGNORE silently drops the fill.
+  enum FillPolicy { FILL_THROW, FILL_COUNT, FILL_IGNORE };
+
+
   /// A base class for all fillable objects
   class Fillable {
   public:
@@ -55,6 +65,17 @@ namespace YODA {
 
     //@}
 
+
+  protected:
+
+    /// Check that optional weight and fraction arrays match the number of batched fill entries
+    void _checkFillSizes(size_t n, size_t nweights, size_t nfractions) const {
+      if (nweights != 0 && nweights != n)
+        throw UserError("Weight array size does not match the number of fill entries");
+      if (nfractions != 0 && nfractions != n)
+        throw UserError("Fraction array size does not match the number of fill entries");
+    }
+
   };
 
 
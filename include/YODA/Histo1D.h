@@ -55,6 +55,20 @@ namespace YODA {
     { }
 
 
+    /// @brief Constructor giving the number of bins, whose range is chosen from the first fills
+    ///
+    /// The first @a nbuffer fills are held back, and the bin edges are chosen
+    /// from them according to @a mode, as by autospace, when the buffer is full
+    /// or autoBook() is called. Until then the histogram has no bins and reads
+    /// as unfilled. Later fills outside the chosen range go to the under- and
+    /// overflows.
+    Histo1D(size_t nbins, AutoBinning mode, size_t nbuffer=AUTOBIN_BUFFER_SIZE,
+            const std::string& path="", const std::string& title="")
+      : AnalysisObject("Histo1D", path, title),
+        _axis(nbins, mode, nbuffer)
+    { }
+
+
     /// @brief Constructor giving explicit bin edges.
     ///
     /// For n bins, binedges.size() == n+1, the last one being the upper bound
@@ -142,6 +156,24 @@ namespace YODA {
     /// Fill histo by value and weight, optionally as a fractional fill
     virtual void fill(double x, double weight=1.0, double fraction=1.0);
 
+    /// @brief Fill histo from arrays of @a n values, weights and fractions
+    ///
+    /// Equivalent to, and bitwise-identical with, a loop of fill() calls, but
+    /// with all the bin lookups done in one pass. Null @a weights or @a
+    /// fractions pointers are treated as all-1.
+    virtual void fillMany(size_t n, const double* xs,
+                          const double* weights=nullptr, const double* fractions=nullptr);
+
+    /// Fill histo from vectors of values, weights and fractions (the last two may be empty)
+    void fillMany(const std::vector<double>& xs,
+                  const std::vector<double>& weights=std::vector<double>(),
+                  const std::vector<double>& fractions=std::vector<double>()) {
+      _checkFillSizes(xs.size(), weights.size(), fractions.size());
+      fillMany(xs.size(), xs.data(),
+               weights.empty() ? nullptr : weights.data(),
+               fractions.empty() ? nullptr : fractions.data());
+    }
+
     /// Fill histo bin i with the given weight, optionally as a fractional fill
     virtual void fillBin(size_t i, double weight=1.0, double fraction=1.0);
 
@@ -193,6 +225,57 @@ namespace YODA {
     /// @}
 
 
+    /// @name NaN and bin-gap fill handling
+    /// @{
+
+    /// Policy for fills with a NaN coordinate (default FILL_THROW)
+    FillPolicy nanPolicy() const { return _axis.nanPolicy(); }
+    /// Set the policy for fills with a NaN coordinate
+    void setNanPolicy(FillPolicy policy) { _axis.setNanPolicy(policy); }
+
+    /// Policy for in-range fills which fall into a bin gap (default FILL_IGNORE)
+    FillPolicy gapPolicy() const { return _axis.gapPolicy(); }
+    /// Set the policy for in-range fills which fall into a bin gap
+    void setGapPolicy(FillPolicy policy) { _axis.setGapPolicy(policy); }
+
+    /// Weights of the NaN fills recorded under the FILL_COUNT policy
+    const Dbn0D& nanDbn() const { return _axis.nanDbn(); }
+
+    /// Weights of the bin-gap fills recorded under the FILL_COUNT policy
+    const Dbn0D& gapDbn() const { return _axis.gapDbn(); }
+
+    /// @}
+
+
+    /// @name Auto-binning
+    /// @{
+
+    /// Whether the bins of an auto-binned histogram are still to be chosen from its fills
+    bool autoBinPending() const { return _axis.autoBinPending(); }
+
+    /// @brief Choose the bins of an auto-binned histogram from its fills so far
+    ///
+    /// Call this before reading or writing a histogram whose buffer may not be full.
+    void autoBook() { _axis.autoBook(); }
+
+    /// @}
+
+
+    /// @name Columnar storage
+    /// @{
+
+    /// @brief Hold the bin contents as one array per running sum, for fast whole-histo operations
+    ///
+    /// Fills, scaleW, +=, -= and reset then work on the arrays, and the bins are
+    /// kept current as they go. See Axis1D::setColumnar for details.
+    void setColumnar(bool columnar=true) { _axis.setColumnar(columnar); }
+
+    /// Whether the bin contents are held in columnar form
+    bool columnar() const { return _axis.columnar(); }
+
+    /// @}
+
+
     /// @name Bin accessors
     /// @{
 
@@ -232,7 +315,7 @@ namespace YODA {
 
 
     /// Access a bin by index (non-const version)
-    HistoBin1D& bin(size_t index) { return _axis.bins()[index]; }
+    HistoBin1D& bin(size_t index) { return _axis.bin(index); }
     /// Access a bin by index (const version)
     const HistoBin1D& bin(size_t index) const { return _axis.bins()[index]; }
 
@@ -7,52 +7,68 @@
 #define YODA_HistoBin1D_h
 
 #include "YODA/Bin1D.h"
+#include "YODA/Dbn0D.h"
 #include "YODA/Dbn1D.h"
+#include "YODA/DbnMoments.h"
 #include "YODA/Exceptions.h"
 
 namespace YODA {
 
 
+  /// @brief Bins without x moments have their focus at the midpoint
+  ///
+  /// The x statistics xMean, xVariance etc. are not available for them at all.
+  template <>
+  inline double Bin1D<Dbn0D>::xFocus() const {
+    return xMid();
+  }
+
+
   /// @brief A Bin1D specialised for handling histogram-type information
   ///
   /// This is a 1D bin type, which supports all the operations defined for
   /// a generic Bin1D object, but also supplies the specific member functions
   /// for histogram-type data, as opposed to profile-type.
-  class HistoBin1D : public Bin1D<Dbn1D> {
+  ///
+  /// The distribution type @a DBN sets which moments of the fills are kept:
+  /// Dbn1D for HistoBin1D, or Dbn0D for CountBin1D, which records only the
+  /// counts and not the fill positions.
+  template <typename DBN>
+  class HistoBin1DT : public Bin1D<DBN> {
   public:
 
     /// @name Constructor giving bin low and high edges.
     /// @{
 
     /// Make a new, empty bin with a pair of edges.
-    HistoBin1D(double lowedge, double highedge)
-      : Bin1D<Dbn1D>(std::make_pair(lowedge, highedge))
+    HistoBin1DT(double lowedge, double highedge)
+      : Bin1D<DBN>(std::make_pair(lowedge, highedge))
     { }
 
 
     /// Make a new, empty bin with a pair of edges.
-    HistoBin1D(const std::pair<double,double>& edges)
-      : Bin1D<Dbn1D>(edges)
+    HistoBin1DT(const std::pair<double,double>& edges)
+      : Bin1D<DBN>(edges)
     { }
 
 
     /// @brief Make a bin with all the components of a fill history.
     ///
     /// Mainly intended for internal persistency use.
-    HistoBin1D(std::pair<double, double> edges, const Dbn1D& dbnx)
-      : Bin1D<Dbn1D>(edges, dbnx)
+    HistoBin1DT(std::pair<double, double> edges, const DBN& dbnx)
+      : Bin1D<DBN>(edges, dbnx)
     { }
 
 
     /// Copy constructor
-    HistoBin1D(const HistoBin1D& hb)
-      : Bin1D<Dbn1D>(hb)
+    HistoBin1DT(const HistoBin1DT& hb)
+      : Bin1D<DBN>(hb)
     { }
 
 
     /// Copy assignment
-    HistoBin1D& operator = (const HistoBin1D& hb) {
-      Bin1D<Dbn1D>::operator=(hb);
+    HistoBin1DT& operator = (const HistoBin1DT& hb) {
+      Bin1D<DBN>::operator=(hb);
       return *this;
     }
 
@@ -64,18 +80,18 @@ namespace YODA {
     /// @name Modifiers
     /// @{
 
-    /// Fill this bin with weight @a weight at position @a x.
+    /// Fill this bin with weight @a weight at position @a x, which a Dbn0D does not record.
     ///
     /// @note This should not be used, since it breaks histogram consistency. It will be removed in a future version.
     void fill(double x, double weight=1.0, double fraction=1.0) {
-      _dbn.fill(x, weight, fraction);
+      DbnMoments<DBN>::fill(this->_dbn, x, 0, 0, weight, fraction);
     }
 
     /// Fill this bin with weight @a weight.
     ///
     /// @note This should not be used, since it breaks histogram consistency. It will be removed in a future version.
     void fillBin(double weight=1.0, double fraction=1.0) {
-      fill(xMid(), weight, fraction);
+      fill(this->xMid(), weight, fraction);
     }
 
     /// @}
@@ -89,12 +105,12 @@ namespace YODA {
     /// The area is the sum of weights in the bin, i.e. the
     /// width of the bin has no influence on this figure.
     double area() const {
-      return sumW();
+      return this->sumW();
     }
 
     /// The height is defined as area/width.
     double height() const {
-      return area() / xWidth();
+      return area() / this->xWidth();
     }
 
     /// @}
@@ -106,19 +122,19 @@ namespace YODA {
     /// Error computed using binomial statistics on the sum of bin weights,
     /// i.e. err_area = sqrt{sum{weights}}
     double areaErr() const {
-      return sqrt(sumW2());
+      return sqrt(this->sumW2());
     }
 
     /// As for the height vs. area, the height error includes a scaling factor
     /// of the bin width, i.e. err_height = sqrt{sum{weights}} / width.
     double heightErr() const {
-      return areaErr() / xWidth();
+      return areaErr() / this->xWidth();
     }
 
     /// The relative size of the error (same for either area or height errors)
     double relErr() const {
       /// @todo Throw excp if sumW2 is 0?
-      return sumW2() != 0 ? sqrt(sumW2()) / sumW() : 0;
+      return this->sumW2() != 0 ? sqrt(this->sumW2()) / this->sumW() : 0;
     }
 
     /// @}
@@ -127,12 +143,12 @@ namespace YODA {
   public:
 
     /// Add two bins (for use by Histo1D).
-    HistoBin1D& operator += (const HistoBin1D& toAdd) {
+    HistoBin1DT& operator += (const HistoBin1DT& toAdd) {
       return add(toAdd);
     }
 
     /// Subtract two bins
-    HistoBin1D& operator -= (const HistoBin1D& toSubtract) {
+    HistoBin1DT& operator -= (const HistoBin1DT& toSubtract) {
       return subtract(toSubtract);
     }
 
@@ -140,20 +156,51 @@ namespace YODA {
   protected:
 
     /// Add two bins (internal, explicitly named version)
-    HistoBin1D& add(const HistoBin1D& hb) {
-      Bin1D<Dbn1D>::add(hb);
+    HistoBin1DT& add(const HistoBin1DT& hb) {
+      Bin1D<DBN>::add(hb);
       return *this;
     }
 
     /// Subtract one bin from another (internal, explicitly named version)
-    HistoBin1D& subtract(const HistoBin1D& hb) {
-      Bin1D<Dbn1D>::subtract(hb);
+    HistoBin1DT& subtract(const HistoBin1DT& hb) {
+      Bin1D<DBN>::subtract(hb);
       return *this;
     }
 
   };
 
 
+  /// @brief A histogram bin with full x moments
+  ///
+  /// The HistoBin1DT instance filled by Histo1D.
+  class HistoBin1D : public HistoBin1DT<Dbn1D> {
+  public:
+
+    /// Make a new, empty bin with a pair of edges.
+    HistoBin1D(double lowedge, double highedge)
+      : HistoBin1DT<Dbn1D>(lowedge, highedge)
+    { }
+
+    /// Make a new, empty bin with a pair of edges.
+    HistoBin1D(const std::pair<double,double>& edges)
+      : HistoBin1DT<Dbn1D>(edges)
+    { }
+
+    /// @brief Make a bin with all the components of a fill history.
+    ///
+    /// Mainly intended for internal persistency use.
+    HistoBin1D(std::pair<double, double> edges, const Dbn1D& dbnx)
+      : HistoBin1DT<Dbn1D>(edges, dbnx)
+    { }
+
+    /// Copy constructor, also from the bin template
+    HistoBin1D(const HistoBin1DT<Dbn1D>& hb)
+      : HistoBin1DT<Dbn1D>(hb)
+    { }
+
+  };
+
+
   /// Add two bins
   inline HistoBin1D operator + (const HistoBin1D& a, const HistoBin1D& b) {
     HistoBin1D rtn(a);
@@ -7,50 +7,72 @@
 #define YODA_HistoBin2D_h
 
 #include "YODA/Bin2D.h"
+#include "YODA/Dbn0D.h"
 #include "YODA/Dbn2D.h"
+#include "YODA/DbnMoments.h"
 #include "YODA/Exceptions.h"
 
 namespace YODA {
 
 
+  /// @brief Bins without x moments have their x focus at the midpoint
+  ///
+  /// The x and y statistics xMean, yVariance etc. are not available for them at all.
+  template <>
+  inline double Bin2D<Dbn0D>::xFocus() const {
+    return xMid();
+  }
+
+  /// Bins without y moments have their y focus at the midpoint
+  template <>
+  inline double Bin2D<Dbn0D>::yFocus() const {
+    return yMid();
+  }
+
+
   /// @brief A Bin2D specialised for handling histogram-type information
   ///
   /// This is a 2D bin type, which supports all the operations defined for
   /// a generic Bin2D object, but also supplies the specific member functions
   /// for histogram-type data, as opposed to profile-type.
-  class HistoBin2D : public Bin2D<Dbn2D> {
+  ///
+  /// The distribution type @a DBN sets which moments of the fills are kept:
+  /// Dbn2D for HistoBin2D, or Dbn0D for CountBin2D, which records only the
+  /// counts and not the fill positions.
+  template <typename DBN>
+  class HistoBin2DT : public Bin2D<DBN> {
   public:
 
     /// @name Constructors
     /// @{
 
     /// Make a new, empty bin with two pairs of edges.
-    HistoBin2D(double xmin, double xmax, double ymin, double ymax)
-      : Bin2D<Dbn2D>(std::make_pair(xmin, xmax), std::make_pair(ymin, ymax))
+    HistoBin2DT(double xmin, double xmax, double ymin, double ymax)
+      : Bin2D<DBN>(std::make_pair(xmin, xmax), std::make_pair(ymin, ymax))
     { }
 
     /// Constructor accepting a set of all edges of a bin
-    HistoBin2D(const std::pair<double,double>& xedges,
-               const std::pair<double,double>& yedges)
-      : Bin2D<Dbn2D>(xedges, yedges)
+    HistoBin2DT(const std::pair<double,double>& xedges,
+                const std::pair<double,double>& yedges)
+      : Bin2D<DBN>(xedges, yedges)
     { }
 
     /// @brief Make a bin with all the components of a fill history.
     ///
     /// Mainly intended for internal persistency use.
-    HistoBin2D(const std::pair<double, double>& xedges,
-               const std::pair<double, double>& yedges, const Dbn2D& dbn)
-      : Bin2D<Dbn2D>(xedges, yedges, dbn)
+    HistoBin2DT(const std::pair<double, double>& xedges,
+                const std::pair<double, double>& yedges, const DBN& dbn)
+      : Bin2D<DBN>(xedges, yedges, dbn)
     { }
 
     /// Copy constructor
-    HistoBin2D(const HistoBin2D& pb)
-      : Bin2D<Dbn2D>(pb)
+    HistoBin2DT(const HistoBin2DT& pb)
+      : Bin2D<DBN>(pb)
     { }
 
     /// Copy assignment
-    HistoBin2D& operator = (const HistoBin2D& hb) {
-      Bin2D<Dbn2D>::operator=(hb);
+    HistoBin2DT& operator = (const HistoBin2DT& hb) {
+      Bin2D<DBN>::operator=(hb);
       return *this;
     }
 
@@ -60,11 +82,11 @@ namespace YODA {
     /// @name Modifiers
     /// @{
 
-    /// A fill() function accepting coordinates as separate numbers
+    /// A fill() function accepting coordinates as separate numbers, which a Dbn0D does not record
     ///
     /// @note This should not be used, since it breaks histogram consistency. It will be removed in a future version.
     void fill(double x, double y, double weight=1.0, double fraction=1.0) {
-      _dbn.fill(x, y, weight, fraction);
+      DbnMoments<DBN>::fill(this->_dbn, x, y, 0, weight, fraction);
     }
 
     /// A fill() function accepting the coordinates as std::pair
@@ -78,12 +100,12 @@ namespace YODA {
     ///
     /// @note This should not be used, since it breaks histogram consistency. It will be removed in a future version.
     void fillBin(double weight=1.0, double fraction=1.0) {
-      fill(xyMid(), weight, fraction);
+      fill(this->xyMid(), weight, fraction);
     }
 
     /// A reset function
     void reset() {
-      Bin2D<Dbn2D>::reset();
+      Bin2D<DBN>::reset();
     }
 
     /// @}
@@ -94,27 +116,27 @@ namespace YODA {
 
     /// The volume of a bin
     double volume() const {
-      return sumW();
+      return this->sumW();
     }
 
     /// Error on volume
     double volumeErr() const {
-      return sqrt(sumW2());
+      return sqrt(this->sumW2());
     }
 
     /// The height of a bin
     double height() const {
-      return volume()/(xWidth()*yWidth());
+      return volume()/(this->xWidth()*this->yWidth());
     }
 
     /// Error on height
     double heightErr() const {
-      return volumeErr()/(xWidth()*yWidth());
+      return volumeErr()/(this->xWidth()*this->yWidth());
     }
 
     /// The relative size of the error (same for either volume or height errors)
     double relErr() const {
-      return sumW2() != 0 ? sqrt(sumW2()) / sumW() : 0;
+      return this->sumW2() != 0 ? sqrt(this->sumW2()) / this->sumW() : 0;
     }
 
     /// @}
@@ -144,6 +166,39 @@ namespace YODA {
   };
 
 
+  /// @brief A histogram bin with full x and y moments
+  ///
+  /// The HistoBin2DT instance filled by Histo2D.
+  class HistoBin2D : public HistoBin2DT<Dbn2D> {
+  public:
+
+    /// Make a new, empty bin with two pairs of edges.
+    HistoBin2D(double xmin, double xmax, double ymin, double ymax)
+      : HistoBin2DT<Dbn2D>(xmin, xmax, ymin, ymax)
+    { }
+
+    /// Constructor accepting a set of all edges of a bin
+    HistoBin2D(const std::pair<double,double>& xedges,
+               const std::pair<double,double>& yedges)
+      : HistoBin2DT<Dbn2D>(xedges, yedges)
+    { }
+
+    /// @brief Make a bin with all the components of a fill history.
+    ///
+    /// Mainly intended for internal persistency use.
+    HistoBin2D(const std::pair<double, double>& xedges,
+               const std::pair<double, double>& yedges, const Dbn2D& dbn)
+      : HistoBin2DT<Dbn2D>(xedges, yedges, dbn)
+    { }
+
+    /// Copy constructor, also from the bin template
+    HistoBin2D(const HistoBin2DT<Dbn2D>& hb)
+      : HistoBin2DT<Dbn2D>(hb)
+    { }
+
+  };
+
+
   /// Bin addition operator
   inline HistoBin2D operator + (const HistoBin2D& a, const HistoBin2D& b) {
     HistoBin2D rtn(a);
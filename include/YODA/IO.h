@@ -100,6 +100,19 @@ namespace YODA {
     return rtn;
   }
 
+  /// @brief Read only the objects from file @a filename whose paths are selected by regexes
+  ///
+  /// If @a patterns is non-empty, only objects whose path matches at least
+  /// one of them are read, and those whose path matches any of @a unpatterns
+  /// are not: see Reader::read. Readers which support it parse the input on
+  /// @a nthreads threads, or one per hardware thread if it is zero.
+  inline void read(const std::string& filename, std::vector<AnalysisObject*>& aos,
+                   const std::vector<std::string>& patterns, const std::vector<std::string>& unpatterns,
+                   size_t nthreads=1) {
+    Reader& r = mkReader(filename);
+    r.read(filename, aos, patterns, unpatterns, nthreads);
+  }
+
   /// @brief Make index of a file.
   inline Index mkIndex(const std::string& filename) {
     Reader& r = mkReader(filename);
@@ -134,6 +147,14 @@ namespace YODA {
     return rtn;
   }
 
+  /// @brief Read only the objects from stream @a is, in format @a fmt, whose paths are selected by regexes
+  inline void read(std::istream& is, std::vector<AnalysisObject*>& aos, const std::string& fmt,
+                   const std::vector<std::string>& patterns, const std::vector<std::string>& unpatterns,
+                   size_t nthreads=1) {
+    Reader& r = mkReader(fmt);
+    r.read(is, aos, patterns, unpatterns, nthreads);
+  }
+
   /// @}
 
 
@@ -25,21 +25,38 @@ namespace YODA {
     using AOIndex =
       std::unordered_map<std::string, std::unordered_map<std::string, int>>;
 
+    /// @brief Position of an object's BEGIN..END block in an uncompressed file
+    struct Extent {
+      size_t offset; ///< Byte offset of the start of the BEGIN line
+      size_t length; ///< Length in bytes, up to and including the END line's line ending
+    };
+
+    /// @brief Alias for the map of object paths to block positions.
+    using ExtentIndex = std::unordered_map<std::string, Extent>;
+
     Index() = default;
 
     Index(AOIndex&& idx) noexcept : _index(idx) {}
 
     Index(const AOIndex& idx) : _index(idx) {}
 
-    Index(Index&& other) : _index(std::move(other._index)) {}
+    Index(const AOIndex& idx, const ExtentIndex& extents)
+      : _index(idx), _extents(extents) {}
+
+    Index(const Index& other) = default;
+
+    Index(Index&& other)
+      : _index(std::move(other._index)), _extents(std::move(other._extents)) {}
 
     Index& operator=(const Index& rhs) {
       _index = rhs._index;
+      _extents = rhs._extents;
       return *this;
     }
 
     Index& operator=(Index&& rhs) {
       _index = std::move(rhs._index);
+      _extents = std::move(rhs._extents);
       return *this;
     }
 
@@ -49,6 +66,15 @@ namespace YODA {
     ///@brief Get nested index map.
     AOIndex getAOIndex() const { return _index; }
 
+    /// @brief Get the block positions, by path.
+    ///
+    /// Only indexes of uncompressed files have positions, and only for
+    /// the first block with each path.
+    const ExtentIndex& getExtents() const { return _extents; }
+
+    /// @brief Whether the block positions are known.
+    bool hasExtents() const { return !_extents.empty(); }
+
     /// @brief Get string representation of index.
     std::string toString() const {
       std::ostringstream indexStr;
@@ -70,6 +96,9 @@ namespace YODA {
   private:
     /// @brief Holds index.
     AOIndex _index;
+
+    /// @brief Holds block positions.
+    ExtentIndex _extents;
   };
 
 }
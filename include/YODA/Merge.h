@@ -0,0 +1,128 @@
+// -*- C++ -*-
+//
+// This file is part of YODA -- Yet more Objects for Data Analysis
+// Copyright (C) 2008-2021 The YODA collaboration (see AUTHORS for details)
+//
+#ifndef YODA_Merge_h
+#define YODA_Merge_h
+
+#include "YODA/AnalysisObject.h"
+#include <vector>
+#include <string>
+#include <unordered_map>
+
+namespace YODA {
+
+
+  /// @name Merging of statistically independent runs
+  /// @{
+
+  /// @brief Merge collections of analysis objects, e.g. the outputs of parallel jobs
+  ///
+  /// Objects are grouped by path, and within each group only those of the
+  /// type of the first occurrence take part: others are skipped. The groups
+  /// are combined with the rules of the yodamerge script:
+  ///
+  ///  - Counters, histograms and profiles with a non-zero ScaledBy annotation
+  ///    are taken to be normalised: their scaling is undone before they are
+  ///    added, and the sum is scaled by the inverse of the sum of the undone
+  ///    factors, i.e. to the weighted average of the input normalisations;
+  ///  - scatters cannot really be merged, so their values are averaged, with
+  ///    the errors of each source added in quadrature and then averaged;
+  ///  - the first copy of any other type is returned unchanged.
+  ///
+  /// Each group is reduced as a pairwise tree, with all the pairs at each
+  /// level of every group shared out over @a nthreads threads, or one per
+  /// hardware thread if it is zero. The pairing is fixed, so the result does
+  /// not depend on the number of threads.
+  ///
+  /// The inputs are not modified. The merged objects are new heap objects,
+  /// owned by the caller, in the order of the first appearance of their paths.
+  std::vector<AnalysisObject*> merge(const std::vector< std::vector<AnalysisObject*> >& aoss, size_t nthreads=0);
+
+
+  /// @brief Incremental merging, keeping only one accumulator per path
+  ///
+  /// Objects are merged one at a time with the same rules as merge(), in the
+  /// order they are added, so each input can be released as soon as it has
+  /// been merged.
+  class Merger {
+  public:
+
+    /// Default constructor
+    Merger() { }
+
+    /// Destructor, deleting any merged objects not yet taken by result()
+    ~Merger() { reset(); }
+
+    /// Merge object @a ao into the accumulator for its path, taking ownership of it
+    ///
+    /// Returns false if it was skipped, because its type differs from that of
+    /// the first object with its path or because that type cannot be merged.
+    bool add(AnalysisObject* ao);
+
+    /// Merge a copy of object @a ao, leaving the original untouched
+    bool add(const AnalysisObject& ao) { return add(ao.newclone()); }
+
+    /// @brief Merge copies of the objects @a aos, e.g. those read from one file
+    ///
+    /// The objects are merged as if added one at a time, but the paths are
+    /// shared out over @a nthreads threads, or one per hardware thread if it
+    /// is zero, as by merge(). The originals are left untouched. Returns the
+    /// number of objects merged rather than skipped.
+    size_t add(const std::vector<AnalysisObject*>& aos, size_t nthreads=0);
+
+    /// Number of distinct paths merged so far
+    size_t size() const { return _accs.size(); }
+
+    /// @brief Hand over the merged objects, with their normalisations reapplied
+    ///
+    /// The objects are in the order of the first appearance of their paths
+    /// and are owned by the caller. The merger is left empty.
+    std::vector<AnalysisObject*> result();
+
+    /// Discard everything merged so far
+    void reset();
+
+  private:
+
+    /// Not copyable, since it owns the accumulators
+    Merger(const Merger&);
+    Merger& operator = (const Merger&);
+
+    /// An accumulated object and the sum of the undone normalisation factors
+    struct Accumulator {
+      AnalysisObject* ao;
+      int kind;
+      double sum_sfs;
+    };
+
+    std::vector<Accumulator> _accs;
+    std::unordered_map<std::string, size_t> _index;
+
+  };
+
+
+  /// @brief Merge the objects in files @a filenames, reading one file at a time
+  ///
+  /// Each object is merged into a Merger as soon as its block has been read,
+  /// while the file is read ahead in chunks of a few MiB on a background
+  /// thread, so only the accumulators, the object being merged and two
+  /// chunks of input are held at once.
+  ///
+  /// If @a patterns is non-empty, only objects whose path matches at least
+  /// one of these regexes are merged, and those whose path matches any of
+  /// @a unpatterns are dropped. At @a verbosity 1 the progress and skipped
+  /// objects are reported on stderr, as by yodamerge, and at 2 also the
+  /// averaged scatters.
+  std::vector<AnalysisObject*> mergeFiles(const std::vector<std::string>& filenames,
+                                          const std::vector<std::string>& patterns=std::vector<std::string>(),
+                                          const std::vector<std::string>& unpatterns=std::vector<std::string>(),
+                                          int verbosity=0);
+
+  /// @}
+
+
+}
+
+#endif
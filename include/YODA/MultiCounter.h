@@ -0,0 +1,138 @@
+// -*- C++ -*-
+//
+// This file is part of YODA -- Yet more Objects for Data Analysis
+// Copyright (C) 2008-2021 The YODA collaboration (see AUTHORS for details)
+//
+#ifndef YODA_MultiCounter_h
+#define YODA_MultiCounter_h
+
+#include "YODA/AnalysisObject.h"
+#include "YODA/MultiWeighted.h"
+#include "YODA/DbnColumns.h"
+#include "YODA/Counter.h"
+
+namespace YODA {
+
+
+  /// A weighted counter, filled with several weight streams at once.
+  class MultiCounter : public AnalysisObject, public MultiWeighted {
+  public:
+
+    /// @name Constructors
+    /// @{
+
+    /// Constructor from the names of the weight streams
+    MultiCounter(const std::vector<std::string>& streams,
+                 const std::string& path="", const std::string& title="")
+      : AnalysisObject("MultiCounter", path, title),
+        MultiWeighted(streams),
+        _dbns(1, streams.size())
+    { }
+
+    /// Copy constructor with optional new path
+    MultiCounter(const MultiCounter& c, const std::string& path="")
+      : AnalysisObject("MultiCounter", (path.size() == 0) ? c.path() : path, c, c.title()),
+        MultiWeighted(c),
+        _dbns(c._dbns)
+    { }
+
+    /// Make a copy on the stack
+    MultiCounter clone() const {
+      return MultiCounter(*this);
+    }
+
+    /// Make a copy on the heap, via 'new'
+    MultiCounter* newclone() const {
+      return new MultiCounter(*this);
+    }
+
+    /// @}
+
+
+    /// @name Dimensions
+    /// @{
+
+    /// Fill dimension of this data object
+    size_t dim() const { return 0; }
+
+    /// Fill dimension of this data object
+    size_t fillDim() const { return 0; }
+
+    /// @}
+
+
+    /// @name Modifiers
+    /// @{
+
+    /// Fill with one weight per stream from @a weights
+    void fill(const double* weights, double fraction=1.0) {
+      _dbns.fill(0, 0, 0, 0, weights, fraction);
+    }
+
+    /// Fill with a vector of one weight per stream
+    void fill(const std::vector<double>& weights, double fraction=1.0) {
+      _checkWeights(weights.size());
+      fill(weights.data(), fraction);
+    }
+
+    /// Reset the counts of all the streams
+    void reset() {
+      _dbns.reset();
+    }
+
+    /// Rescale weight stream @a i as if all its fill weights had been different by @a scalefactor
+    void scaleW(size_t i, double scalefactor) {
+      _dbns.scaleW(i, scalefactor);
+      _recordScale(i, scalefactor);
+    }
+
+    /// @}
+
+
+    /// @name Data access
+    /// @{
+
+    /// The distribution of weight stream @a i
+    Dbn0D dbn(size_t i) const { return _dbns.dbn(0, i); }
+
+    /// The counter of weight stream @a i, as a standard Counter
+    Counter counter(size_t i) const {
+      Counter rtn(dbn(i), path(), title());
+      _expandInto(*this, rtn, i);
+      return rtn;
+    }
+
+    /// The counters of all the weight streams
+    std::vector<Counter> counters() const {
+      std::vector<Counter> rtn;
+      for (size_t i = 0; i < numStreams(); ++i) rtn.push_back(counter(i));
+      return rtn;
+    }
+
+    /// @}
+
+
+    /// @name Operators
+    /// @{
+
+    /// Add another counter with the same weight streams
+    MultiCounter& operator += (const MultiCounter& c) {
+      _checkStreams(c);
+      _dbns += c._dbns;
+      return *this;
+    }
+
+    /// @}
+
+
+  private:
+
+    /// The distribution of each stream
+    MultiDbns<Dbn0D> _dbns;
+
+  };
+
+
+}
+
+#endif
@@ -0,0 +1,174 @@
+// -*- C++ -*-
+//
+// This file is part of YODA -- Yet more Objects for Data Analysis
+// Copyright (C) 2008-2021 The YODA collaboration (see AUTHORS for details)
+//
+#ifndef YODA_MultiHisto2D_h
+#define YODA_MultiHisto2D_h
+
+#include "YODA/AnalysisObject.h"
+#include "YODA/MultiWeighted.h"
+#include "YODA/DbnColumns.h"
+#include "YODA/Histo2D.h"
+
+namespace YODA {
+
+
+  /// @brief A two-dimensional histogram, filled with several weight streams at once
+  ///
+  /// The bin distributions of all the streams are stored in one bin-by-stream
+  /// block, so a fill does a single bin lookup and then updates every stream
+  /// in a vectorised loop. The histogram of each stream is available as a
+  /// standard Histo2D, which is also how it is written out.
+  ///
+  /// As for a default Histo2D, NaN fills throw and fills outside the bins
+  /// count only towards the total distribution.
+  class MultiHisto2D : public AnalysisObject, public MultiWeighted {
+  public:
+
+    /// @name Constructors
+    /// @{
+
+    /// Constructor giving ranges and numbers of bins.
+    MultiHisto2D(const std::vector<std::string>& streams,
+                 size_t nbinsX, double lowerX, double upperX,
+                 size_t nbinsY, double lowerY, double upperY,
+                 const std::string& path="", const std::string& title="")
+      : AnalysisObject("MultiHisto2D", path, title),
+        MultiWeighted(streams),
+        _binning(nbinsX, lowerX, upperX, nbinsY, lowerY, upperY),
+        _bins(_binning.numBins(), streams.size()), _total(1, streams.size())
+    { }
+
+    /// Constructor giving explicit bin edges.
+    MultiHisto2D(const std::vector<std::string>& streams,
+                 const std::vector<double>& xedges, const std::vector<double>& yedges,
+                 const std::string& path="", const std::string& title="")
+      : AnalysisObject("MultiHisto2D", path, title),
+        MultiWeighted(streams),
+        _binning(xedges, yedges),
+        _bins(_binning.numBins(), streams.size()), _total(1, streams.size())
+    { }
+
+    /// Constructor with the binning, path, title and annotations of a Histo2D
+    MultiHisto2D(const std::vector<std::string>& streams, const Histo2D& h);
+
+    /// Copy constructor with optional new path
+    MultiHisto2D(const MultiHisto2D& h, const std::string& path="");
+
+    /// Make a copy on the stack
+    MultiHisto2D clone() const {
+      return MultiHisto2D(*this);
+    }
+
+    /// Make a copy on the heap, via 'new'
+    MultiHisto2D* newclone() const {
+      return new MultiHisto2D(*this);
+    }
+
+    /// @}
+
+
+    /// @name Dimensions
+    /// @{
+
+    /// Fill dimension of this data object
+    size_t dim() const { return 2; }
+
+    /// Fill dimension of this data object
+    size_t fillDim() const { return 2; }
+
+    /// @}
+
+
+    /// @name Modifiers
+    /// @{
+
+    /// Fill at (@a x, @a y) with one weight per stream from @a weights
+    void fill(double x, double y, const double* weights, double fraction=1.0);
+
+    /// Fill at (@a x, @a y) with a vector of one weight per stream
+    void fill(double x, double y, const std::vector<double>& weights, double fraction=1.0) {
+      _checkWeights(weights.size());
+      fill(x, y, weights.data(), fraction);
+    }
+
+    /// Reset the contents of all the streams, keeping the binning
+    void reset() {
+      _bins.reset();
+      _total.reset();
+    }
+
+    /// Rescale weight stream @a i as if all its fill weights had been different by @a scalefactor
+    void scaleW(size_t i, double scalefactor) {
+      _bins.scaleW(i, scalefactor);
+      _total.scaleW(i, scalefactor);
+      _recordScale(i, scalefactor);
+    }
+
+    /// @}
+
+
+    /// @name Binning and data access
+    /// @{
+
+    /// Number of bins
+    size_t numBins() const { return _binning.numBins(); }
+
+    /// Low edge of this histo's axis
+    double xMin() const { return _binning.xMin(); }
+
+    /// High edge of this histo's axis
+    double xMax() const { return _binning.xMax(); }
+
+    /// Low y edge of this histo's axis
+    double yMin() const { return _binning.yMin(); }
+
+    /// High y edge of this histo's axis
+    double yMax() const { return _binning.yMax(); }
+
+    /// The empty histogram whose binning is used
+    const Histo2D& binning() const { return _binning; }
+
+    /// Distribution of bin @a ibin for weight stream @a i
+    Dbn2D binDbn(size_t ibin, size_t i) const { return _bins.dbn(ibin, i); }
+
+    /// Total distribution for weight stream @a i
+    Dbn2D totalDbn(size_t i) const { return _total.dbn(0, i); }
+
+    /// The histogram of weight stream @a i, as a standard Histo2D
+    Histo2D histo(size_t i) const;
+
+    /// The histograms of all the weight streams
+    std::vector<Histo2D> histos() const {
+      std::vector<Histo2D> rtn;
+      for (size_t i = 0; i < numStreams(); ++i) rtn.push_back(histo(i));
+      return rtn;
+    }
+
+    /// @}
+
+
+    /// @name Operators
+    /// @{
+
+    /// Add another histogram with the same binning and weight streams
+    MultiHisto2D& operator += (const MultiHisto2D& h);
+
+    /// @}
+
+
+  private:
+
+    /// Empty histogram providing the binning and bin lookup
+    Histo2D _binning;
+
+    /// Bin and total distributions of each stream
+    MultiDbns<Dbn2D> _bins, _total;
+
+  };
+
+
+}
+
+#endif
@@ -0,0 +1,171 @@
+// -*- C++ -*-
+//
+// This file is part of YODA -- Yet more Objects for Data Analysis
+// Copyright (C) 2008-2021 The YODA collaboration (see AUTHORS for details)
+//
+#ifndef YODA_MultiProfile1D_h
+#define YODA_MultiProfile1D_h
+
+#include "YODA/AnalysisObject.h"
+#include "YODA/MultiWeighted.h"
+#include "YODA/DbnColumns.h"
+#include "YODA/Profile1D.h"
+
+namespace YODA {
+
+
+  /// @brief A one-dimensional profile histogram, filled with several weight streams at once
+  ///
+  /// The bin distributions of all the streams are stored in one bin-by-stream
+  /// block, so a fill does a single bin lookup and then updates every stream
+  /// in a vectorised loop. The profile of each stream is available as a
+  /// standard Profile1D, which is also how it is written out.
+  ///
+  /// As for a default Profile1D, NaN fills throw and fills in bin gaps count
+  /// only towards the total distribution.
+  class MultiProfile1D : public AnalysisObject, public MultiWeighted {
+  public:
+
+    /// @name Constructors
+    /// @{
+
+    /// Constructor giving range and number of bins.
+    MultiProfile1D(const std::vector<std::string>& streams,
+                 size_t nbins, double lower, double upper,
+                 const std::string& path="", const std::string& title="")
+      : AnalysisObject("MultiProfile1D", path, title),
+        MultiWeighted(streams),
+        _binning(nbins, lower, upper),
+        _bins(_binning.numBins(), streams.size()), _flows(3, streams.size())
+    { }
+
+    /// Constructor giving explicit bin edges.
+    MultiProfile1D(const std::vector<std::string>& streams,
+                 const std::vector<double>& binedges,
+                 const std::string& path="", const std::string& title="")
+      : AnalysisObject("MultiProfile1D", path, title),
+        MultiWeighted(streams),
+        _binning(binedges),
+        _bins(_binning.numBins(), streams.size()), _flows(3, streams.size())
+    { }
+
+    /// Constructor with the binning, path, title and annotations of a Profile1D
+    MultiProfile1D(const std::vector<std::string>& streams, const Profile1D& p);
+
+    /// Copy constructor with optional new path
+    MultiProfile1D(const MultiProfile1D& h, const std::string& path="");
+
+    /// Make a copy on the stack
+    MultiProfile1D clone() const {
+      return MultiProfile1D(*this);
+    }
+
+    /// Make a copy on the heap, via 'new'
+    MultiProfile1D* newclone() const {
+      return new MultiProfile1D(*this);
+    }
+
+    /// @}
+
+
+    /// @name Dimensions
+    /// @{
+
+    /// Fill dimension of this data object
+    size_t dim() const { return 2; }
+
+    /// Fill dimension of this data object
+    size_t fillDim() const { return 1; }
+
+    /// @}
+
+
+    /// @name Modifiers
+    /// @{
+
+    /// Fill at (@a x, @a y) with one weight per stream from @a weights
+    void fill(double x, double y, const double* weights, double fraction=1.0);
+
+    /// Fill at (@a x, @a y) with a vector of one weight per stream
+    void fill(double x, double y, const std::vector<double>& weights, double fraction=1.0) {
+      _checkWeights(weights.size());
+      fill(x, y, weights.data(), fraction);
+    }
+
+    /// Reset the contents of all the streams, keeping the binning
+    void reset() {
+      _bins.reset();
+      _flows.reset();
+    }
+
+    /// @brief Rescale weight stream @a i as if all its fill weights had been different by @a scalefactor
+    ///
+    /// As with Profile1D::scaleW, no ScaledBy annotation is recorded.
+    void scaleW(size_t i, double scalefactor) {
+      _bins.scaleW(i, scalefactor);
+      _flows.scaleW(i, scalefactor);
+    }
+
+    /// @}
+
+
+    /// @name Binning and data access
+    /// @{
+
+    /// Number of bins
+    size_t numBins() const { return _binning.numBins(); }
+
+    /// Low edge of this histo's axis
+    double xMin() const { return _binning.xMin(); }
+
+    /// High edge of this histo's axis
+    double xMax() const { return _binning.xMax(); }
+
+    /// The empty profile whose binning is used
+    const Profile1D& binning() const { return _binning; }
+
+    /// Distribution of bin @a ibin for weight stream @a i
+    Dbn2D binDbn(size_t ibin, size_t i) const { return _bins.dbn(ibin, i); }
+
+    /// Total distribution for weight stream @a i
+    Dbn2D totalDbn(size_t i) const { return _flows.dbn(TOTAL, i); }
+
+    /// The profile of weight stream @a i, as a standard Profile1D
+    Profile1D profile(size_t i) const;
+
+    /// The profiles of all the weight streams
+    std::vector<Profile1D> profiles() const {
+      std::vector<Profile1D> rtn;
+      for (size_t i = 0; i < numStreams(); ++i) rtn.push_back(profile(i));
+      return rtn;
+    }
+
+    /// @}
+
+
+    /// @name Operators
+    /// @{
+
+    /// Add another profile with the same binning and weight streams
+    MultiProfile1D& operator += (const MultiProfile1D& p);
+
+    /// @}
+
+
+  private:
+
+    /// Rows of the flow distributions
+    enum { TOTAL = 0, UFLOW = 1, OFLOW = 2 };
+
+    /// Empty profile providing the binning and bin lookup
+    Profile1D _binning;
+
+    /// Bin and flow distributions of each stream
+    MultiDbns<Dbn2D> _bins, _flows;
+
+  };
+
+
+}
+
+#endif
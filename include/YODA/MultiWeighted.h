@@ -0,0 +1,108 @@
+// -*- C++ -*-
+//
+// This file is part of YODA -- Yet more Objects for Data Analysis
+// Copyright (C) 2008-2021 The YODA collaboration (see AUTHORS for details)
+//
+#ifndef YODA_MultiWeighted_h
+#define YODA_MultiWeighted_h
+
+#include "YODA/AnalysisObject.h"
+#include "YODA/Exceptions.h"
+#include <string>
+#include <vector>
+
+namespace YODA {
+
+
+  /// @brief A base class for analysis objects filled with several weight streams at once
+  ///
+  /// Each fill takes a dense vector of weights, one per named stream, e.g. the
+  /// nominal event weight and its systematic variations. The object expands
+  /// into one standard single-weight object per stream, with the nominal path
+  /// for an unnamed stream and "path[name]" for the others.
+  class MultiWeighted {
+  public:
+
+    /// Constructor from the names of the weight streams
+    MultiWeighted(const std::vector<std::string>& streams)
+      : _streams(streams), _scaledBy(streams.size(), 1.0), _scaled(streams.size(), false)
+    {
+      if (_streams.empty()) throw WeightError("A multi-weight object needs at least one weight stream");
+    }
+
+    /// Virtual destructor for inheritance
+    virtual ~MultiWeighted() { }
+
+
+    /// @name Weight streams
+    /// @{
+
+    /// Number of weight streams
+    size_t numStreams() const { return _streams.size(); }
+
+    /// Names of the weight streams
+    const std::vector<std::string>& streams() const { return _streams; }
+
+    /// Path of the single-weight object for stream @a i of an object at @a path
+    std::string streamPath(const std::string& path, size_t i) const {
+      if (_streams.at(i).empty()) return path;
+      return path + "[" + _streams[i] + "]";
+    }
+
+    /// @}
+
+
+  protected:
+
+    /// Check a fill provides exactly one weight per stream
+    void _checkWeights(size_t nweights) const {
+      if (nweights != numStreams()) {
+        throw WeightError("Got " + std::to_string(nweights) + " weights for " +
+                          std::to_string(numStreams()) + " weight streams");
+      }
+    }
+
+    /// Check another multi-weight object has the same weight streams
+    void _checkStreams(const MultiWeighted& other) const {
+      if (other._streams != _streams) throw LogicError("Multi-weight objects have different weight streams");
+    }
+
+    /// Record a rescaling of stream @a i, for the ScaledBy annotation of its expansion
+    void _recordScale(size_t i, double scalefactor) {
+      _scaledBy.at(i) *= scalefactor;
+      _scaled[i] = true;
+    }
+
+    /// Forget the recorded rescalings, as adding single-weight histograms does
+    void _clearScales() {
+      _scaledBy.assign(numStreams(), 1.0);
+      _scaled.assign(numStreams(), false);
+    }
+
+    /// @brief Give the expansion @a ao for stream @a i the annotations and path of @a src
+    ///
+    /// A recorded rescaling of the stream is applied to the ScaledBy annotation.
+    void _expandInto(const AnalysisObject& src, AnalysisObject& ao, size_t i) const {
+      for (const std::string& a : src.annotations()) {
+        if (a != "Type" && a != "Path") ao.setAnnotation(a, src.annotation(a));
+      }
+      ao.setPath(streamPath(src.path(), i));
+      if (_scaled[i]) ao.setAnnotation("ScaledBy", ao.annotation<double>("ScaledBy", 1.0) * _scaledBy[i]);
+    }
+
+
+  private:
+
+    /// Names of the weight streams
+    std::vector<std::string> _streams;
+
+    /// Product of the scale factors applied to each stream, and whether any were
+    std::vector<double> _scaledBy;
+    std::vector<bool> _scaled;
+
+  };
+
+
+}
+
+#endif
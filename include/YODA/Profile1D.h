@@ -138,6 +138,25 @@ namespace YODA {
         fill(std::get<0>(xs), std::get<1>(xs), weight, fraction);
     }
 
+    /// @brief Fill histo from arrays of @a n x and y values, weights and fractions
+    ///
+    /// Equivalent to, and bitwise-identical with, a loop of fill() calls, but
+    /// with all the bin lookups done in one pass. Null @a weights or @a
+    /// fractions pointers are treated as all-1.
+    virtual void fillMany(size_t n, const double* xs, const double* ys,
+                          const double* weights=nullptr, const double* fractions=nullptr);
+
+    /// Fill histo from vectors of x and y values, weights and fractions (the last two may be empty)
+    void fillMany(const std::vector<double>& xs, const std::vector<double>& ys,
+                  const std::vector<double>& weights=std::vector<double>(),
+                  const std::vector<double>& fractions=std::vector<double>()) {
+      if (ys.size() != xs.size()) throw UserError("Mismatched x and y array sizes in fillMany");
+      _checkFillSizes(xs.size(), weights.size(), fractions.size());
+      fillMany(xs.size(), xs.data(), ys.data(),
+               weights.empty() ? nullptr : weights.data(),
+               fractions.empty() ? nullptr : fractions.data());
+    }
+
     /// Fill histo x bin i with the given y value and weight
     virtual void fillBin(size_t i, double y, double weight=1.0, double fraction=1.0);
 
@@ -232,6 +251,43 @@ namespace YODA {
     /// @}
 
 
+    /// @name NaN and bin-gap fill handling
+    /// @{
+
+    /// Policy for fills with a NaN coordinate (default FILL_THROW)
+    FillPolicy nanPolicy() const { return _axis.nanPolicy(); }
+    /// Set the policy for fills with a NaN coordinate
+    void setNanPolicy(FillPolicy policy) { _axis.setNanPolicy(policy); }
+
+    /// Policy for in-range fills which fall into a bin gap (default FILL_IGNORE)
+    FillPolicy gapPolicy() const { return _axis.gapPolicy(); }
+    /// Set the policy for in-range fills which fall into a bin gap
+    void setGapPolicy(FillPolicy policy) { _axis.setGapPolicy(policy); }
+
+    /// Weights of the NaN fills recorded under the FILL_COUNT policy
+    const Dbn0D& nanDbn() const { return _axis.nanDbn(); }
+
+    /// Weights of the bin-gap fills recorded under the FILL_COUNT policy
+    const Dbn0D& gapDbn() const { return _axis.gapDbn(); }
+
+    /// @}
+
+
+    /// @name Columnar storage
+    /// @{
+
+    /// @brief Hold the bin contents as one array per running sum, for fast whole-histo operations
+    ///
+    /// Fills, scaleW, +=, -= and reset then work on the arrays, and the bins are
+    /// kept current as they go. See Axis1D::setColumnar for details.
+    void setColumnar(bool columnar=true) { _axis.setColumnar(columnar); }
+
+    /// Whether the bin contents are held in columnar form
+    bool columnar() const { return _axis.columnar(); }
+
+    /// @}
+
+
     /// @name Bin accessors
     /// @{
 
@@ -267,7 +323,7 @@ namespace YODA {
 
 
     /// Access a bin by index (non-const version)
-    ProfileBin1D& bin(size_t index) { return _axis.bins()[index]; }
+    ProfileBin1D& bin(size_t index) { return _axis.bin(index); }
     /// Access a bin by index (const version)
     const ProfileBin1D& bin(size_t index) const { return _axis.bins()[index]; }
 
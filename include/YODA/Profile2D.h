@@ -141,6 +141,27 @@ namespace YODA {
         fill(std::get<0>(xs), std::get<1>(xs), std::get<2>(xs), weight, fraction);
     }
 
+    /// @brief Fill histo from arrays of @a n x, y and z values, weights and fractions
+    ///
+    /// Equivalent to, and bitwise-identical with, a loop of fill() calls, but
+    /// with all the bin lookups done in one pass. Null @a weights or @a
+    /// fractions pointers are treated as all-1. With a fill buffer set, the
+    /// fills are queued as by fill().
+    virtual void fillMany(size_t n, const double* xs, const double* ys, const double* zs,
+                          const double* weights=nullptr, const double* fractions=nullptr);
+
+    /// Fill histo from vectors of x, y and z values, weights and fractions (the last two may be empty)
+    void fillMany(const std::vector<double>& xs, const std::vector<double>& ys, const std::vector<double>& zs,
+                  const std::vector<double>& weights=std::vector<double>(),
+                  const std::vector<double>& fractions=std::vector<double>()) {
+      if (ys.size() != xs.size() || zs.size() != xs.size())
+        throw UserError("Mismatched x, y and z array sizes in fillMany");
+      _checkFillSizes(xs.size(), weights.size(), fractions.size());
+      fillMany(xs.size(), xs.data(), ys.data(), zs.data(),
+               weights.empty() ? nullptr : weights.data(),
+               fractions.empty() ? nullptr : fractions.data());
+    }
+
     /// Fill histo x-y bin i with the given z value and weight
     virtual void fillBin(size_t i, double z, double weight=1.0, double fraction=1.0);
 
@@ -240,6 +261,63 @@ namespace YODA {
     /// @}
 
 
+    /// @name NaN and bin-gap fill handling
+    /// @{
+
+    /// Policy for fills with a NaN coordinate (default FILL_THROW)
+    FillPolicy nanPolicy() const { return _axis.nanPolicy(); }
+    /// Set the policy for fills with a NaN coordinate
+    void setNanPolicy(FillPolicy policy) { _axis.setNanPolicy(policy); }
+
+    /// Policy for in-range fills which fall into a bin gap (default FILL_IGNORE)
+    FillPolicy gapPolicy() const { return _axis.gapPolicy(); }
+    /// Set the policy for in-range fills which fall into a bin gap
+    void setGapPolicy(FillPolicy policy) { _axis.setGapPolicy(policy); }
+
+    /// Weights of the NaN fills recorded under the FILL_COUNT policy
+    const Dbn0D& nanDbn() const { return _axis.nanDbn(); }
+
+    /// Weights of the bin-gap fills recorded under the FILL_COUNT policy
+    const Dbn0D& gapDbn() const { return _axis.gapDbn(); }
+
+    /// @}
+
+
+    /// @name Buffered filling
+    /// @{
+
+    /// @brief Queue up to @a n fills and accumulate them in bin order, for large binnings
+    ///
+    /// Results are as with direct fills. Modifiers flush the queue first, and
+    /// const reads throw while fills are queued, so call flushFills() before
+    /// reading or writing. A size of 0 turns buffering off. See
+    /// Axis2D::setFillBuffer for details.
+    void setFillBuffer(size_t n=FILLBUFFER_SIZE) { _axis.setFillBuffer(n); }
+
+    /// Maximum number of queued fills, or 0 if fills are not buffered
+    size_t fillBufferSize() const { return _axis.fillBufferSize(); }
+
+    /// Accumulate all queued fills now
+    void flushFills() { _axis.flushFills(); }
+
+    /// @}
+
+
+    /// @name Columnar storage
+    /// @{
+
+    /// @brief Hold the bin contents as one array per running sum, for fast whole-histo operations
+    ///
+    /// Fills, scaleW, +=, -= and reset then work on the arrays, and the bins are
+    /// kept current as they go. See Axis2D::setColumnar for details.
+    void setColumnar(bool columnar=true) { _axis.setColumnar(columnar); }
+
+    /// Whether the bin contents are held in columnar form
+    bool columnar() const { return _axis.columnar(); }
+
+    /// @}
+
+
     /// @name Bin accessors
     /// @{
 
@@ -291,7 +369,7 @@ namespace YODA {
 
 
     /// Access a bin by index (non-const)
-    ProfileBin2D& bin(size_t index) { return _axis.bins()[index]; }
+    ProfileBin2D& bin(size_t index) { return _axis.bin(index); }
 
     /// Access a bin by index (const)
     const ProfileBin2D& bin(size_t index) const { return _axis.bins()[index]; }
@@ -15,6 +15,7 @@
 #include <type_traits>
 #include <iostream>
 #include <sstream>
+#include <functional>
 
 namespace YODA {
 
@@ -23,6 +24,12 @@ namespace YODA {
   class Reader {
   public:
 
+    /// Function receiving each object as soon as it has been read, and taking ownership of it
+    typedef std::function<void(AnalysisObject*)> AOSink;
+
+    /// Predicate on object paths, choosing which objects to read: an empty one selects all
+    typedef std::function<bool(const std::string&)> PathFilter;
+
     /// Virtual destructor
     virtual ~Reader() {}
 
@@ -89,46 +96,142 @@ namespace YODA {
     /// and is hence CPU efficient.
     ///
     void read(const std::string& filename, std::vector<AnalysisObject*>& aos) {
+      readEach(filename, [&aos](AnalysisObject* ao) { aos.push_back(ao); });
+    }
+
+    /// @brief Read in a collection of objects from output stream @a stream.
+    ///
+    /// This version returns a vector by value, involving copying, and is hence less
+    /// CPU efficient than the alternative version where a vector is filled by reference.
+    std::vector<AnalysisObject*> read(const std::string& filename) {
+      std::vector<AnalysisObject*> rtn;
+      read(filename, rtn);
+      return rtn;
+    }
+
+
+    /// @brief Read only the objects from stream @a stream whose paths are selected by regexes
+    ///
+    /// If @a patterns is non-empty, only objects whose path matches at least
+    /// one of them are read, and those whose path matches any of @a unpatterns
+    /// are not. The selection is made from each object's header, so readers
+    /// which support it skip the rest of the unselected objects unparsed.
+    /// The input is parsed on @a nthreads threads, as for readEach().
+    void read(std::istream& stream, std::vector<AnalysisObject*>& aos,
+              const std::vector<std::string>& patterns, const std::vector<std::string>& unpatterns,
+              size_t nthreads=1) {
+      readEach(stream, [&aos](AnalysisObject* ao) { aos.push_back(ao); }, mkPathFilter(patterns, unpatterns), nthreads);
+    }
+
+    /// @brief Read only the objects from file @a filename whose paths are selected by regexes
+    ///
+    /// The selection and threading are as for reading from a stream.
+    void read(const std::string& filename, std::vector<AnalysisObject*>& aos,
+              const std::vector<std::string>& patterns, const std::vector<std::string>& unpatterns,
+              size_t nthreads=1) {
+      readEach(filename, [&aos](AnalysisObject* ao) { aos.push_back(ao); }, mkPathFilter(patterns, unpatterns), nthreads);
+    }
+
+    /// @}
+
+
+    /// @name Streaming analysis objects one at a time
+    /// @{
+
+    /// @brief Read objects from input stream @a stream, passing each to @a sink
+    ///
+    /// Readers which can finish objects before the end of the input override
+    /// this to hand each one over as soon as it is complete, so that a caller
+    /// which consumes them as they come never holds the whole input in memory.
+    ///
+    /// Only objects whose paths pass @a filter are handed over. Readers which
+    /// can find the paths before parsing the objects skip the others unread;
+    /// by default they are read and then deleted.
+    ///
+    /// Readers whose input splits into independent blocks parse those on
+    /// @a nthreads threads, or one per hardware thread if it is zero, and
+    /// still hand the objects over in input order. It is an argument rather
+    /// than reader state because the readers are shared singletons.
+    ///
+    /// @note Only ReaderYODA parses in parallel. This default, and so the
+    /// other readers, read sequentially whatever the thread count.
+    virtual void readEach(std::istream& stream, const AOSink& sink, const PathFilter& filter=PathFilter(),
+                          size_t /*nthreads*/=1) {
+      std::vector<AnalysisObject*> aos;
+      read(stream, aos);
+      for (AnalysisObject* ao : aos) {
+        if (!filter || filter(ao->path())) sink(ao);
+        else delete ao;
+      }
+    }
+
+    /// @brief Read objects from file @a filename, passing each to @a sink
+    ///
+    /// Readers may override this to read files other than through a stream.
+    virtual void readEach(const std::string& filename, const AOSink& sink, const PathFilter& filter=PathFilter(),
+                          size_t nthreads=1) {
       if (filename != "-") {
         try {
           std::ifstream instream;
           instream.open(filename.c_str());
           if (instream.fail())
             throw ReadError("Reading from filename " + filename + " failed");
-          read(instream, aos);
+          readEach(instream, sink, filter, nthreads);
           instream.close();
         } catch (std::ifstream::failure& e) {
           throw ReadError("Reading from filename " + filename + " failed: " + e.what());
         }
       } else {
         try {
-          read(std::cin, aos);
+          readEach(std::cin, sink, filter, nthreads);
         } catch (std::runtime_error& e) {
           throw ReadError("Reading from stdin failed: " + std::string(e.what()));
         }
       }
     }
 
-    /// @brief Read in a collection of objects from output stream @a stream.
+    /// @brief Make a filter selecting paths by regexes, as for read()
     ///
-    /// This version returns a vector by value, involving copying, and is hence less
-    /// CPU efficient than the alternative version where a vector is filled by reference.
-    std::vector<AnalysisObject*> read(const std::string& filename) {
-      std::vector<AnalysisObject*> rtn;
-      read(filename, rtn);
-      return rtn;
+    /// The regexes use the ECMAScript grammar of std::regex and may match
+    /// anywhere in the path. If both lists are empty the filter is empty.
+    static PathFilter mkPathFilter(const std::vector<std::string>& patterns,
+                                   const std::vector<std::string>& unpatterns);
+
+    /// @}
+
+
+    /// @name Random access to single analysis objects
+    /// @{
+
+    /// @brief Read the object with path @a path from file @a filename
+    ///
+    /// Readers which can index the positions of objects in a file read
+    /// only that object's data; others read the file, keeping just this
+    /// object. Returns null if there is no such object, or else the first
+    /// with this path, owned by the caller.
+    AnalysisObject* readObject(const std::string& filename, const std::string& path) {
+      const std::vector<AnalysisObject*> aos = readObjects(filename, {path});
+      return aos.empty() ? nullptr : aos[0];
     }
 
+    /// @brief Read the objects with paths @a paths from file @a filename
+    ///
+    /// The objects, as for readObject(), are in the order of @a paths,
+    /// leaving out repeated paths and those which are not in the file.
+    virtual std::vector<AnalysisObject*> readObjects(const std::string& filename,
+                                                     const std::vector<std::string>& paths);
+
     /// @}
 
 
     /// @brief Make file index
     ///
-    /// Makes an index of a file's contents.
+    /// Makes an index of a file's contents. Readers may override this to
+    /// index files other than through a stream, e.g. with object positions.
     ///
     /// @param[in] filename Path to the file to index.
     /// @return @sa Index
-    Index mkIndex(const std::string& filename) {
+    virtual Index mkIndex(const std::string& filename) {
       if (filename != "-") {
         try {
           std::ifstream instream;
@@ -21,9 +21,57 @@ namespace YODA {
     static Reader& create();
 
     void read(std::istream& stream, std::vector<AnalysisObject*>& aos);
-    
+
+    /// @brief Read objects from @a stream, passing each to @a sink at the end of its block
+    ///
+    /// Blocks whose paths fail @a filter are skipped up to their END line,
+    /// without parsing their data or annotations.
+    void readEach(std::istream& stream, const AOSink& sink, const PathFilter& filter=PathFilter(),
+                  size_t nthreads=1);
+
+    /// @brief Read objects from file @a filename, passing each to @a sink at the end of its block
+    ///
+    /// Uncompressed files are memory-mapped where possible and parsed in
+    /// place, without copying them line by line through a stream.
+    void readEach(const std::string& filename, const AOSink& sink, const PathFilter& filter=PathFilter(),
+                  size_t nthreads=1);
+
     Index mkIndex(std::istream& stream);
 
+    /// @brief Make an index of file @a filename
+    ///
+    /// Uncompressed files are indexed with the position of each object, or
+    /// the index is loaded from the sidecar index file if it is up to date.
+    Index mkIndex(const std::string& filename);
+
+    /// Read the objects with paths @a paths from file @a filename, using the index to parse only their blocks
+    std::vector<AnalysisObject*> readObjects(const std::string& filename, const std::vector<std::string>& paths);
+
+
+    /// @name Sidecar index files
+    /// @{
+
+    /// Name of the sidecar index file for YODA file @a filename
+    static std::string indexFilename(const std::string& filename) {
+      return filename + ".idx";
+    }
+
+    /// @brief Write the sidecar index file for uncompressed YODA file @a filename
+    ///
+    /// The index is stamped with the file's size and modification time, and
+    /// is ignored once the file changes.
+    static void writeIndexFile(const std::string& filename);
+
+    /// @brief Write the sidecar index file for uncompressed YODA file @a filename from index @a idx
+    ///
+    /// For writers, which know the objects' positions without rereading the file.
+    static void writeIndexFile(const std::string& filename, const Index& idx);
+
+    /// Remove the sidecar index file of @a filename, if there is one: other files by its name are kept
+    static void removeIndexFile(const std::string& filename);
+
+    /// @}
+
     // Include definitions of all read methods (all fulfilled by Reader::read(...))
     #include "YODA/ReaderMethods.icc"
 
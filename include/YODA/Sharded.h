@@ -0,0 +1,244 @@
+// -*- C++ -*-
+//
+// This file is part of YODA -- Yet more Objects for Data Analysis
+// Copyright (C) 2008-2021 The YODA collaboration (see AUTHORS for details)
+//
+#ifndef YODA_Sharded_h
+#define YODA_Sharded_h
+
+#include "YODA/Exceptions.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace YODA {
+
+
+  /// @brief Concurrent fill wrapper with one replica of a fillable object per thread
+  ///
+  /// Each thread filling through a Sharded object gets its own empty copy of the
+  /// booked object on its first fill, so fills take no locks and share no bins.
+  /// The replicas, which outlive their threads, are combined with the booked
+  /// object on demand by merged(). Any type with fill() and operator += works,
+  /// e.g. Counter, Histo1D, Histo2D, Profile1D and Profile2D.
+  ///
+  /// Results which do not depend on the thread schedule need local(i): book a
+  /// fixed number of workers and fill through local(i) with each worker's own
+  /// index. Their replicas are summed pairwise in index order, so the same
+  /// per-worker fills always give the same result. The per-thread replicas of
+  /// fill() and local() follow in order of creation, which follows the thread
+  /// schedule, so their merged sums may differ between runs by rounding.
+  ///
+  /// @note merged() and reset() must not run concurrently with fills.
+  ///
+  /// @note Auto-binned histograms must have their bins chosen before wrapping,
+  /// since each replica would otherwise choose its own edges.
+  template <typename T>
+  class Sharded {
+  public:
+
+    /// @name Constructors
+    /// @{
+
+    /// @brief Constructor from the booked object, whose contents are included in merges
+    ///
+    /// Replicas for @a nworkers explicitly indexed workers are made up front,
+    /// for filling through local(size_t).
+    Sharded(const T& booked, size_t nworkers=0)
+      : _booked(booked), _id(_takeId()), _serial(_nextSerial()++)
+    {
+      if (_autoBinPending(booked, 0)) {
+        _releaseId(_id);
+        throw UserError("Cannot shard an object whose auto-binning is still pending");
+      }
+      for (size_t i = 0; i < nworkers; ++i) {
+        _workers.emplace_back(new T(_booked));
+        _workers.back()->reset();
+      }
+    }
+
+    /// Destructor, freeing this object's slot for reuse
+    ~Sharded() { _releaseId(_id); }
+
+    /// Replicas are owned and registered per object, so no copying
+    Sharded(const Sharded&) = delete;
+    Sharded& operator = (const Sharded&) = delete;
+
+    /// @}
+
+
+    /// @name Filling
+    /// @{
+
+    /// Fill this thread's replica, with the arguments of the wrapped type's fill()
+    template <typename... Args>
+    void fill(Args&&... args) {
+      local().fill(std::forward<Args>(args)...);
+    }
+
+    /// Batch-fill this thread's replica, with the arguments of the wrapped type's fillMany()
+    template <typename... Args>
+    void fillMany(Args&&... args) {
+      local().fillMany(std::forward<Args>(args)...);
+    }
+
+    /// @brief This thread's replica, created empty on first use
+    ///
+    /// Only the creation, on a thread's first fill of this object, takes a lock.
+    T& local() {
+      std::vector<Slot>& slots = _slots();
+      if (_id < slots.size() && slots[_id].serial == _serial) return *slots[_id].replica;
+      std::lock_guard<std::mutex> lock(_mutex);
+      _replicas.emplace_back(new T(_booked));
+      _replicas.back()->reset();
+      if (slots.size() <= _id) slots.resize(_id+1, Slot{0, nullptr});
+      slots[_id] = Slot{_serial, _replicas.back().get()};
+      return *slots[_id].replica;
+    }
+
+    /// @brief The replica of worker @a worker, for fills merged in a fixed order
+    ///
+    /// Each index must be filled from only one thread at a time. No locks are taken.
+    T& local(size_t worker) {
+      if (worker >= _workers.size()) throw RangeError("Sharded worker index out of range");
+      return *_workers[worker];
+    }
+
+    /// Number of explicitly indexed workers
+    size_t numWorkers() const {
+      return _workers.size();
+    }
+
+    /// @}
+
+
+    /// @name Merging
+    /// @{
+
+    /// Number of per-thread replicas, i.e. of threads which have filled through fill() or local() so far
+    size_t numShards() const {
+      std::lock_guard<std::mutex> lock(_mutex);
+      return _replicas.size();
+    }
+
+    /// The booked object plus the fills of all threads
+    T merged() const {
+      std::lock_guard<std::mutex> lock(_mutex);
+      T rtn(_booked);
+      if (_workers.empty() && _replicas.empty()) return rtn;
+
+      // Sum copies of the replicas pairwise: the workers' in index order, then
+      // the per-thread ones in order of creation
+      std::vector<T> parts;
+      for (const auto& w : _workers) parts.push_back(*w);
+      for (const auto& r : _replicas) parts.push_back(*r);
+      for (size_t step = 1; step < parts.size(); step *= 2) {
+        for (size_t i = 0; i + step < parts.size(); i += 2*step) parts[i] += parts[i+step];
+      }
+      rtn += parts[0];
+      return rtn;
+    }
+
+    /// Empty all replicas, and the booked object
+    void reset() {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _booked.reset();
+      for (auto& w : _workers) w->reset();
+      for (auto& r : _replicas) r->reset();
+    }
+
+    /// @}
+
+
+  private:
+
+    /// A thread's replica of one object, tagged with the owner's serial number
+    struct Slot {
+      uint64_t serial;
+      T* replica;
+    };
+
+    /// @brief Per-thread replica slots of all live Sharded<T> objects, indexed by object ID
+    ///
+    /// IDs are reused once their object is destroyed, so each table is only as
+    /// long as the most Sharded<T> objects alive at once. A reused slot still
+    /// holding a dead object's replica is told apart by its serial number.
+    static std::vector<Slot>& _slots() {
+      static thread_local std::vector<Slot> slots;
+      return slots;
+    }
+
+    /// Source of serial numbers, never reused, with 0 marking an empty slot
+    static std::atomic<uint64_t>& _nextSerial() {
+      static std::atomic<uint64_t> nextserial(1);
+      return nextserial;
+    }
+
+    /// Guard for the ID pool
+    static std::mutex& _idMutex() {
+      static std::mutex m;
+      return m;
+    }
+
+    /// IDs of destroyed objects, free for reuse
+    static std::vector<size_t>& _freeIds() {
+      static std::vector<size_t> ids;
+      return ids;
+    }
+
+    /// Take the lowest free ID, or a new one
+    static size_t _takeId() {
+      static size_t numids = 0;
+      std::lock_guard<std::mutex> lock(_idMutex());
+      std::vector<size_t>& ids = _freeIds();
+      if (ids.empty()) return numids++;
+      std::pop_heap(ids.begin(), ids.end(), std::greater<size_t>());
+      const size_t id = ids.back();
+      ids.pop_back();
+      return id;
+    }
+
+    /// Return an ID to the pool
+    static void _releaseId(size_t id) {
+      std::lock_guard<std::mutex> lock(_idMutex());
+      std::vector<size_t>& ids = _freeIds();
+      ids.push_back(id);
+      std::push_heap(ids.begin(), ids.end(), std::greater<size_t>());
+    }
+
+    /// Whether an auto-binned object has still to choose its bins
+    template <typename U>
+    static auto _autoBinPending(const U& u, int) -> decltype(u.autoBinPending()) { return u.autoBinPending(); }
+    /// Objects without auto-binning are always booked
+    template <typename U>
+    static bool _autoBinPending(const U&, long) { return false; }
+
+    /// The booked object
+    T _booked;
+
+    /// This object's slot in the per-thread replica tables
+    const size_t _id;
+
+    /// This object's serial number, marking its slots as current
+    const uint64_t _serial;
+
+    /// Replicas of the explicitly indexed workers
+    std::vector< std::unique_ptr<T> > _workers;
+
+    /// Per-thread replicas, appended under _mutex so that the index is their creation serial
+    std::vector< std::unique_ptr<T> > _replicas;
+
+    /// Guard for replica creation and merging
+    mutable std::mutex _mutex;
+
+  };
+
+
+}
+
+#endif
@@ -10,9 +10,11 @@
 #include "YODA/Utils/MathUtils.h"
 #include <cstdlib>
 #include <cmath>
+#include <algorithm>
 #include <vector>
 #include <limits>
 #include <memory>
+#include <functional>
 
 namespace YODA {
   namespace Utils {
@@ -21,101 +23,193 @@ namespace YODA {
     const size_t SEARCH_SIZE = 16;
     const size_t BISECT_LINEAR_THRESHOLD = 32;
 
+    /// Default max index error of the piecewise-linear learned estimator, within the linear search reach
+    const size_t PIECEWISE_MAX_ERROR = 2;
 
-    /// @brief Bin estimator
-    ///
-    /// Base class for guessing the right bin index for a given value. The
-    /// better the guess, the less time spent looking.
-    struct Estimator {
+    /// Min number of edges for which searches go through a cache-line-blocked B-tree index
+    const size_t BTREE_THRESHOLD = 65536;
 
-      /// Virtual destructor needed for inheritance
-      virtual ~Estimator() {}
+    /// Min number of edges for which batched lookups use the B-tree index
+    /// @note Interleaved bisections hide more of the cache-miss latency, so this is higher
+    const size_t BTREE_BATCH_THRESHOLD = 262144;
 
-      /// Return offset bin index estimate, with 0 = underflow and Nbins+1 = overflow
-      size_t estindex(double x) const {
-        const int i = _est(x);
-        if (i < 0) return 0;
-        const size_t i2 = (size_t) i;
-        if (i2 >= _N) return _N+1;
-        return i2 + 1;
-      }
+    /// Number of edges in each B-tree node, filling a 64-byte cache line
+    const size_t BTREE_NODE_SIZE = 8;
 
-      /// Return offset bin index estimate, with 0 = underflow and Nbins+1 = overflow
-      size_t operator() (double x) const {
-        return estindex(x);
-      }
+    /// Max number of edges for which batched lookups compare to every edge rather than bisecting,
+    /// and the number of edges left to compare to when they do bisect
+    const size_t BATCH_LINEAR_THRESHOLD = 16;
 
-    protected:
+    /// Max number of edges at which the candidate estimators are scored, strided over larger binnings
+    const size_t EST_SCORE_SAMPLES = 4096;
 
-      /// Make an int-valued estimate of bin index
-      /// @note No range checking or underflow offset
-      virtual int _est(double x) const = 0;
 
-      /// Number of bins
-      size_t _N;
-    };
+    /// Instruction sets for the batched bin search kernels
+    enum SIMDLevel { SIMD_AUTO, SIMD_NONE, SIMD_SSE2, SIMD_AVX2 };
+
 
+    /// Bin-spacing hypotheses for the TransformEstimator
+    enum EstTransform { EST_LIN, EST_LOG, EST_SQRT, EST_POWER, EST_LOGIT, EST_PIECEWISE, EST_USER };
 
-    /// @brief Linear bin estimator
+
+    /// @brief Transform-based bin estimator
     ///
-    /// This class handles guessing a index bin with a hypothesis of uniformly
-    /// spaced bins on a linear scale.
-    struct LinEstimator : public Estimator {
-
-      /// Constructor
-      LinEstimator(size_t nbins, double xlow, double xhigh) {
-        _N = nbins;
-        _c = xlow;
-        _m = (double) nbins / (xhigh - xlow);
-      }
+    /// This class handles guessing a bin index with a hypothesis of uniformly
+    /// spaced bins in t(x), for a monotonically increasing transform t: linear,
+    /// logarithmic, square root, a sign-preserving power x^p, the logit
+    /// log(x/(1-x)) on (0,1), or a user-supplied functor.
+    ///
+    /// The EST_PIECEWISE estimator instead learns t(x) from the edges, as a
+    /// piecewise-linear model of the bin index with a guaranteed maximum error.
+    ///
+    /// This is a closed set of transforms selected by a switch, so BinSearcher
+    /// can hold it by value and make its estimate without a virtual call or
+    /// pointer indirection.
+    class TransformEstimator {
+    public:
 
-      /// Copy constructor
-      LinEstimator(const LinEstimator& other) {
-        _N = other._N;
-        _c = other._c;
-        _m = other._m;
+      /// Constructor for a built-in transform, with the exponent @a power used by EST_POWER
+      TransformEstimator(size_t nbins=0, double xlow=0, double xhigh=1,
+                         EstTransform transform=EST_LIN, double power=1)
+        : _N(nbins), _transform(transform), _power(power), _maxerr(PIECEWISE_MAX_ERROR)
+      {
+        _init(xlow, xhigh);
       }
 
-      /// Call operator returns estimated bin index (offset so 0 == underflow)
-      int _est(double x) const {
-        return (int) floor(_m * (x - _c));
+      /// Constructor for a user-supplied monotonically increasing transform
+      TransformEstimator(size_t nbins, double xlow, double xhigh,
+                         const std::function<double(double)>& transform)
+        : _N(nbins), _transform(EST_USER), _power(1), _fn(transform), _maxerr(PIECEWISE_MAX_ERROR)
+      {
+        _init(xlow, xhigh);
       }
 
-    protected:
-      double _c, _m;
-    };
+      /// @brief Constructor for a piecewise-linear model of the bin index as a function of x
+      ///
+      /// The model is fitted to the @a edges so that its estimate for any x is
+      /// within @a maxerr + 1 of the true offset bin index.
+      TransformEstimator(const std::vector<double>& edges, size_t maxerr=PIECEWISE_MAX_ERROR)
+        : _N(edges.empty() ? 0 : edges.size()-1), _transform(EST_PIECEWISE), _power(1), _maxerr(maxerr)
+      {
+        _fitPiecewise(edges, maxerr);
+        _c = 0;
+        _m = 1;
+      }
 
+      /// @brief Constructor for the transform of @a other over new, non-empty @a edges
+      ///
+      /// Built-in and user transforms are rescaled to the new range, and an
+      /// EST_PIECEWISE model is refitted with the same max error.
+      TransformEstimator(const std::vector<double>& edges, const TransformEstimator& other)
+        : _N(edges.size()-1), _transform(other._transform), _power(other._power),
+          _fn(other._fn), _maxerr(other._maxerr)
+      {
+        if (_transform == EST_PIECEWISE) {
+          _fitPiecewise(edges, _maxerr);
+          _c = 0;
+          _m = 1;
+        } else {
+          _init(edges.front(), edges.back());
+        }
+      }
 
-    /// @brief Logarithmic bin estimator
-    ///
-    /// This class handles guessing a bin index with a hypothesis of uniformly
-    /// spaced bins on a logarithmic scale.
-    ///
-    /// @todo Make a generalised version of this with a transform function
-    class LogEstimator : public Estimator {
-    public:
+      /// The transform type
+      EstTransform transform() const { return _transform; }
+
+      /// The number of segments in an EST_PIECEWISE model
+      size_t numSegments() const { return _segx.size(); }
+
+      /// The exponent of an EST_POWER transform
+      double power() const { return _power; }
+
+      /// Apply the transform
+      double t(double x) const {
+        switch (_transform) {
+        case EST_LIN:
+          return x;
+        case EST_LOG:
+          return fastlog2(x);
+        case EST_SQRT:
+          return std::sqrt(x);
+        case EST_POWER:
+          return std::copysign(std::pow(std::fabs(x), _power), x);
+        case EST_LOGIT:
+          return std::log(x / (1 - x));
+        case EST_PIECEWISE:
+          return _piecewise(x);
+        default:
+          return _fn(x);
+        }
+      }
 
-      /// Constructor
-      LogEstimator(size_t nbins, double xlow, double xhigh) {
-        _N = nbins;
-        _c = log2(xlow);
-        _m = nbins / (log2(xhigh) - _c);
+      /// Is the transform finite and increasing over the estimator range?
+      bool valid() const {
+        return std::isfinite(_c) && std::isfinite(_m) && _m > 0;
       }
 
-      /// Copy constructor
-      LogEstimator(const LogEstimator& other) {
-        _N = other._N;
-        _c = other._c;
-        _m = other._m;
+      /// @brief Return offset bin index estimate, with 0 = underflow and Nbins+1 = overflow
+      /// @note Values outside the transform's domain are estimated as underflows
+      size_t estindex(double x) const {
+        const double i = _m * (t(x) - _c);
+        if (!(i >= 0)) return 0;
+        if (i >= _N) return _N+1;
+        return (size_t) i + 1;
       }
 
-      /// Call operator returns estimated bin index (offset so 0 == underflow)
-      int _est(double x) const {
-        return (int) floor(_m * (fastlog2(x) - _c));
+      /// Return offset bin index estimate, with 0 = underflow and Nbins+1 = overflow
+      size_t operator() (double x) const {
+        return estindex(x);
       }
 
     protected:
+
+      /// Set the offset and scale from the transformed range
+      void _init(double xlow, double xhigh) {
+        _c = t(xlow);
+        _m = _N / (t(xhigh) - _c);
+      }
+
+      /// @brief Fit the piecewise-linear model to the edges, with max error @a maxerr at each edge
+      ///
+      /// Segments are grown greedily, narrowing the range of slopes that keep
+      /// every edge of the segment within @a maxerr of its index, and a new
+      /// segment is started when no slope fits.
+      void _fitPiecewise(const std::vector<double>& edges, size_t maxerr);
+
+      /// Evaluate the piecewise-linear model, clamped between the indices of its segment's first and next edges
+      double _piecewise(double x) const {
+        // Branchless count of the segments starting at or below x
+        if (_segx.empty() || !(x >= _segx[0])) return -1;
+        const double* base = _segx.data();
+        size_t len = _segx.size();
+        while (len > 1) {
+          const size_t half = len / 2;
+          base = (base[half] <= x) ? base + half : base;
+          len -= half;
+        }
+        const size_t k = base - _segx.data() + 1;
+        const double y = _segy[k-1] + _segslope[k-1] * (x - _segx[k-1]);
+        return std::max(_segy[k-1], std::min(y, _segymax[k-1]));
+      }
+
+      /// Number of bins
+      size_t _N;
+
+      /// Transform type and exponent
+      EstTransform _transform;
+      double _power;
+
+      /// User-supplied transform, for EST_USER
+      std::function<double(double)> _fn;
+
+      /// Max index error of an EST_PIECEWISE model
+      size_t _maxerr;
+
+      /// Transformed lower edge and inverse bin width
       double _c, _m;
+
+      /// First edge, its index, the slope, and the next segment's first index, for each EST_PIECEWISE segment
+      std::vector<double> _segx, _segy, _segslope, _segymax;
     };
 
 
@@ -128,6 +222,11 @@ namespace YODA {
     /// considerably faster for regular (logarithmic or linear) and near-regular
     /// binnings. Comparable performance for irregular binnings.
     ///
+    /// Linearly regular binnings skip the search entirely, and compute the index
+    /// arithmetically as floor((x-xmin)/width). Only values within rounding
+    /// distance of a bin edge are checked against the edge itself, so that the
+    /// result is always identical to that of the search.
+    ///
     /// The reason this works is that linear search is faster than bisection
     /// search up to about 32-64 elements. So we make a guess, and we then do a
     /// linear search. If that fails, then we bisect on the remainder,
@@ -141,68 +240,100 @@ namespace YODA {
 
       /// Default constructor
       /// @todo What's the point? Remove?
-      BinSearcher() {
-        _est = std::make_shared<LinEstimator>(0, 0, 1);
-      }
+      BinSearcher() { }
 
-      /// Copy constructor
-      BinSearcher(const BinSearcher& bs) {
-        _est = bs._est;
-        _edges = bs._edges;
+      /// Explicit constructor, specifying the edges and a built-in or learned estimation transform
+      BinSearcher(const std::vector<double>& edges, EstTransform transform, double power=1) {
+        _updateEdges(edges);
+        if (edges.empty()) return;
+        if (transform == EST_PIECEWISE) {
+          _est = TransformEstimator(edges);
+        } else {
+          _est = TransformEstimator(edges.size()-1, edges.front(), edges.back(), transform, power);
+        }
+        _estedges = edges.size();
       }
 
-      // /// Explicit constructor, specifying the edges and estimation strategy
-      // BinSearcher(const std::vector<double>& edges, bool log) {
-      //   _updateEdges(edges);
-      //   // Internally use a log or linear estimator as requested
-      //   if (log) {
-      //     _est.reset(new LogEstimator(edges.size()-1, edges.front(), edges.back()));
-      //   } else {
-      //     _est.reset(new LinEstimator(edges.size()-1, edges.front(), edges.back()));
-      //   }
-      // }
+      /// Explicit constructor, specifying the edges and a monotonically increasing estimation transform
+      BinSearcher(const std::vector<double>& edges, const std::function<double(double)>& transform) {
+        _updateEdges(edges);
+        if (edges.empty()) return;
+        _est = TransformEstimator(edges.size()-1, edges.front(), edges.back(), transform);
+        _estedges = edges.size();
+      }
 
-      /// Fully automatic constructor: give bin edges and it does the rest!
+      /// @brief Fully automatic constructor: give bin edges and it does the rest!
+      ///
+      /// The estimation transform is chosen from those valid over the edge range
+      /// (linear, log, sqrt, x^2, x^3 and logit) by the smallest mean deviation of
+      /// the estimated indices of the edges from their true indices, scored on at
+      /// most EST_SCORE_SAMPLES edges. Irregular binnings also try a learned
+      /// piecewise-linear estimator, whose deviation is penalised by half a bin
+      /// per step of its segment search, if no transform already does better.
       BinSearcher(const std::vector<double>& edges) {
         _updateEdges(edges);
+        if (!edges.empty()) _chooseEstimator(edges);
+      }
 
-        if (edges.empty()) {
-          _est = std::make_shared<LinEstimator>(0, 0, 1);
-        } else if (edges.front() <= 0.0) {
-          _est = std::make_shared<LinEstimator>(edges.size()-1, edges.front(), edges.back());
-        } else {
-          LinEstimator linEst(edges.size()-1, edges.front(), edges.back());
-          LogEstimator logEst(edges.size()-1, edges.front(), edges.back());
-
-          // Calculate mean index estimate deviations from the correct answers (for bin edges)
-          double logsum = 0, linsum = 0;
-          for (size_t i = 0; i < edges.size(); i++) {
-            logsum += logEst(edges[i]) - i;
-            linsum += linEst(edges[i]) - i;
-          }
-          const double log_avg = logsum / edges.size();
-          const double lin_avg = linsum / edges.size();
-
-          // This also implicitly works for NaN returned from the log There is a
-          // subtle bug here if the if statement is the other way around, as
-          // (nan < linsum) -> false always.  But (nan > linsum) -> false also.
-          if (log_avg < lin_avg) { //< Use log estimator if its avg performance is better than lin
-            _est = std::make_shared<LogEstimator>(logEst);
-          } else { // Else use linear estimation
-            _est = std::make_shared<LinEstimator>(linEst);
-          }
+      /// @brief Constructor for new edges of a binning previously searched by @a prev
+      ///
+      /// The estimation transform of @a prev is reused over the new edges, so
+      /// that an axis chooses it once rather than on every change to its bins.
+      /// It is chosen afresh if @a prev chose it from fewer than half as many
+      /// edges, or if it is not valid over the new range.
+      BinSearcher(const std::vector<double>& edges, const BinSearcher& prev) {
+        _updateEdges(edges);
+        if (edges.empty()) return;
+        if (prev._estedges > 0 && 2*prev._estedges >= edges.size()) {
+          _est = TransformEstimator(edges, prev._est);
+          _estedges = prev._estedges;
+          if (_est.valid()) return;
+        }
+        _chooseEstimator(edges);
+      }
+
+
+      /// The estimator used for the initial bin index guess
+      const TransformEstimator& estimator() const { return _est; }
+
+      /// Fraction of the values @a xs for which the estimator guesses the right bin at once
+      double estimatorHitRate(const std::vector<double>& xs) const {
+        if (xs.empty() || _edges.size() < 2) return 0;
+        size_t nhits = 0;
+        for (double x : xs) {
+          if (std::min(_est.estindex(x), _edges.size()-1) == index(x)) nhits += 1;
         }
+        return nhits / (double) xs.size();
       }
 
 
       /// Look up a bin index
       /// @note Returned indices are offset by one, so 0 = underflow and Nbins+1 = overflow
       size_t index(double x) const {
+        // Exact arithmetic lookup for regular binnings
+        if (_regular) {
+          if (!(x >= _reglow)) return 0;
+          if (x >= _reghigh) return _edges.size()-2;
+          const double t = (x - _reglow) * _reginvwidth;
+          const size_t i = (size_t) t;
+          const double frac = t - i;
+          // Near an edge, let the edge itself decide (_edges[i+1] is the lower edge of bin i)
+          if (frac < _regtol) return (x >= _edges[i+1]) ? i+1 : i;
+          if (frac > 1 - _regtol) return (x >= _edges[i+2]) ? i+2 : i+1;
+          return i + 1;
+        }
+
+        // Infinities and NaNs are beyond the reach of the estimate and searches
+        if (!(x > _edges.front() && x < _edges.back())) return (x == _edges.back()) ? _edges.size()-2 : 0;
+
         // Get initial estimate
-        size_t index = std::min(_est->estindex(x),_edges.size()-1);
+        size_t index = std::min(_est.estindex(x),_edges.size()-1);
         // Return now if this is the correct bin
         if (x >= _edges[index] && x < _edges[index+1]) return index;
 
+        // Large binnings skip the linear searches, whose scattered reads miss the cache anyway
+        if (!_btreelevels.empty() && _est.transform() != EST_PIECEWISE) return _btreesearch(x);
+
         // Otherwise refine the estimate, if x is not exactly on a bin edge
         if (x > _edges[index]) {
           const ssize_t newindex = _linsearch_forward(index, x, SEARCH_SIZE);
@@ -216,6 +347,27 @@ namespace YODA {
         return index;
       }
 
+      /// @brief Look up the bin indices of @a n values in one pass
+      ///
+      /// The results are identical to calling index() on each value (with NaNs
+      /// mapped to the underflow), but are computed without data-dependent branches.
+      /// Small binnings compare each value to all edges with SSE2 or AVX2 vector
+      /// instructions, chosen at runtime unless given by @a level and falling back
+      /// to portable scalar code. Larger binnings use a bisection interleaved over
+      /// several values at a time, and finish it by comparing each value to its
+      /// last BATCH_LINEAR_THRESHOLD edges in the same way.
+      void indices(const double* xs, size_t n, size_t* out, SIMDLevel level=SIMD_AUTO) const {
+        // Regular binnings are already branch-light and edge-free, and best inlined
+        if (_regular) {
+          for (size_t k = 0; k < n; ++k) out[k] = index(xs[k]);
+        } else {
+          _indices(xs, n, out, level);
+        }
+      }
+
+      /// The best instruction set available for indices() on this CPU
+      static SIMDLevel simdLevel();
+
       /// Look up an in-range bin index
       /// @note This returns a *normal* index starting with zero for the first in-range bin
       ssize_t index_inrange(double x) const {
@@ -234,6 +386,9 @@ namespace YODA {
       /// How many bin edges in this searcher?
       size_t size() const { return _edges.size(); }
 
+      /// Are the edges regular enough for exact arithmetic index lookup?
+      bool regular() const { return _regular; }
+
 
       /// Check if two BinSearcher objects have the same edges
       bool same_edges(const BinSearcher& other) const {
@@ -300,6 +455,12 @@ namespace YODA {
 
     protected:
 
+      /// Batched search kernel dispatch for indices()
+      void _indices(const double* xs, size_t n, size_t* out, SIMDLevel level) const;
+
+      /// Choose the estimator for the given non-empty edges, as described for the automatic constructor
+      void _chooseEstimator(const std::vector<double>& edges);
+
       /// Set the edges array and related member variables
       void _updateEdges(const std::vector<double>& edges) {
         // Array of in-range edges, plus underflow and overflow sentinels
@@ -310,6 +471,39 @@ namespace YODA {
         _edges[0] = -std::numeric_limits<double>::infinity();
         for (size_t i = 0; i < edges.size(); i++) _edges[i+1] = edges[i];
         _edges[_edges.size()-1] = std::numeric_limits<double>::infinity();
+
+        _checkRegular();
+        _buildBTree();
+      }
+
+
+      /// @brief Enable arithmetic index lookup if the binning is regular
+      ///
+      /// The arithmetic position (x-xmin)/width is monotonic in x, so its rounding
+      /// error is bounded by the largest deviation found at the edges and at the
+      /// doubles just below them. Values closer than twice that to an edge are
+      /// resolved by comparing to the edge, and all others are exact.
+      void _checkRegular() {
+        _regular = false;
+        const size_t nedges = _edges.size() - 2;
+        if (nedges < 2) return;
+        _reglow = _edges[1];
+        _reghigh = _edges[nedges];
+        if (!std::isfinite(_reglow) || !std::isfinite(_reghigh)) return;
+        _reginvwidth = (nedges - 1) / (_reghigh - _reglow);
+        if (!std::isfinite(_reginvwidth)) return;
+        double maxdev = 0;
+        for (size_t i = 1; i <= nedges; ++i) {
+          const double iedge = i - 1;
+          maxdev = std::max(maxdev, std::fabs((_edges[i] - _reglow) * _reginvwidth - iedge));
+          if (i > 1) {
+            const double xbelow = std::nextafter(_edges[i], _reglow);
+            maxdev = std::max(maxdev, std::fabs((xbelow - _reglow) * _reginvwidth - iedge));
+          }
+          if (!(maxdev < 0.1)) return;
+        }
+        _regtol = 2*maxdev + 1e-12;
+        _regular = true;
       }
 
 
@@ -346,6 +540,17 @@ namespace YODA {
       }
 
 
+      /// @brief Build the B-tree index for large irregular binnings
+      ///
+      /// Each level holds the first edge of every node of the level below, in
+      /// nodes of BTREE_NODE_SIZE edges, with the in-range edges themselves as
+      /// the bottom level. A search then reads one cache line per level rather
+      /// than one per bisection step.
+      void _buildBTree();
+
+      /// Search through the B-tree index, returning the same offset index as index()
+      size_t _btreesearch(double x) const;
+
       /// Truncated bisection search, adapted from C++ std lib implementation
       size_t _bisect(double x, size_t imin, size_t imax) const {
         size_t len = imax - imin;
@@ -368,11 +573,27 @@ namespace YODA {
     protected:
 
       /// Estimator object to be used for making fast bin index guesses
-      std::shared_ptr<Estimator> _est;
+      TransformEstimator _est;
+
+      /// Number of edges from which the estimator transform was chosen, or 0 if none
+      size_t _estedges = 0;
 
       /// List of bin edges, including +- inf at either end
       std::vector<double> _edges;
 
+      /// Whether to use the arithmetic index lookup for regular binnings
+      bool _regular = false;
+
+      /// Range, inverse bin width and edge-rounding tolerance for regular binnings
+      double _reglow = 0, _reghigh = 0, _reginvwidth = 0, _regtol = 0;
+
+      /// @brief Upper levels of the B-tree index, top first, with each NaN-padded to whole nodes
+      /// @note Empty unless there are at least BTREE_THRESHOLD edges
+      std::vector<double> _btree;
+
+      /// Start of each B-tree level in _btree, top first
+      std::vector<size_t> _btreelevels;
+
     };
 
 
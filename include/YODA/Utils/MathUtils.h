@@ -340,6 +340,49 @@ namespace YODA {
   }
 
 
+  /// Schemes for choosing bin edges from a sample of values with autospace
+  enum AutoBinning { AUTOBIN_LIN, AUTOBIN_LOG, AUTOBIN_QUANTILE };
+
+
+  /// @brief Make a list of @a nbins + 1 edges of bins which contain all finite values of a @a sample.
+  ///
+  /// AUTOBIN_LIN spaces the edges uniformly, AUTOBIN_LOG uniformly in log(x), and
+  /// AUTOBIN_QUANTILE at quantiles of the sample, so that bins contain similar
+  /// numbers of values. Log spacing falls back to uniform if any value is not
+  /// positive, and quantile edges shared by many equal values are merged, giving
+  /// fewer bins. The top edge is just above the largest value, so that it is in
+  /// range, and an empty or constant sample gives a unit range.
+  inline std::vector<double> autospace(size_t nbins, const std::vector<double>& sample, AutoBinning mode=AUTOBIN_LIN) {
+    assert(nbins > 0);
+    std::vector<double> xs;
+    for (double x : sample) if (std::isfinite(x)) xs.push_back(x);
+    if (xs.empty()) return linspace(nbins, 0, 1);
+    std::sort(xs.begin(), xs.end());
+    double xmin = xs.front(), xmax = xs.back();
+    if (xmax == xmin) {
+      xmin -= (xmin != 0) ? 0.5*std::fabs(xmin) : 0.5;
+      xmax += (xmax != 0) ? 0.5*std::fabs(xmax) : 0.5;
+    }
+    if (mode == AUTOBIN_LOG && xmin > 0) {
+      std::vector<double> rtn = logspace(nbins, xmin, xmax);
+      rtn.back() = std::nextafter(xmax, DBL_MAX);
+      return rtn;
+    }
+    if (mode == AUTOBIN_QUANTILE) {
+      std::vector<double> rtn{xmin};
+      for (size_t i = 1; i < nbins; ++i) {
+        const double q = xs[(i * xs.size()) / nbins];
+        if (q > rtn.back()) rtn.push_back(q);
+      }
+      rtn.push_back(std::nextafter(xmax, DBL_MAX));
+      return rtn;
+    }
+    std::vector<double> rtn = linspace(nbins, xmin, xmax);
+    rtn.back() = std::nextafter(xmax, DBL_MAX);
+    return rtn;
+  }
+
+
   /// @brief Return the bin index of the given value, @a val, given a vector of bin edges
   ///
   /// NB. The @a binedges vector must be sorted
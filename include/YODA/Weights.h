@@ -9,14 +9,62 @@
 #include "YODA/Exceptions.h"
 #include <vector>
 #include <string>
-#include <map>
+#include <memory>
+#include <iterator>
+#include <cstddef>
+#include <utility>
 #include <ostream>
 
 namespace YODA {
 
 
+  /// @brief The sorted, immutable set of keys shared by compatible Weights
+  ///
+  /// Schemas are interned: every Weights with the same keys refers to the
+  /// same schema object, so compatibility is usually a pointer comparison.
+  class WeightsSchema {
+  public:
+
+    typedef std::shared_ptr<const WeightsSchema> Ptr;
+
+    /// @brief The shared schema for a set of keys, which need not be sorted or unique
+    ///
+    /// Repeated interning of the same keys on one thread skips the registry
+    /// lock, but per-event Weights are best made from a schema interned once.
+    static Ptr intern(std::vector<std::string> keys);
+
+    /// Sorted list of the keys
+    const std::vector<std::string>& keys() const { return _keys; }
+
+    /// Number of keys
+    size_t size() const { return _keys.size(); }
+
+    /// Position of @a key in the sorted keys, or npos if it is not present
+    size_t index(const std::string& key) const;
+
+    /// Index returned for keys which are not present
+    static const size_t npos = static_cast<size_t>(-1);
+
+    /// Constructor from sorted, unique keys: use intern() instead
+    explicit WeightsSchema(const std::vector<std::string>& sortedkeys)
+      : _keys(sortedkeys)
+    { }
+
+  private:
+
+    std::vector<std::string> _keys;
+
+  };
+
+
+
   /// @brief A named, vectorised generalisation of an event weight.
   ///
+  /// The values are stored flat, in the order of the sorted keys of a shared
+  /// WeightsSchema, so making a Weights for each event does not allocate per
+  /// key, and arithmetic between Weights with the same keys is a plain
+  /// elementwise loop over the values.
+  ///
   /// @todo Accept general Boost.Ranges as constructor args... but start with literal arrays for convenience
   /// @todo Autogenerate numerical names if not given
   class Weights {
@@ -26,19 +74,25 @@ namespace YODA {
     /// @{
 
     Weights(const Weights& other)
-      : _values(other._values)
+      : _schema(other._schema), _values(other._values)
     {  }
 
     /// Convenience auto-constructor from a single double, since that's the commonest use case.
-    Weights(double value) {
-      _values["0"] = value;
-    }
+    Weights(double value)
+      : _schema(_singleSchema()), _values(1, value)
+    {  }
 
     /// Constructor from a vector of key/value pairs
     Weights(const std::vector<std::pair<std::string, double> >& keys_values) {
-      for (std::vector<std::pair<std::string, double> >::const_iterator i = keys_values.begin(); i != keys_values.end(); ++i) {
-        _values[i->first] = i->second;
+      std::vector<std::string> keys;
+      std::vector<double> values;
+      keys.reserve(keys_values.size());
+      values.reserve(keys_values.size());
+      for (const std::pair<std::string, double>& kv : keys_values) {
+        keys.push_back(kv.first);
+        values.push_back(kv.second);
       }
+      _init(keys, values);
     }
 
     /// Constructor from vectors of keys and values
@@ -46,60 +100,95 @@ namespace YODA {
       if (keys.size() != values.size()) {
         throw WeightError("Mismatch in lengths of keys and values vectors in Weights constructor");
       }
-      for (size_t i = 0; i < keys.size(); ++i) {
-        _values[keys[i]] = values[i];
-      }
+      _init(keys, values);
     }
 
     /// Constructor from vectors of keys and a single value, defaulting to 0.0
-    Weights(const std::vector<std::string>& keys, double value=0.0) {
-      for (std::vector<std::string>::const_iterator i = keys.begin(); i != keys.end(); ++i) {
-        _values[*i] = value;
+    Weights(const std::vector<std::string>& keys, double value=0.0)
+      : _schema(WeightsSchema::intern(keys)), _values(_schema->size(), value)
+    {  }
+
+    /// @brief Constructor from a schema and values in the order of its keys
+    ///
+    /// The cheapest way to make a Weights per event, with the schema made once.
+    Weights(const WeightsSchema::Ptr& schema, const std::vector<double>& values)
+      : _schema(schema), _values(values)
+    {
+      if (!schema) {
+        throw WeightError("Null schema in Weights constructor");
+      }
+      if (values.size() != schema->size()) {
+        throw WeightError("Mismatch in lengths of schema and values vector in Weights constructor");
       }
     }
 
+    /// Copy assignment
+    Weights& operator = (const Weights& other) {
+      _schema = other._schema;
+      _values = other._values;
+      return *this;
+    }
+
     /// @}
 
   public:
 
 
-    /// @todo Sorted iterators of pair<std::string, double>
-
     /// @name Accessors
     /// @{
 
-    typedef std::map<std::string, double>::iterator iterator;
-    typedef std::map<std::string, double>::const_iterator const_iterator;
-    iterator begin() { return _values.begin(); }
-    const_iterator begin() const { return _values.begin(); }
-    iterator end() { return _values.end(); }
-    const_iterator end() const { return _values.end(); }
+    /// @brief Iterator over (key, value) pairs, in key order
+    ///
+    /// The pairs are made on dereferencing, so it is an input iterator.
+    template <typename W, typename V>
+    class Iterator {
+    public:
+      typedef std::input_iterator_tag iterator_category;
+      typedef std::pair<const std::string&, V&> value_type;
+      typedef std::ptrdiff_t difference_type;
+      typedef value_type reference;
+      struct Arrow {
+        value_type kv;
+        const value_type* operator -> () const { return &kv; }
+      };
+      typedef Arrow pointer;
+      Iterator(W* w, size_t i) : _w(w), _i(i) { }
+      value_type operator * () const { return value_type(_w->_schema->keys()[_i], _w->_values[_i]); }
+      Arrow operator -> () const { return Arrow{**this}; }
+      Iterator& operator ++ () { ++_i; return *this; }
+      Iterator operator ++ (int) { Iterator rtn = *this; ++_i; return rtn; }
+      bool operator == (const Iterator& other) const { return _i == other._i && _w == other._w; }
+      bool operator != (const Iterator& other) const { return !(*this == other); }
+    private:
+      W* _w;
+      size_t _i;
+    };
+
+    typedef Iterator<Weights, double> iterator;
+    typedef Iterator<const Weights, const double> const_iterator;
+    iterator begin() { return iterator(this, 0); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    iterator end() { return iterator(this, size()); }
+    const_iterator end() const { return const_iterator(this, size()); }
 
     double& operator [] (const std::string& key) {
-      if (_values.find(key) == _values.end()) {
-        throw WeightError("No weight found with supplied name");
-      }
-      return _values[key];
+      return _values[_index(key)];
     }
     const double& operator [] (const std::string& key) const {
-      const_iterator rtn = _values.find(key);
-      if (rtn == _values.end()) {
-        throw WeightError("No weight found with supplied name");
-      }
-      return rtn->second;
+      return _values[_index(key)];
     }
 
     double& operator [] (size_t index) {
       if (index >= size()) {
         throw WeightError("Requested weight index is larger than the weights collection");
       }
-      return _values[keys()[index]];
+      return _values[index];
     }
     const double& operator [] (size_t index) const {
       if (index >= size()) {
         throw WeightError("Requested weight index is larger than the weights collection");
       }
-      return _values.find(keys()[index])->second;
+      return _values[index];
     }
 
     /// Number of weights keys
@@ -109,22 +198,17 @@ namespace YODA {
 
     /// Sorted list of weight keys
     std::vector<std::string> keys() const {
-      std::vector<std::string> rtn;
-      rtn.reserve(size());
-      for (const_iterator i = begin(); i != end(); ++i) {
-        rtn.push_back(i->first);
-      }
-      return rtn;
+      return _schema ? _schema->keys() : std::vector<std::string>();
     }
 
     /// List of weight values, in the order of the sorted keys
-    std::vector<double> values() const {
-      std::vector<double> rtn;
-      rtn.reserve(size());
-      for (const_iterator i = begin(); i != end(); ++i) {
-        rtn.push_back(i->second);
-      }
-      return rtn;
+    const std::vector<double>& values() const {
+      return _values;
+    }
+
+    /// The shared key schema
+    const WeightsSchema::Ptr& schema() const {
+      return _schema;
     }
 
     /// @}
@@ -135,65 +219,49 @@ namespace YODA {
 
     /// Add another weights to this
     Weights& operator += (const Weights& toAdd) {
-      if (keys().empty()) _initToMatch(toAdd);
-      if (keys() != toAdd.keys()) {
-        throw WeightError("Mismatch in args to Weights += operator");
-      }
-      for (size_t i = 0; i < size(); ++i) {
-        _values[keys()[i]] += toAdd[keys()[i]];
-      }
+      _matchSchema(toAdd, "+=");
+      double* v = _values.data();
+      const double* o = toAdd._values.data();
+      for (size_t i = 0; i < _values.size(); ++i) v[i] += o[i];
       return *this;
     }
 
     /// Subtract another weights from this
     Weights& operator -= (const Weights& toSubtract) {
-      if (keys().empty()) _initToMatch(toSubtract);
-      if (keys() != toSubtract.keys()) {
-        throw WeightError("Mismatch in args to Weights -= operator");
-      }
-      for (size_t i = 0; i < size(); ++i) {
-        _values[keys()[i]] -= toSubtract[keys()[i]];
-      }
+      _matchSchema(toSubtract, "-=");
+      double* v = _values.data();
+      const double* o = toSubtract._values.data();
+      for (size_t i = 0; i < _values.size(); ++i) v[i] -= o[i];
       return *this;
     }
 
     /// Multiply by another weights
     Weights& operator *= (const Weights& toMultiplyBy) {
-      if (keys().empty()) _initToMatch(toMultiplyBy);
-      if (keys() != toMultiplyBy.keys()) {
-        throw WeightError("Mismatch in args to Weights *= operator");
-      }
-      for (size_t i = 0; i < size(); ++i) {
-        _values[keys()[i]] *= toMultiplyBy[keys()[i]];
-      }
+      _matchSchema(toMultiplyBy, "*=");
+      double* v = _values.data();
+      const double* o = toMultiplyBy._values.data();
+      for (size_t i = 0; i < _values.size(); ++i) v[i] *= o[i];
       return *this;
     }
 
     /// Divide by another weights
     Weights& operator /= (const Weights& toDivideBy) {
-      if (keys().empty()) _initToMatch(toDivideBy);
-      if (keys() != toDivideBy.keys()) {
-        throw WeightError("Mismatch in args to Weights /= operator");
-      }
-      for (size_t i = 0; i < size(); ++i) {
-        _values[keys()[i]] /= toDivideBy[keys()[i]];
-      }
+      _matchSchema(toDivideBy, "/=");
+      double* v = _values.data();
+      const double* o = toDivideBy._values.data();
+      for (size_t i = 0; i < _values.size(); ++i) v[i] /= o[i];
       return *this;
     }
 
     /// Multiply by a double
     Weights& operator *= (double toMultiplyBy) {
-      for (size_t i = 0; i < size(); ++i) {
-        _values[keys()[i]] *= toMultiplyBy;
-      }
+      for (double& v : _values) v *= toMultiplyBy;
       return *this;
     }
 
     /// Divide by a double
     Weights& operator /= (double toDivideBy) {
-      for (size_t i = 0; i < size(); ++i) {
-        _values[keys()[i]] /= toDivideBy;
-      }
+      for (double& v : _values) v /= toDivideBy;
       return *this;
     }
 
@@ -213,7 +281,7 @@ namespace YODA {
 
     /// Equals
     bool operator == (const Weights& other) const {
-      return this->_values == other._values;
+      return _sameKeys(other) && _values == other._values;
     }
 
     /// Not equals
@@ -229,20 +297,46 @@ namespace YODA {
 
   private:
 
-    /// Initialise an empty list of weights keys to match those of another Weights object
-    void _initToMatch(const Weights& other) {
-      if (keys().empty()) {
-        throw LogicError("Weights::_initToMatch shouldn't ever be called if there are already defined weights keys");
+    /// Set from possibly unsorted keys and their values, the last of any repeated key winning
+    void _init(const std::vector<std::string>& keys, const std::vector<double>& values);
+
+    /// Position of @a key, throwing if it is not present
+    size_t _index(const std::string& key) const {
+      const size_t i = _schema ? _schema->index(key) : WeightsSchema::npos;
+      if (i == WeightsSchema::npos) throw WeightError("No weight found with supplied name");
+      return i;
+    }
+
+    /// Whether the keys are the same as those of @a other
+    bool _sameKeys(const Weights& other) const {
+      if (_schema == other._schema) return true;
+      return keys() == other.keys();
+    }
+
+    /// Check the keys match those of @a other, an empty Weights taking them on as zeros
+    void _matchSchema(const Weights& other, const char* op) {
+      if (_schema == other._schema) return;
+      if (_values.empty()) {
+        _schema = other._schema;
+        _values.assign(other._values.size(), 0.0);
+        return;
       }
-      for (size_t i = 0; i < other.size(); ++i) {
-        _values[other.keys()[i]] = 0;
+      if (!_sameKeys(other)) {
+        throw WeightError(std::string("Mismatch in args to Weights ") + op + " operator");
       }
     }
 
+    /// The interned schema of a single unnamed weight
+    static const WeightsSchema::Ptr& _singleSchema();
+
 
   private:
 
-    std::map<std::string, double> _values;
+    /// The shared keys
+    WeightsSchema::Ptr _schema;
+
+    /// The values, in the order of the schema keys
+    std::vector<double> _values;
 
   };
 
@@ -301,7 +395,7 @@ namespace YODA {
   /// Divide a double by a Weights
   /// @todo Is this really needed?
   inline Weights operator / (double a, const Weights& w) {
-    Weights tmp(w.keys(), a);
+    Weights tmp(w.schema(), std::vector<double>(w.size(), a));
     tmp /= w;
     return tmp;
   }
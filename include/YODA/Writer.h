@@ -10,6 +10,12 @@
 #include "YODA/Counter.h"
 #include "YODA/Histo1D.h"
 #include "YODA/Histo2D.h"
+#include "YODA/CountHisto1D.h"
+#include "YODA/CountHisto2D.h"
+#include "YODA/MultiCounter.h"
+#include "YODA/MultiHisto1D.h"
+#include "YODA/MultiHisto2D.h"
+#include "YODA/MultiProfile1D.h"
 #include "YODA/Profile1D.h"
 #include "YODA/Profile2D.h"
 #include "YODA/Scatter1D.h"
@@ -132,7 +138,18 @@ namespace YODA {
           stream.open(filename.c_str());
           if (stream.fail())
             throw WriteError("Writing to filename " + filename + " failed");
-          write(stream, vec);
+          // Record the objects' positions as they are written, if the file may be indexed
+          _indexing = !compress && _indexthreshold > 0;
+          if (_indexing) startIndex();
+          try {
+            write(stream, vec);
+            stream.close();
+            if (_indexing) writeIndex(filename);
+          } catch (...) {
+            _indexing = false;
+            throw;
+          }
+          _indexing = false;
         } catch (std::ofstream::failure& e) {
           throw WriteError("Writing to filename " + filename + " failed: " + e.what());
         }
@@ -154,6 +171,11 @@ namespace YODA {
       _precision = precision;
     }
 
+    /// Precision of numerical quantities in this writer's output.
+    int precision() const {
+      return _precision;
+    }
+
     /// Set precision of numerical quantities for current AO in this writer's output.
     void setAOPrecision(bool needsDP = false) {
       _aoprecision = needsDP? std::numeric_limits<double>::max_digits10 : _precision;
@@ -164,9 +186,31 @@ namespace YODA {
       _compress = compress;
     }
 
+    /// @brief Index uncompressed output files of at least @a nbytes bytes
+    ///
+    /// Writers of formats with random access then write a sidecar index of
+    /// the objects' positions alongside large enough files, for instant
+    /// lookups by readers. Indexing is off by default, and zero turns it
+    /// off again.
+    void setIndexThreshold(size_t nbytes) {
+      _indexthreshold = nbytes;
+    }
+
 
   protected:
 
+    /// Default constructor, without indexing
+    Writer() : _indexthreshold(0), _indexing(false) { }
+
+    /// Forget any object positions recorded before a file is written with indexing on
+    virtual void startIndex() {}
+
+    /// @brief Write any sidecar index for the newly written uncompressed file @a filename
+    ///
+    /// Only called if the file was written with indexing on, so that the
+    /// writer has recorded the objects' positions while writing them.
+    virtual void writeIndex(const std::string&) {}
+
     /// @name Main writer elements
     /// @{
 
@@ -203,6 +247,48 @@ namespace YODA {
     virtual void writeScatter2D(std::ostream& os, const Scatter2D& s) = 0;
     virtual void writeScatter3D(std::ostream& os, const Scatter3D& s) = 0;
 
+    /// Write a counts-only 1D histogram, by default as the equivalent Histo1D
+    virtual void writeCountHisto1D(std::ostream& os, const CountHisto1D& h) {
+      writeHisto1D(os, mkHisto1D(h));
+    }
+
+    /// Write a counts-only 2D histogram, by default as the equivalent Histo2D
+    virtual void writeCountHisto2D(std::ostream& os, const CountHisto2D& h) {
+      writeHisto2D(os, mkHisto2D(h));
+    }
+
+    /// Write a multi-weight counter, by default as one Counter per weight stream
+    virtual void writeMultiCounter(std::ostream& os, const MultiCounter& c) {
+      for (size_t i = 0; i < c.numStreams(); ++i) {
+        if (i > 0) os << "\n";
+        writeCounter(os, c.counter(i));
+      }
+    }
+
+    /// Write a multi-weight 1D histogram, by default as one Histo1D per weight stream
+    virtual void writeMultiHisto1D(std::ostream& os, const MultiHisto1D& h) {
+      for (size_t i = 0; i < h.numStreams(); ++i) {
+        if (i > 0) os << "\n";
+        writeHisto1D(os, h.histo(i));
+      }
+    }
+
+    /// Write a multi-weight 2D histogram, by default as one Histo2D per weight stream
+    virtual void writeMultiHisto2D(std::ostream& os, const MultiHisto2D& h) {
+      for (size_t i = 0; i < h.numStreams(); ++i) {
+        if (i > 0) os << "\n";
+        writeHisto2D(os, h.histo(i));
+      }
+    }
+
+    /// Write a multi-weight 1D profile, by default as one Profile1D per weight stream
+    virtual void writeMultiProfile1D(std::ostream& os, const MultiProfile1D& p) {
+      for (size_t i = 0; i < p.numStreams(); ++i) {
+        if (i > 0) os << "\n";
+        writeProfile1D(os, p.profile(i));
+      }
+    }
+
     /// @}
 
 
@@ -212,6 +298,12 @@ namespace YODA {
     /// Compress the output?
     bool _compress;
 
+    /// Minimum size of output files to index, or zero for no indexing
+    size_t _indexthreshold;
+
+    /// Record the positions of the objects being written to a file, for its index?
+    bool _indexing;
+
   };
 
 
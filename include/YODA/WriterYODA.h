@@ -8,6 +8,7 @@
 
 #include "YODA/AnalysisObject.h"
 #include "YODA/Writer.h"
+#include "YODA/Index.h"
 
 namespace YODA {
 
@@ -28,20 +29,45 @@ namespace YODA {
     void writeCounter(std::ostream& stream, const Counter& c);
     void writeHisto1D(std::ostream& stream, const Histo1D& h);
     void writeHisto2D(std::ostream& stream, const Histo2D& h);
+    void writeCountHisto1D(std::ostream& stream, const CountHisto1D& h);
+    void writeCountHisto2D(std::ostream& stream, const CountHisto2D& h);
     void writeProfile1D(std::ostream& stream, const Profile1D& p);
     void writeProfile2D(std::ostream& stream, const Profile2D& p);
     void writeScatter1D(std::ostream& stream, const Scatter1D& s);
     void writeScatter2D(std::ostream& stream, const Scatter2D& s);
     void writeScatter3D(std::ostream& stream, const Scatter3D& s);
 
+    /// Forget the positions recorded for any earlier output
+    void startIndex() {
+      _indexed.clear();
+      _extents.clear();
+    }
+
+    /// @brief Write the sidecar index if the file is at least the index threshold in size
+    ///
+    /// The index is made from the positions recorded while writing. Any old
+    /// sidecar index of a smaller file by this name is removed instead.
+    void writeIndex(const std::string& filename);
+
 
   private:
 
     void _writeAnnotations(std::ostream& os, const AnalysisObject& ao);
 
+    /// Position in @a os of the block about to be written, if positions are being recorded
+    std::streamoff _blockStart(std::ostream& os) const;
+
+    /// Record the position and bin count of the @a type block of @a ao just written to @a os from @a start
+    void _indexBlock(std::ostream& os, std::streamoff start, const std::string& type,
+                     const AnalysisObject& ao, int nbins);
+
     /// Private since it's a singleton.
     WriterYODA() { }
 
+    /// Bin counts and positions of the blocks written so far, by type and path
+    Index::AOIndex _indexed;
+    Index::ExtentIndex _extents;
+
   };
 
 
@@ -9,11 +9,18 @@
 #include "YODA/Counter.h"
 #include "YODA/Histo1D.h"
 #include "YODA/Histo2D.h"
+#include "YODA/CountHisto1D.h"
+#include "YODA/CountHisto2D.h"
+#include "YODA/MultiCounter.h"
+#include "YODA/MultiHisto1D.h"
+#include "YODA/MultiHisto2D.h"
+#include "YODA/MultiProfile1D.h"
 #include "YODA/Profile1D.h"
 #include "YODA/Profile2D.h"
 #include "YODA/Scatter1D.h"
 #include "YODA/Scatter2D.h"
 #include "YODA/Scatter3D.h"
 #include "YODA/IO.h"
+#include "YODA/Merge.h"
 
 #endif
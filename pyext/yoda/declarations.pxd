@@ -28,6 +28,11 @@ cdef extern from "YODA/Utils/MathUtils.h" namespace "YODA":
     # bool fuzzyLessEquals(double a, double b, double tolerance)
     vector[double] linspace(size_t nbins, double start, double end)
     vector[double] logspace(size_t nbins, double start, double end)
+    cdef enum AutoBinning:
+        AUTOBIN_LIN
+        AUTOBIN_LOG
+        AUTOBIN_QUANTILE
+    vector[double] autospace(size_t nbins, vector[double]& sample, AutoBinning mode)
     int index_between(double&, vector[double]& binedges)
     double mean(vector[int]& sample)
     double covariance(vector[int]& sample1, vector[int]& sample2)
@@ -987,6 +992,12 @@ cdef extern from "YODA/Histo1D.h" namespace "YODA":
                 string path,
                 string title) except +yodaerr
 
+        Histo1D(size_t nbins,
+                AutoBinning mode,
+                size_t nbuffer,
+                string path,
+                string title) except +yodaerr
+
         Histo1D(vector[double] binedges,
                 string path,
                 string title) except +yodaerr
@@ -1008,6 +1019,9 @@ cdef extern from "YODA/Histo1D.h" namespace "YODA":
         void fill(double x, double weight, double fraction) except +yodaerr
         void fillBin(size_t i, double weight, double fraction) except +yodaerr
 
+        bool autoBinPending()
+        void autoBook() except +yodaerr
+
         void scaleW(double s) except +yodaerr
         void normalize(double normto, bool includeoverflows) except +yodaerr
 
@@ -1409,8 +1423,23 @@ cdef extern from "<sstream>" namespace "std":
 
 cdef extern from "YODA/IO.h" namespace "YODA":
     void IO_read_from_file "YODA::read" (string&, vector[AnalysisObject*]&) except +yodaerr
+    void IO_read_from_file "YODA::read" (string&, vector[AnalysisObject*]&, vector[string]&, vector[string]&) except +yodaerr
+    void IO_read_from_file "YODA::read" (string&, vector[AnalysisObject*]&, vector[string]&, vector[string]&, size_t) except +yodaerr
     void IO_read_from_stream "YODA::read" (istream&, vector[AnalysisObject*]& aos, string&) except +yodaerr
     void IO_read_from_stringstream "YODA::read" (istringstream&, vector[AnalysisObject*]& aos, string&) except +yodaerr
+    void IO_read_from_stringstream "YODA::read" (istringstream&, vector[AnalysisObject*]& aos, string&, vector[string]&, vector[string]&) except +yodaerr
+    void IO_read_from_stringstream "YODA::read" (istringstream&, vector[AnalysisObject*]& aos, string&, vector[string]&, vector[string]&, size_t) except +yodaerr
+
+cdef extern from "YODA/Merge.h" namespace "YODA":
+    vector[AnalysisObject*] IO_merge "YODA::merge" (vector[vector[AnalysisObject*]]&, size_t) except +yodaerr
+
+    cdef cppclass Merger:
+        Merger()
+        bool add(AnalysisObject&) except +yodaerr
+        size_t add(vector[AnalysisObject*]&, size_t) except +yodaerr
+        size_t size()
+        vector[AnalysisObject*] result() except +yodaerr
+        void reset()
 
 cdef extern from "YODA/Index.h" namespace "YODA":
     cdef cppclass Index:
@@ -1420,8 +1449,14 @@ cdef extern from "YODA/Index.h" namespace "YODA":
 cdef extern from "YODA/Reader.h" namespace "YODA":
     cdef cppclass Reader:
         void read(istringstream&, vector[AnalysisObject*]&) except +yodaerr
+        void read(istringstream&, vector[AnalysisObject*]&, vector[string]&, vector[string]&) except +yodaerr
+        void read(istringstream&, vector[AnalysisObject*]&, vector[string]&, vector[string]&, size_t) except +yodaerr
         void read_from_file "YODA::Reader::read" (string&, vector[AnalysisObject*]&) except +yodaerr
-        Index& make_index "YODA::Reader::mkIndex" (string&)
+        void read_from_file "YODA::Reader::read" (string&, vector[AnalysisObject*]&, vector[string]&, vector[string]&) except +yodaerr
+        void read_from_file "YODA::Reader::read" (string&, vector[AnalysisObject*]&, vector[string]&, vector[string]&, size_t) except +yodaerr
+        AnalysisObject* readObject(string&, string&) except +yodaerr
+        vector[AnalysisObject*] readObjects(string&, vector[string]&) except +yodaerr
+        Index make_index "mkIndex" (string&) except +yodaerr
 
 cdef extern from "YODA/ReaderYODA.h" namespace "YODA":
     Reader& ReaderYODA_create "YODA::ReaderYODA::create" ()
@@ -1433,7 +1468,7 @@ cdef extern from "YODA/ReaderAIDA.h" namespace "YODA":
     Reader& ReaderAIDA_create "YODA::ReaderAIDA::create" ()
 
 cdef extern from "YODA/Reader.h" namespace "YODA":
-    Reader& Reader_create "YODA::mkReader" (string& filename)
+    Reader& Reader_create "YODA::mkReader" (string& filename) except +yodaerr
 
 
 cdef extern from "YODA/IO.h" namespace "YODA":
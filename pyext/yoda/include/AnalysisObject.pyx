@@ -150,7 +150,7 @@ cdef class AnalysisObject(util.Base):
 
 
     def __repr__(self):
-        return "<%s '%s'>" % (self.__class__.__name__, self.path)
+        return "<%s '%s'>" % (self.__class__.__name__, self.path())
 
 
 ## Convenience alias
@@ -66,6 +66,23 @@ def logspace(nbins, xmin, xmax):
     return c.logspace(nbins, xmin, xmax)
 
 
+cdef c.AutoBinning _autobinning(mode) except *:
+    "Map an auto-binning scheme name to its enum value, raising TypeError for anything else"
+    modes = {"lin" : c.AUTOBIN_LIN, "log" : c.AUTOBIN_LOG, "quantile" : c.AUTOBIN_QUANTILE}
+    if not isinstance(mode, str) or mode not in modes:
+        raise TypeError("Auto-binning scheme must be one of 'lin', 'log' or 'quantile'")
+    return modes[mode]
+
+
+def autospace(nbins, sample, mode="lin"):
+    """(int, list[float], [str]) -> list[float]
+    Make a list of n+1 bin edges which contain all finite values in sample, spaced
+    uniformly for mode 'lin', uniformly in log(x) for 'log' (if all values are
+    positive) or at quantiles of the sample for 'quantile'. The top edge is just
+    above the largest value. Quantile edges shared by many equal values are merged."""
+    return c.autospace(nbins, [float(x) for x in sample], _autobinning(mode))
+
+
 def pdfspace(nbins, xmin, xmax, fn, nsample=10000):
     """(int, float, float, [int]) -> list[float]
     Make a list of n+1 bin edges spaced with density proportional to fn(x) between
@@ -28,6 +28,13 @@ cdef class Histo1D(AnalysisObject):
       Construct a histogram with optional path and title, and nbins bins
       uniformly distributed between low and high.
 
+    Histo1D(nbins, autobinning, nbuffer=10000, path="", title="")
+      Construct a histogram with optional path and title, and nbins bins
+      chosen from the first nbuffer fills, which are held back until then,
+      or until autoBook() is called.
+      The autobinning scheme is 'lin', 'log' or 'quantile', as for autospace.
+      Later fills outside the chosen range go to the under/overflows.
+
     Histo1D(B, path="", title="").
       Construct a histogram with optional path and title, from an
       iterator of bins, B.
@@ -37,7 +44,7 @@ cdef class Histo1D(AnalysisObject):
         return <c.Histo1D*> self.ptr()
 
     def __init__(self, *args, **kwargs):
-        util.try_loop([self.__init2, self.__init5, self.__init3], *args, **kwargs)
+        util.try_loop([self.__initauto, self.__init2, self.__init5, self.__init3], *args, **kwargs)
 
     def __init2(self, path="", title=""):
         path  = path.encode('utf-8')
@@ -63,7 +70,13 @@ cdef class Histo1D(AnalysisObject):
     def __init5(self, nbins, low, high, path="", title=""):
         path  = path.encode('utf-8')
         title = title.encode('utf-8')
-        cutil.set_owned_ptr(self, new c.Histo1D(nbins, low, high, <string>path, <string>title))
+        cutil.set_owned_ptr(self, new c.Histo1D(<size_t>nbins, <double>low, <double>high, <string>path, <string>title))
+
+    def __initauto(self, nbins, autobinning, nbuffer=10000, path="", title=""):
+        mode = _autobinning(autobinning)
+        path  = path.encode('utf-8')
+        title = title.encode('utf-8')
+        cutil.set_owned_ptr(self, new c.Histo1D(<size_t>nbins, mode, <size_t>nbuffer, <string>path, <string>title))
 
 
     def __len__(self):
@@ -109,6 +122,18 @@ cdef class Histo1D(AnalysisObject):
         self.h1ptr().fillBin(ix, weight, fraction)
 
 
+    def autoBinPending(self):
+        """None -> bool
+        Whether the bins of an auto-binned histogram are still to be chosen from its fills."""
+        return self.h1ptr().autoBinPending()
+
+    def autoBook(self):
+        """None -> None.
+        Choose the bins of an auto-binned histogram from its fills so far.
+        Call this before reading or writing a histogram whose buffer may not be full."""
+        self.h1ptr().autoBook()
+
+
     def totalDbn(self):
         """None -> Dbn1D
         The Dbn1D representing the total distribution."""
@@ -30,6 +30,45 @@ def _pattern_check(name, patterns, unpatterns):
             return False
     return True
 
+## Translate a pattern to a C++ regex, or return None if it might not select the same paths there
+def _cpp_pattern(patt):
+    import re
+    patt = re.compile(patt)
+    if patt.flags & ~re.UNICODE:
+        return None
+    patt = patt.pattern
+    if not _istxt(patt) or any(ord(ch) > 127 for ch in patt):
+        return None
+    ## Only plain ASCII syntax, common to Python and ECMAScript and meaning
+    ## the same for non-ASCII paths: no inline flags or extensions, brace
+    ## quantifiers, negated classes, character-class escapes or backreferences,
+    ## possessive quantifiers, or single '.'s which can match part of a character
+    if "(?" in patt or "{" in patt or "}" in patt or "[^" in patt:
+        return None
+    if re.search(r"\\[^-\\/.^$|?*+()\[\]]|[*+?]\+|\.(?![*+])", patt.replace("\\.", "")):
+        return None
+    return patt.encode('utf-8')
+
+## Translate patterns and unpatterns to C++ regexes, for filtering while reading
+##
+## Patterns are all-or-nothing, and only unpatterns which translate are
+## passed on, so that the C++ filtering is never stricter than _pattern_check,
+## which is still applied after reading.
+def _cpp_patterns(patterns, unpatterns):
+    cpatts, cunpatts = [], []
+    if patterns:
+        if not isinstance(patterns, (list,tuple)):
+            patterns = [patterns]
+        cpatts = [_cpp_pattern(patt) for patt in patterns]
+        if None in cpatts:
+            cpatts = []
+    if unpatterns:
+        if not isinstance(unpatterns, (list,tuple)):
+            unpatterns = [unpatterns]
+        cunpatts = [_cpp_pattern(patt) for patt in unpatterns]
+        cunpatts = [cpatt for cpatt in cunpatts if cpatt is not None]
+    return cpatts, cunpatts
+
 ## Make a Python list of analysis objects from a C++ vector of them
 cdef list _aobjects_to_list(vector[c.AnalysisObject*]* aobjects, patterns, unpatterns):
     cdef list out = []
@@ -37,8 +76,9 @@ cdef list _aobjects_to_list(vector[c.AnalysisObject*]* aobjects, patterns, unpat
     cdef size_t i
     for i in range(aobjects.size()):
         ao = deref(aobjects)[i]
-        ## NOTE: automatic type conversion by passing the type() as a key to globals()
-        newao = cutil.new_owned_cls(globals()[ao.type().decode('utf-8')], ao)
+        ## NOTE: automatic type conversion by passing the type() as a key to globals(),
+        ## falling back to the generic wrapper for types without a Python binding
+        newao = cutil.new_owned_cls(globals().get(ao.type().decode('utf-8'), AnalysisObject), ao)
         if _pattern_check(newao.path(), patterns, unpatterns):
             out.append(newao)
     return out
@@ -52,8 +92,9 @@ cdef dict _aobjects_to_dict(vector[c.AnalysisObject*]* aobjects, patterns, unpat
     cdef size_t i
     for i in range(aobjects.size()):
         ao = deref(aobjects)[i]
-        ## NOTE: automatic type conversion by passing the type() as a key to globals()
-        newao = cutil.new_owned_cls( globals()[ao.type().decode('utf-8')], ao)
+        ## NOTE: automatic type conversion by passing the type() as a key to globals(),
+        ## falling back to the generic wrapper for types without a Python binding
+        newao = cutil.new_owned_cls(globals().get(ao.type().decode('utf-8'), AnalysisObject), ao)
         if _pattern_check(newao.path(), patterns, unpatterns):
             out[newao.path()] = newao
     return out
@@ -141,7 +182,7 @@ def _mktxtifstr(x):
 ## Readers
 ##
 
-def read(filename, asdict=True, patterns=None, unpatterns=None):
+def read(filename, asdict=True, patterns=None, unpatterns=None, nthreads=1):
     """
     Read data objects from the provided filename, auto-determining the format
     from the file extension.
@@ -150,22 +191,31 @@ def read(filename, asdict=True, patterns=None, unpatterns=None):
     optional patterns and unpatterns arguments. These can be strings, compiled
     regex objects with a 'match' method, or any iterable of those types. If
     given, only analyses with paths which match at least one pattern, and do not
-    match any unpatterns, will be returned.
+    match any unpatterns, will be returned. Patterns using only the regex
+    syntax common to Python and C++ are applied as the input is read, so that
+    the other objects are skipped without being parsed.
+
+    YODA-format input is parsed on nthreads threads, or one per hardware thread
+    if it is 0, with the objects still returned in file order.
 
     Returns a dict or list of analysis objects depending on the asdict argument.
     """
     cdef vector[c.AnalysisObject*] aobjects
     cdef c.istringstream iss
+    cdef string fname
+    cdef vector[string] cpatts, cunpatts
+    cpatts, cunpatts = _cpp_patterns(patterns, unpatterns)
     filename = _mktxtifstr(filename)
     if _istxt(filename):
-        c.IO_read_from_file(filename.encode('utf-8'), aobjects)
+        fname = filename.encode('utf-8')
+        c.IO_read_from_file(fname, aobjects, cpatts, cunpatts, nthreads)
     else:
         s = _bytestr_from_file(filename)
         # s = _mktxtifstr(filename.read()).encode('utf-8')
         # if _istxt(s) and not _is_open_as_binary(filename):
         #     s = s.encode('utf-8')
         _make_iss(iss, s)
-        c.IO_read_from_stringstream(iss, aobjects, 'yoda')
+        c.IO_read_from_stringstream(iss, aobjects, 'yoda', cpatts, cunpatts, nthreads)
 
     if asdict:
         d = _aobjects_to_dict(&aobjects, patterns, unpatterns)
@@ -178,7 +228,7 @@ def read(filename, asdict=True, patterns=None, unpatterns=None):
         return _aobjects_to_list(&aobjects, patterns, unpatterns)
 
 
-def readYODA(file_or_filename, asdict=True, patterns=None, unpatterns=None):
+def readYODA(file_or_filename, asdict=True, patterns=None, unpatterns=None, nthreads=1):
     """
     Read data objects from the provided YODA-format file.
 
@@ -186,15 +236,22 @@ def readYODA(file_or_filename, asdict=True, patterns=None, unpatterns=None):
     optional patterns and unpatterns arguments. These can be strings, compiled
     regex objects with a 'match' method, or any iterable of those types. If
     given, only analyses with paths which match at least one pattern, and do not
-    match any unpatterns, will be returned.
+    match any unpatterns, will be returned. Patterns using only the regex
+    syntax common to Python and C++ are applied as the input is read, so that
+    the other objects are skipped without being parsed.
+
+    The input is parsed on nthreads threads, or one per hardware thread if it
+    is 0, with the objects still returned in file order.
 
     Returns a dict or list of analysis objects depending on the asdict argument.
     """
     cdef c.istringstream iss
     cdef vector[c.AnalysisObject*] aobjects
+    cdef vector[string] cpatts, cunpatts
+    cpatts, cunpatts = _cpp_patterns(patterns, unpatterns)
     s = _bytestr_from_file(file_or_filename)
     _make_iss(iss, s)
-    c.ReaderYODA_create().read(iss, aobjects)
+    c.ReaderYODA_create().read(iss, aobjects, cpatts, cunpatts, nthreads)
     # if type(file_or_filename) is str:
     #     c.ReaderYODA_create().read_from_file(file_or_filename.encode('utf-8'), aobjects)
     # else:
@@ -217,10 +274,12 @@ def readFLAT(filename, asdict=True, patterns=None, unpatterns=None):
     """
     # cdef c.istringstream iss
     cdef vector[c.AnalysisObject*] aobjects
+    cdef vector[string] cpatts, cunpatts
+    cpatts, cunpatts = _cpp_patterns(patterns, unpatterns)
     # s = _bytestr_from_file(file_or_filename)
     # _make_iss(iss, s.encode('utf-8'))
     # c.ReaderFLAT_create().read(iss, aobjects)
-    c.ReaderFLAT_create().read_from_file(filename.encode('utf-8'), aobjects)
+    c.ReaderFLAT_create().read_from_file(filename.encode('utf-8'), aobjects, cpatts, cunpatts)
     return _aobjects_to_dict(&aobjects, patterns, unpatterns) if asdict \
         else _aobjects_to_list(&aobjects, patterns, unpatterns)
 
@@ -241,14 +300,142 @@ def readAIDA(filename, asdict=True, patterns=None, unpatterns=None):
     """
     # cdef c.istringstream iss
     cdef vector[c.AnalysisObject*] aobjects
+    cdef vector[string] cpatts, cunpatts
+    cpatts, cunpatts = _cpp_patterns(patterns, unpatterns)
     # s = _bytestr_from_file(file_or_filename)
     # _make_iss(iss, s.encode('utf-8'))
     # c.ReaderAIDA_create().read(iss, aobjects)
-    c.ReaderAIDA_create().read_from_file(filename.encode('utf-8'), aobjects)
+    c.ReaderAIDA_create().read_from_file(filename.encode('utf-8'), aobjects, cpatts, cunpatts)
     return _aobjects_to_dict(&aobjects, patterns, unpatterns) if asdict \
         else _aobjects_to_list(&aobjects, patterns, unpatterns)
 
 
+def readObject(filename, path):
+    """
+    Read the data object with the given path from the provided filename,
+    auto-determining the format from the file extension.
+
+    Uncompressed YODA files are indexed, or their sidecar index file is used
+    if it is up to date, so that only this object's data is parsed.
+
+    Returns the analysis object, or None if there is none with this path.
+    """
+    cdef string fname = filename.encode('utf-8')
+    cdef string cpath = path.encode('utf-8')
+    cdef c.AnalysisObject* ao = c.Reader_create(fname).readObject(fname, cpath)
+    if ao == NULL:
+        return None
+    return cutil.new_owned_cls(globals().get(ao.type().decode('utf-8'), AnalysisObject), ao)
+
+
+def readObjects(filename, paths, asdict=True):
+    """
+    Read the data objects with the given paths from the provided filename,
+    auto-determining the format from the file extension, as by readObject.
+
+    Returns a dict or list of analysis objects depending on the asdict
+    argument, the list being in the order of the paths. Paths which are not
+    in the file are left out.
+    """
+    cdef string fname = filename.encode('utf-8')
+    cdef vector[string] cpaths = [path.encode('utf-8') for path in paths]
+    cdef vector[c.AnalysisObject*] aobjects = c.Reader_create(fname).readObjects(fname, cpaths)
+    return _aobjects_to_dict(&aobjects, None, None) if asdict \
+        else _aobjects_to_list(&aobjects, None, None)
+
+
+##
+## Merging
+##
+
+def merge(aoss, nthreads=0, asdict=True):
+    """
+    Merge collections of analysis objects, e.g. as read from the outputs of
+    independent runs, with the rules of the yodamerge script.
+
+    Each collection can be a dict or list of analysis objects. Objects are
+    matched by path, and normalised (ScaledBy-annotated) counters, histograms
+    and profiles are merged to their weighted average normalisation, scatters
+    are averaged, and the first copy of any other type is kept. Objects of a
+    different type to the first with their path are skipped.
+
+    The merging is done in C++ with nthreads threads, or one per hardware
+    thread if it is zero. The input objects are not modified.
+
+    Returns a dict or list of new analysis objects depending on the asdict argument.
+    """
+    cdef vector[vector[c.AnalysisObject*]] vecs
+    cdef vector[c.AnalysisObject*] vec, merged
+    cdef AnalysisObject a
+    for aos in aoss:
+        vec.clear()
+        aolist = aos.values() if hasattr(aos, "values") else aos
+        for a in aolist:
+            vec.push_back(a.aoptr())
+        vecs.push_back(vec)
+    merged = c.IO_merge(vecs, nthreads)
+    return _aobjects_to_dict(&merged, None, None) if asdict \
+        else _aobjects_to_list(&merged, None, None)
+
+
+cdef class Merger:
+    """
+    Incremental merging of analysis objects, one at a time, with the same
+    rules as merge(). Only one accumulated object is kept per path, so each
+    input collection can be released as soon as it has been added.
+    """
+    cdef c.Merger* _merger
+
+    def __cinit__(self):
+        self._merger = new c.Merger()
+
+    def __dealloc__(self):
+        del self._merger
+
+    def __len__(self):
+        "Number of distinct paths merged so far"
+        return self._merger.size()
+
+    def add(self, AnalysisObject ao):
+        """
+        Merge a copy of analysis object ao into the accumulator for its path.
+
+        Returns False if it was skipped, because its type differs from that of
+        the first object with its path or because that type cannot be merged.
+        """
+        return self._merger.add(deref(ao.aoptr()))
+
+    def addAll(self, aos, nthreads=0):
+        """
+        Merge copies of a collection of analysis objects, e.g. as read from one
+        file, as if they were added one at a time. The collection can be a dict
+        or list.
+
+        The paths are shared out over nthreads threads, or one per hardware
+        thread if it is zero, as by merge(). Returns the number of objects
+        merged rather than skipped.
+        """
+        cdef vector[c.AnalysisObject*] vec
+        cdef AnalysisObject a
+        aolist = aos.values() if hasattr(aos, "values") else aos
+        for a in aolist:
+            vec.push_back(a.aoptr())
+        return self._merger.add(vec, nthreads)
+
+    def result(self, asdict=True):
+        """
+        Hand over the merged objects, with their normalisations reapplied, as a
+        dict or list depending on the asdict argument. The merger is left empty.
+        """
+        cdef vector[c.AnalysisObject*] merged = self._merger.result()
+        return _aobjects_to_dict(&merged, None, None) if asdict \
+            else _aobjects_to_list(&merged, None, None)
+
+    def reset(self):
+        "Discard everything merged so far"
+        self._merger.reset()
+
+
 ##
 ## Writers
 ##
@@ -0,0 +1,381 @@
+// -*- C++ -*-
+//
+// This file is part of YODA -- Yet more Objects for Data Analysis
+// Copyright (C) 2008-2021 The YODA collaboration (see AUTHORS for details)
+//
+#include "YODA/Utils/BinSearcher.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define YODA_BINSEARCHER_X86 1
+#include <immintrin.h>
+#endif
+
+namespace YODA {
+  namespace Utils {
+
+
+    namespace {
+
+      // All kernels compute the number of edges in e[0..ne) which are <= x. With
+      // the underflow sentinel excluded from e, that is exactly the offset index
+      // returned by BinSearcher::index, and it is 0 for NaNs as no comparison holds.
+
+
+      /// @brief Portable branchless bisection of four values at a time, down to a window of edges
+      ///
+      /// The number of steps depends only on @a ne, so the four independent
+      /// searches interleave and their edge loads overlap. This beats gathered
+      /// vector loads, so it is used for large binnings whatever the instruction set.
+      ///
+      /// Each search stops at a window of at most W = BATCH_LINEAR_THRESHOLD
+      /// edges, whose start is written to @a out. All edges before the window are
+      /// <= x and all after it are > x, so the window is widened to W edges, moved
+      /// back from the end if need be, and its count of edges <= x added by a
+      /// _window kernel. Needs @a ne > W.
+      void _narrow4(const double* e, size_t ne, const double* xs, size_t n, size_t* out) {
+        const size_t W = BATCH_LINEAR_THRESHOLD;
+        size_t k = 0;
+        for (; k + 4 <= n; k += 4) {
+          const double x0 = xs[k], x1 = xs[k+1], x2 = xs[k+2], x3 = xs[k+3];
+          size_t b0 = 0, b1 = 0, b2 = 0, b3 = 0, len = ne;
+          while (len > W) {
+            const size_t half = len / 2;
+            b0 = (e[b0+half] <= x0) ? b0 + half : b0;
+            b1 = (e[b1+half] <= x1) ? b1 + half : b1;
+            b2 = (e[b2+half] <= x2) ? b2 + half : b2;
+            b3 = (e[b3+half] <= x3) ? b3 + half : b3;
+            len -= half;
+          }
+          out[k] = std::min(b0, ne - W);
+          out[k+1] = std::min(b1, ne - W);
+          out[k+2] = std::min(b2, ne - W);
+          out[k+3] = std::min(b3, ne - W);
+        }
+        for (; k < n; ++k) {
+          size_t b = 0, len = ne;
+          while (len > W) {
+            const size_t half = len / 2;
+            b = (e[b+half] <= xs[k]) ? b + half : b;
+            len -= half;
+          }
+          out[k] = std::min(b, ne - W);
+        }
+      }
+
+
+      /// Count the edges below each value directly, for small binnings
+      void _count_scalar(const double* e, size_t ne, const double* xs, size_t n, size_t* out) {
+        for (size_t k = 0; k < n; ++k) {
+          size_t count = 0;
+          for (size_t j = 0; j < ne; ++j) count += (e[j] <= xs[k]);
+          out[k] = count;
+        }
+      }
+
+
+      /// Add the count of edges <= each value in its window of BATCH_LINEAR_THRESHOLD edges from _narrow4
+      void _window_scalar(const double* e, const double* xs, size_t n, size_t* out) {
+        for (size_t k = 0; k < n; ++k) {
+          const double* w = e + out[k];
+          size_t count = 0;
+          for (size_t j = 0; j < BATCH_LINEAR_THRESHOLD; ++j) count += (w[j] <= xs[k]);
+          out[k] += count;
+        }
+      }
+
+
+      /// Count the edges <= x in the (NaN-padded) B-tree node starting at @a node
+      inline size_t _nodecount(const double* node, double x) {
+        size_t count = 0;
+        for (size_t j = 0; j < BTREE_NODE_SIZE; ++j) count += (node[j] <= x);
+        return count;
+      }
+
+
+      /// B-tree descents of four values at a time, interleaved as for _bisect4
+      void _btree4(const double* e, size_t ne, const double* btree, const std::vector<size_t>& levels,
+                   const double* xs, size_t n, size_t* out) {
+        const size_t B = BTREE_NODE_SIZE;
+        size_t k = 0;
+        for (; k + 4 <= n; k += 4) {
+          const double x[4] = { xs[k], xs[k+1], xs[k+2], xs[k+3] };
+          size_t b[4] = { 0, 0, 0, 0 };
+          // Values below the first edge, and NaNs, never count an edge, so stay in node 0 and end at index 0
+          for (size_t l = 0; l < levels.size(); ++l) {
+            for (size_t i = 0; i < 4; ++i) {
+              const size_t c = _nodecount(btree + levels[l] + B*b[i], x[i]);
+              b[i] = B*b[i] + c - (c > 0);
+            }
+          }
+          for (size_t i = 0; i < 4; ++i) {
+            const size_t nlast = std::min(B, ne - B*b[i]);
+            size_t c = 0;
+            for (size_t j = 0; j < nlast; ++j) c += (e[B*b[i]+j] <= x[i]);
+            out[k+i] = B*b[i] + c;
+          }
+        }
+        for (; k < n; ++k) {
+          size_t b = 0;
+          for (size_t l = 0; l < levels.size(); ++l) {
+            const size_t c = _nodecount(btree + levels[l] + B*b, xs[k]);
+            b = B*b + c - (c > 0);
+          }
+          const size_t nlast = std::min(B, ne - B*b);
+          size_t c = 0;
+          for (size_t j = 0; j < nlast; ++j) c += (e[B*b+j] <= xs[k]);
+          out[k] = B*b + c;
+        }
+      }
+
+
+      #ifdef YODA_BINSEARCHER_X86
+
+      /// Count two values at a time, subtracting the all-ones comparison masks from the counts
+      void _count_sse2(const double* e, size_t ne, const double* xs, size_t n, size_t* out) {
+        size_t k = 0;
+        for (; k + 2 <= n; k += 2) {
+          const __m128d x = _mm_loadu_pd(xs + k);
+          __m128i count = _mm_setzero_si128();
+          for (size_t j = 0; j < ne; ++j) {
+            const __m128d le = _mm_cmple_pd(_mm_set1_pd(e[j]), x);
+            count = _mm_sub_epi64(count, _mm_castpd_si128(le));
+          }
+          _mm_storeu_si128(reinterpret_cast<__m128i*>(out + k), count);
+        }
+        _count_scalar(e, ne, xs + k, n - k, out + k);
+      }
+
+
+      /// Count four values at a time, subtracting the all-ones comparison masks from the counts
+      __attribute__((target("avx2")))
+      void _count_avx2(const double* e, size_t ne, const double* xs, size_t n, size_t* out) {
+        size_t k = 0;
+        for (; k + 4 <= n; k += 4) {
+          const __m256d x = _mm256_loadu_pd(xs + k);
+          __m256i count = _mm256_setzero_si256();
+          for (size_t j = 0; j < ne; ++j) {
+            const __m256d le = _mm256_cmp_pd(_mm256_broadcast_sd(e + j), x, _CMP_LE_OQ);
+            count = _mm256_sub_epi64(count, _mm256_castpd_si256(le));
+          }
+          _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + k), count);
+        }
+        _count_sse2(e, ne, xs + k, n - k, out + k);
+      }
+
+
+      /// Window counts as for _window_scalar, comparing each value to two edges at a time
+      void _window_sse2(const double* e, const double* xs, size_t n, size_t* out) {
+        static_assert(BATCH_LINEAR_THRESHOLD % 2 == 0, "Window must be whole SSE2 vectors");
+        for (size_t k = 0; k < n; ++k) {
+          const double* w = e + out[k];
+          const __m128d x = _mm_set1_pd(xs[k]);
+          __m128i count = _mm_setzero_si128();
+          for (size_t j = 0; j < BATCH_LINEAR_THRESHOLD; j += 2) {
+            const __m128d le = _mm_cmple_pd(_mm_loadu_pd(w + j), x);
+            count = _mm_sub_epi64(count, _mm_castpd_si128(le));
+          }
+          out[k] += _mm_cvtsi128_si64(count) + _mm_cvtsi128_si64(_mm_unpackhi_epi64(count, count));
+        }
+      }
+
+
+      /// Window counts as for _window_scalar, comparing each value to four edges at a time
+      __attribute__((target("avx2")))
+      void _window_avx2(const double* e, const double* xs, size_t n, size_t* out) {
+        static_assert(BATCH_LINEAR_THRESHOLD % 4 == 0, "Window must be whole AVX2 vectors");
+        for (size_t k = 0; k < n; ++k) {
+          const double* w = e + out[k];
+          const __m256d x = _mm256_broadcast_sd(xs + k);
+          __m256i count = _mm256_setzero_si256();
+          for (size_t j = 0; j < BATCH_LINEAR_THRESHOLD; j += 4) {
+            const __m256d le = _mm256_cmp_pd(_mm256_loadu_pd(w + j), x, _CMP_LE_OQ);
+            count = _mm256_sub_epi64(count, _mm256_castpd_si256(le));
+          }
+          const __m128i count2 = _mm_add_epi64(_mm256_castsi256_si128(count), _mm256_extracti128_si256(count, 1));
+          out[k] += _mm_cvtsi128_si64(count2) + _mm_extract_epi64(count2, 1);
+        }
+      }
+
+      #endif
+
+    }
+
+
+    void TransformEstimator::_fitPiecewise(const std::vector<double>& edges, size_t maxerr) {
+      _segx.clear(); _segy.clear(); _segslope.clear(); _segymax.clear();
+      const double eps = maxerr;
+      size_t i0 = 0;
+      while (i0 < edges.size()) {
+        // Grow the segment from edge i0 while some slope fits all its edges
+        double slopelow = 0, slopehigh = std::numeric_limits<double>::infinity();
+        size_t i = i0 + 1;
+        for (; i < edges.size(); ++i) {
+          const double dx = edges[i] - edges[i0], dy = i - i0;
+          const double newlow = std::max(slopelow, (dy - eps) / dx);
+          const double newhigh = std::min(slopehigh, (dy + eps) / dx);
+          if (newlow > newhigh) break;
+          slopelow = newlow;
+          slopehigh = newhigh;
+        }
+        _segx.push_back(edges[i0]);
+        _segy.push_back(i0);
+        _segslope.push_back(std::isfinite(slopehigh) ? 0.5*(slopelow + slopehigh) : 0.0);
+        _segymax.push_back(i);
+        i0 = i;
+      }
+    }
+
+
+    void BinSearcher::_chooseEstimator(const std::vector<double>& edges) {
+      const size_t nbins = edges.size()-1;
+      const double xlow = edges.front(), xhigh = edges.back();
+      _estedges = edges.size();
+      _est = TransformEstimator(nbins, xlow, xhigh, EST_LIN);
+      // The linear estimate of a regular binning is already exact
+      if (_regular) return;
+
+      std::vector<TransformEstimator> candidates = {
+        TransformEstimator(nbins, xlow, xhigh, EST_POWER, 2),
+        TransformEstimator(nbins, xlow, xhigh, EST_POWER, 3) };
+      if (xlow >= 0.0) candidates.push_back(TransformEstimator(nbins, xlow, xhigh, EST_SQRT));
+      if (xlow > 0.0) candidates.push_back(TransformEstimator(nbins, xlow, xhigh, EST_LOG));
+      if (xlow > 0.0 && xhigh < 1.0) candidates.push_back(TransformEstimator(nbins, xlow, xhigh, EST_LOGIT));
+
+      // Mean index estimate deviation from the correct answers, at evenly strided bin edges
+      const size_t stride = std::max<size_t>(1, edges.size() / EST_SCORE_SAMPLES);
+      auto deviation = [&](const TransformEstimator& est) {
+        double sum = 0;
+        size_t n = 0;
+        for (size_t i = 0; i < edges.size(); i += stride, ++n) {
+          sum += std::fabs((double) est(edges[i]) - (double) (i+1));
+        }
+        return sum / n;
+      };
+
+      // Earlier candidates win ties, and NaN averages never win
+      double bestavg = _est.valid() ? deviation(_est) : std::numeric_limits<double>::infinity();
+      for (const TransformEstimator& est : candidates) {
+        if (!est.valid()) continue;
+        const double avg = deviation(est);
+        if (avg < bestavg) {
+          bestavg = avg;
+          _est = est;
+        }
+      }
+
+      // The learned estimator's penalty is at least half a bin, so only fit it if it could win
+      if (bestavg > 0.5) {
+        const TransformEstimator est(edges);
+        const double avg = deviation(est) + 0.5 * std::log2(1 + est.numSegments());
+        if (avg < bestavg) _est = est;
+      }
+    }
+
+
+    SIMDLevel BinSearcher::simdLevel() {
+      #ifdef YODA_BINSEARCHER_X86
+      static const SIMDLevel level = [] {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") ? SIMD_AVX2 : SIMD_SSE2;
+      }();
+      return level;
+      #else
+      return SIMD_NONE;
+      #endif
+    }
+
+
+    void BinSearcher::_buildBTree() {
+      _btree.clear();
+      _btreelevels.clear();
+      const size_t ne = _edges.size() - 2;
+      if (_regular || ne < BTREE_THRESHOLD) return;
+
+      // Build the levels bottom-up from the in-range edges, then store them top first
+      const size_t B = BTREE_NODE_SIZE;
+      std::vector< std::vector<double> > levels;
+      std::vector<double> below(_edges.begin()+1, _edges.end()-1);
+      while (below.size() > B) {
+        std::vector<double> level;
+        for (size_t i = 0; i < below.size(); i += B) level.push_back(below[i]);
+        below = level;
+        level.resize(B * ((level.size() + B - 1) / B), std::numeric_limits<double>::quiet_NaN());
+        levels.push_back(level);
+      }
+      for (auto l = levels.rbegin(); l != levels.rend(); ++l) {
+        _btreelevels.push_back(_btree.size());
+        _btree.insert(_btree.end(), l->begin(), l->end());
+      }
+    }
+
+
+    size_t BinSearcher::_btreesearch(double x) const {
+      const size_t B = BTREE_NODE_SIZE;
+      const double* e = _edges.data() + 1;
+      const size_t ne = _edges.size() - 2;
+      if (!(x >= e[0])) return 0;
+
+      // Each node's first edge is <= x, so the count is at least one
+      size_t b = 0;
+      for (size_t l = 0; l < _btreelevels.size(); ++l) {
+        b = B*b + _nodecount(_btree.data() + _btreelevels[l] + B*b, x) - 1;
+      }
+      const size_t nlast = std::min(B, ne - B*b);
+      size_t c = 0;
+      for (size_t j = 0; j < nlast; ++j) c += (e[B*b+j] <= x);
+      return B*b + c;
+    }
+
+
+    void BinSearcher::_indices(const double* xs, size_t n, size_t* out, SIMDLevel level) const {
+      if (_edges.size() < 2) {
+        std::fill(out, out+n, 0);
+        return;
+      }
+
+      // Search the in-range edges only, excluding the -+inf sentinels
+      const double* e = _edges.data() + 1;
+      const size_t ne = _edges.size() - 2;
+      if (!_btreelevels.empty() && ne >= BTREE_BATCH_THRESHOLD) {
+        _btree4(e, ne, _btree.data(), _btreelevels, xs, n, out);
+        return;
+      }
+      if (level == SIMD_AUTO || level > simdLevel()) level = simdLevel();
+      if (ne > BATCH_LINEAR_THRESHOLD) {
+        // Bisect down to a window of edges, then compare each value to all of its window
+        _narrow4(e, ne, xs, n, out);
+        switch (level) {
+        #ifdef YODA_BINSEARCHER_X86
+        case SIMD_AVX2:
+          _window_avx2(e, xs, n, out);
+          break;
+        case SIMD_SSE2:
+          _window_sse2(e, xs, n, out);
+          break;
+        #endif
+        default:
+          _window_scalar(e, xs, n, out);
+        }
+        return;
+      }
+      switch (level) {
+      #ifdef YODA_BINSEARCHER_X86
+      case SIMD_AVX2:
+        _count_avx2(e, ne, xs, n, out);
+        break;
+      case SIMD_SSE2:
+        _count_sse2(e, ne, xs, n, out);
+        break;
+      #endif
+      default:
+        _count_scalar(e, ne, xs, n, out);
+      }
+    }
+
+
+  }
+}
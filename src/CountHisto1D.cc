@@ -0,0 +1,125 @@
+// -*- C++ -*-
+//
+// This file is part of YODA -- Yet more Objects for Data Analysis
+// Copyright (C) 2008-2021 The YODA collaboration (see AUTHORS for details)
+//
+#include "YODA/CountHisto1D.h"
+#include "YODA/Scatter2D.h"
+
+using namespace std;
+
+namespace YODA {
+
+
+  void CountHisto1D::fill(double x, double weight, double fraction) {
+    _axis._fillHisto(x, weight, fraction);
+  }
+
+
+  void CountHisto1D::fillMany(size_t n, const double* xs, const double* weights, const double* fractions) {
+    _axis._fillHistoMany(n, xs, weights, fractions);
+  }
+
+
+  void CountHisto1D::fillBin(size_t i, double weight, double fraction) {
+    fill(_axis.binMid(i), weight, fraction);
+  }
+
+
+
+  /////////////// COMMON TO ALL BINNED
+
+  double CountHisto1D::numEntries(bool includeoverflows) const {
+    if (includeoverflows) return totalDbn().numEntries();
+    return _axis.binTotalDbn().numEntries();
+  }
+
+
+  double CountHisto1D::effNumEntries(bool includeoverflows) const {
+    if (includeoverflows) return totalDbn().effNumEntries();
+    double n = 0;
+    for (const Bin& b : bins()) n += b.effNumEntries();
+    return n;
+  }
+
+
+  double CountHisto1D::sumW(bool includeoverflows) const {
+    if (includeoverflows) return _axis.totalDbn().sumW();
+    return _axis.binTotalDbn().sumW();
+  }
+
+
+  double CountHisto1D::sumW2(bool includeoverflows) const {
+    if (includeoverflows) return _axis.totalDbn().sumW2();
+    return _axis.binTotalDbn().sumW2();
+  }
+
+
+
+  ////////////////////////////////////////
+
+
+  /// Copy constructor with optional new path
+  CountHisto1D::CountHisto1D(const CountHisto1D& h, const std::string& path)
+    : AnalysisObject("CountHisto1D", (path.size() == 0) ? h.path() : path, h, h.title())
+  {
+    _axis = h._axis;
+  }
+
+
+  /// Constructor from a Histo1D, dropping its x moments, with optional new path
+  CountHisto1D::CountHisto1D(const Histo1D& h, const std::string& path)
+    : AnalysisObject("CountHisto1D", (path.size() == 0) ? h.path() : path, h, h.title())
+  {
+    std::vector<CountBin1D> bins;
+    for (const HistoBin1D& b : h.bins()) {
+      bins.push_back(CountBin1D(b.xEdges(), Dbn0D(b.numEntries(), b.sumW(), b.sumW2())));
+    }
+    const Dbn1D& t = h.totalDbn(), & u = h.underflow(), & o = h.overflow();
+    _axis = CountHisto1DAxis(bins, Dbn0D(t.numEntries(), t.sumW(), t.sumW2()),
+                             Dbn0D(u.numEntries(), u.sumW(), u.sumW2()),
+                             Dbn0D(o.numEntries(), o.sumW(), o.sumW2()));
+  }
+
+
+
+  ////////////////////////////////////////
+
+
+  Histo1D mkHisto1D(const CountHisto1D& h) {
+    std::vector<HistoBin1D> bins;
+    Dbn1D binsum;
+    for (const CountBin1D& b : h.bins()) {
+      const double x = b.xMid();
+      const Dbn1D dbn(b.numEntries(), b.sumW(), b.sumW2(), b.sumW()*x, b.sumW()*x*x);
+      binsum += dbn;
+      bins.push_back(HistoBin1D(b.xEdges(), dbn));
+    }
+    const Dbn0D& t = h.totalDbn(), & u = h.underflow(), & o = h.overflow();
+    const double xlo = h.xMin(), xhi = h.xMax();
+    const Dbn1D uflow(u.numEntries(), u.sumW(), u.sumW2(), u.sumW()*xlo, u.sumW()*xlo*xlo);
+    const Dbn1D oflow(o.numEntries(), o.sumW(), o.sumW2(), o.sumW()*xhi, o.sumW()*xhi*xhi);
+    // Total weight in neither the bins nor the flows goes at the bins' mean
+    const double wrest = t.sumW() - binsum.sumW() - u.sumW() - o.sumW();
+    const double frest = binsum.sumW() != 0 ? wrest/binsum.sumW() : 0;
+    Histo1D rtn(bins,
+                Dbn1D(t.numEntries(), t.sumW(), t.sumW2(),
+                      binsum.sumWX()*(1+frest) + uflow.sumWX() + oflow.sumWX(),
+                      binsum.sumWX2()*(1+frest) + uflow.sumWX2() + oflow.sumWX2()),
+                uflow, oflow, h.path(), h.title());
+    for (const std::string& a : h.annotations()) {
+      if (a != "Type") rtn.setAnnotation(a, h.annotation(a));
+    }
+    return rtn;
+  }
+
+
+  Scatter2D mkScatter(const CountHisto1D& h, bool binwidthdiv,
+                      double uflow_binwidth, double oflow_binwidth) {
+    Scatter2D rtn = mkScatter(mkHisto1D(h), false, binwidthdiv, uflow_binwidth, oflow_binwidth);
+    rtn.setAnnotation("Type", h.type());
+    return rtn;
+  }
+
+
+}
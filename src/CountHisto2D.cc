@@ -0,0 +1,119 @@
+// -*- C++ -*-
+//
+// This file is part of YODA -- Yet more Objects for Data Analysis
+// Copyright (C) 2008-2021 The YODA collaboration (see AUTHORS for details)
+//
+#include "YODA/CountHisto2D.h"
+#include "YODA/Scatter3D.h"
+
+using namespace std;
+
+namespace YODA {
+
+
+  /// Copy constructor with optional new path
+  CountHisto2D::CountHisto2D(const CountHisto2D& h, const std::string& path)
+    : AnalysisObject("CountHisto2D", (path.size() == 0) ? h.path() : path, h, h.title()),
+      _axis(h._axis)
+  { }
+
+
+  /// Constructor from a Histo2D, dropping its x and y moments, with optional new path
+  CountHisto2D::CountHisto2D(const Histo2D& h, const std::string& path)
+    : AnalysisObject("CountHisto2D", (path.size() == 0) ? h.path() : path, h, h.title())
+  {
+    std::vector<CountBin2D> bins;
+    for (const HistoBin2D& b : h.bins()) {
+      bins.push_back(CountBin2D(b.xEdges(), b.yEdges(), Dbn0D(b.numEntries(), b.sumW(), b.sumW2())));
+    }
+    const Dbn2D& t = h.totalDbn();
+    _axis = CountHisto2DAxis(bins, Dbn0D(t.numEntries(), t.sumW(), t.sumW2()), Outflows(8));
+  }
+
+
+  ////////////////////////////////////
+
+
+  void CountHisto2D::fill(double x, double y, double weight, double fraction) {
+    _axis._fillHisto(x, y, weight, fraction);
+  }
+
+
+  void CountHisto2D::fillMany(size_t n, const double* xs, const double* ys,
+                              const double* weights, const double* fractions) {
+    _axis._fillMany(n, xs, ys, nullptr, weights, fractions);
+  }
+
+
+  void CountHisto2D::fillBin(size_t i, double weight, double fraction) {
+    const pair<double, double> mid = _axis.binMid(i);
+    fill(mid.first, mid.second, weight, fraction);
+  }
+
+
+
+  /////////////// COMMON TO ALL BINNED
+
+  double CountHisto2D::numEntries(bool includeoverflows) const {
+    if (includeoverflows) return totalDbn().numEntries();
+    return _axis.binTotalDbn().numEntries();
+  }
+
+
+  double CountHisto2D::effNumEntries(bool includeoverflows) const {
+    if (includeoverflows) return totalDbn().effNumEntries();
+    double n = 0;
+    for (const Bin& b : bins()) n += b.effNumEntries();
+    return n;
+  }
+
+
+  double CountHisto2D::sumW(bool includeoverflows) const {
+    if (includeoverflows) return _axis.totalDbn().sumW();
+    return _axis.binTotalDbn().sumW();
+  }
+
+
+  double CountHisto2D::sumW2(bool includeoverflows) const {
+    if (includeoverflows) return _axis.totalDbn().sumW2();
+    return _axis.binTotalDbn().sumW2();
+  }
+
+
+
+  ////////////////////////////////////////
+
+
+  Histo2D mkHisto2D(const CountHisto2D& h) {
+    std::vector<HistoBin2D> bins;
+    Dbn2D binsum;
+    for (const CountBin2D& b : h.bins()) {
+      const double x = b.xMid(), y = b.yMid(), w = b.sumW();
+      const Dbn2D dbn(b.numEntries(), w, b.sumW2(), w*x, w*x*x, w*y, w*y*y, w*x*y);
+      binsum += dbn;
+      bins.push_back(HistoBin2D(b.xEdges(), b.yEdges(), dbn));
+    }
+    // Total weight outside the bins goes at the bins' mean
+    const Dbn0D& t = h.totalDbn();
+    const double f = binsum.sumW() != 0 ? t.sumW()/binsum.sumW() : 0;
+    Histo2D rtn(bins,
+                Dbn2D(t.numEntries(), t.sumW(), t.sumW2(),
+                      f*binsum.sumWX(), f*binsum.sumWX2(), f*binsum.sumWY(), f*binsum.sumWY2(),
+                      f*binsum.sumWXY()),
+                Histo2D::Outflows(8),
+                h.path(), h.title());
+    for (const std::string& a : h.annotations()) {
+      if (a != "Type") rtn.setAnnotation(a, h.annotation(a));
+    }
+    return rtn;
+  }
+
+
+  Scatter3D mkScatter(const CountHisto2D& h, bool binareadiv) {
+    Scatter3D rtn = mkScatter(mkHisto2D(h), false, binareadiv);
+    rtn.setAnnotation("Type", h.type());
+    return rtn;
+  }
+
+
+}
@@ -22,6 +22,7 @@ namespace YODA {
 
 
   Dbn0D& Dbn0D::add(const Dbn0D& d) {
+    _unitFills += d._unitFills;
     _numEntries += d._numEntries;
     _sumW     += d._sumW;
     _sumW2    += d._sumW2;
@@ -29,9 +30,9 @@ namespace YODA {
   }
 
   Dbn0D& Dbn0D::subtract(const Dbn0D& d) {
-    _numEntries += d._numEntries; //< @todo Hmm, add or subtract?!?
-    _sumW     -= d._sumW;
-    _sumW2    += d._sumW2;
+    _numEntries += d.numEntries(); //< @todo Hmm, add or subtract?!?
+    _sumW     -= d.sumW();
+    _sumW2    += d.sumW2();
     return *this;
   }
 
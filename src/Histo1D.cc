@@ -14,31 +14,17 @@ namespace YODA {
 
 
   void Histo1D::fill(double x, double weight, double fraction) {
-    if ( std::isnan(x) ) throw RangeError("X is NaN");
-
-    // Fill the overall distribution
-    _axis.totalDbn().fill(x, weight, fraction);
+    _axis._fillHisto(x, weight, fraction);
+  }
 
-    // Fill the bins and overflows
-    /// Unify this with Profile1D's version, when binning and inheritance are reworked
-    if (inRange(x, _axis.xMin(), _axis.xMax())) {
-      try {
-        /// @todo Replace try block with a check that there is a bin at x
-        _binAt(x).fill(x, weight, fraction);
-      } catch (const RangeError& re) {    }
-    } else if (x < _axis.xMin()) {
-      _axis.underflow().fill(x, weight, fraction);
-    } else if (x >= _axis.xMax()) {
-      _axis.overflow().fill(x, weight, fraction);
-    }
 
-    // Lock the axis now that a fill has happened
-    _axis._setLock(true);
+  void Histo1D::fillMany(size_t n, const double* xs, const double* weights, const double* fractions) {
+    _axis._fillHistoMany(n, xs, weights, fractions);
   }
 
 
   void Histo1D::fillBin(size_t i, double weight, double fraction) {
-    fill(bin(i).xMid(), weight, fraction);
+    fill(_axis.binMid(i), weight, fraction);
   }
 
 
@@ -63,17 +49,13 @@ namespace YODA {
 
   double Histo1D::sumW(bool includeoverflows) const {
     if (includeoverflows) return _axis.totalDbn().sumW();
-    double sumw = 0;
-    for (const Bin& b : bins()) sumw += b.sumW();
-    return sumw;
+    return _axis.binTotalDbn().sumW();
   }
 
 
   double Histo1D::sumW2(bool includeoverflows) const {
     if (includeoverflows) return _axis.totalDbn().sumW2();
-    double sumw2 = 0;
-    for (const Bin& b : bins()) sumw2 += b.sumW2();
-    return sumw2;
+    return _axis.binTotalDbn().sumW2();
   }
 
   // ^^^^^^^^^^^^^
@@ -81,32 +63,28 @@ namespace YODA {
 
   double Histo1D::xMean(bool includeoverflows) const {
     if (includeoverflows) return _axis.totalDbn().xMean();
-    Dbn1D dbn;
-    for (const HistoBin1D& b : bins()) dbn += b.dbn();
+    const Dbn1D dbn = _axis.binTotalDbn();
     return dbn.xMean();
   }
 
 
   double Histo1D::xVariance(bool includeoverflows) const {
     if (includeoverflows) return _axis.totalDbn().xVariance();
-    Dbn1D dbn;
-    for (const HistoBin1D& b : bins()) dbn += b.dbn();
+    const Dbn1D dbn = _axis.binTotalDbn();
     return dbn.xVariance();
   }
 
 
   double Histo1D::xStdErr(bool includeoverflows) const {
     if (includeoverflows) return _axis.totalDbn().xStdErr();
-    Dbn1D dbn;
-    for (const HistoBin1D& b : bins()) dbn += b.dbn();
+    const Dbn1D dbn = _axis.binTotalDbn();
     return dbn.xStdErr();
   }
 
 
   double Histo1D::xRMS(bool includeoverflows) const {
     if (includeoverflows) return _axis.totalDbn().xRMS();
-    Dbn1D dbn;
-    for (const HistoBin1D& b : bins()) dbn += b.dbn();
+    const Dbn1D dbn = _axis.binTotalDbn();
     return dbn.xRMS();
   }
 
@@ -48,35 +48,18 @@ namespace YODA {
 
 
   void Histo2D::fill(double x, double y, double weight, double fraction) {
-    if ( std::isnan(x) ) throw RangeError("X is NaN");
-    if ( std::isnan(y) ) throw RangeError("Y is NaN");
+    _axis._fillHisto(x, y, weight, fraction);
+  }
 
-    // Fill the overall distribution
-    _axis.totalDbn().fill(x, y, weight, fraction);
 
-    // Fill the bins and overflows
-    /// Unify this with Profile2D's version, when binning and inheritance are reworked
-    if (inRange(x, _axis.xMin(), _axis.xMax()) && inRange(y, _axis.yMin(), _axis.yMax())) {
-      try {
-        /// @todo Replace try block with a check that there is a bin at x, y
-        _binAt(x, y).fill(x, y, weight, fraction);
-      } catch (const RangeError& re) {    }
-    }
-    /// @todo Reinstate! With outflow axis bin lookup
-    // else {
-    //   size_t ix(0), iy(0);
-    //   if (x <  _axis.xMin()) ix = -1; else if (x >= _axis.xMax()) ix = 1;
-    //   if (y <  _axis.yMin()) iy = -1; else if (y >= _axis.yMax()) iy = 1;
-    //   _axis.outflow(ix, iy).fill(x, y, weight, fraction);
-    // }
-
-    // Lock the axis now that a fill has happened
-    _axis._setLock(true);
+  void Histo2D::fillMany(size_t n, const double* xs, const double* ys,
+                         const double* weights, const double* fractions) {
+    _axis._fillMany(n, xs, ys, nullptr, weights, fractions);
   }
 
 
   void Histo2D::fillBin(size_t i, double weight, double fraction) {
-    pair<double, double> mid = bin(i).xyMid();
+    const pair<double, double> mid = _axis.binMid(i);
     fill(mid.first, mid.second, weight, fraction);
   }
 
@@ -102,17 +85,13 @@ namespace YODA {
 
   double Histo2D::sumW(bool includeoverflows) const {
     if (includeoverflows) return _axis.totalDbn().sumW();
-    double sumw = 0;
-    for (const Bin& b : bins()) sumw += b.sumW();
-    return sumw;
+    return _axis.binTotalDbn().sumW();
   }
 
 
   double Histo2D::sumW2(bool includeoverflows) const {
     if (includeoverflows) return _axis.totalDbn().sumW2();
-    double sumw2 = 0;
-    for (const Bin& b : bins()) sumw2 += b.sumW2();
-    return sumw2;
+    return _axis.binTotalDbn().sumW2();
   }
 
 
@@ -121,64 +100,56 @@ namespace YODA {
 
   double Histo2D::xMean(bool includeoverflows) const {
     if (includeoverflows) return _axis.totalDbn().xMean();
-    Dbn2D dbn;
-    for (const HistoBin2D& b : bins()) dbn += b.dbn();
+    const Dbn2D dbn = _axis.binTotalDbn();
     return dbn.xMean();
   }
 
 
   double Histo2D::yMean(bool includeoverflows) const {
     if (includeoverflows) return _axis.totalDbn().yMean();
-    Dbn2D dbn;
-    for (const HistoBin2D& b : bins()) dbn += b.dbn();
+    const Dbn2D dbn = _axis.binTotalDbn();
     return dbn.yMean();
   }
 
 
   double Histo2D::xVariance(bool includeoverflows) const {
     if (includeoverflows) return _axis.totalDbn().xVariance();
-    Dbn2D dbn;
-    for (const HistoBin2D& b : bins()) dbn += b.dbn();
+    const Dbn2D dbn = _axis.binTotalDbn();
     return dbn.xVariance();
   }
 
 
   double Histo2D::yVariance(bool includeoverflows) const {
     if (includeoverflows) return _axis.totalDbn().yVariance();
-    Dbn2D dbn;
-    for (const HistoBin2D& b : bins()) dbn += b.dbn();
+    const Dbn2D dbn = _axis.binTotalDbn();
     return dbn.yVariance();
   }
 
 
   double Histo2D::xStdErr(bool includeoverflows) const {
     if (includeoverflows) return _axis.totalDbn().xStdErr();
-    Dbn2D dbn;
-    for (const HistoBin2D& b : bins()) dbn += b.dbn();
+    const Dbn2D dbn = _axis.binTotalDbn();
     return dbn.xStdErr();
   }
 
 
   double Histo2D::yStdErr(bool includeoverflows) const {
     if (includeoverflows) return _axis.totalDbn().yStdErr();
-    Dbn2D dbn;
-    for (const HistoBin2D& b : bins()) dbn += b.dbn();
+    const Dbn2D dbn = _axis.binTotalDbn();
     return dbn.yStdErr();
   }
 
 
   double Histo2D::xRMS(bool includeoverflows) const {
     if (includeoverflows) return _axis.totalDbn().xRMS();
-    Dbn2D dbn;
-    for (const HistoBin2D& b : bins()) dbn += b.dbn();
+    const Dbn2D dbn = _axis.binTotalDbn();
     return dbn.xRMS();
   }
 
 
   double Histo2D::yRMS(bool includeoverflows) const {
     if (includeoverflows) return _axis.totalDbn().yRMS();
-    Dbn2D dbn;
-    for (const HistoBin2D& b : bins()) dbn += b.dbn();
+    const Dbn2D dbn = _axis.binTotalDbn();
     return dbn.yRMS();
   }
 
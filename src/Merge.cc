@@ -0,0 +1,467 @@
+// -*- C++ -*-
+//
+// This file is part of YODA -- Yet more Objects for Data Analysis
+// Copyright (C) 2008-2021 The YODA collaboration (see AUTHORS for details)
+//
+#include "YODA/Merge.h"
+#include "YODA/Counter.h"
+#include "YODA/Histo1D.h"
+#include "YODA/Histo2D.h"
+#include "YODA/Profile1D.h"
+#include "YODA/Profile2D.h"
+#include "YODA/CountHisto1D.h"
+#include "YODA/CountHisto2D.h"
+#include "YODA/Scatter1D.h"
+#include "YODA/Scatter2D.h"
+#include "YODA/Scatter3D.h"
+#include "YODA/ReaderYODA.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <future>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <unordered_map>
+
+using namespace std;
+
+namespace YODA {
+
+
+  namespace {
+
+    /// How the objects in a path group are combined
+    enum MergeKind { MERGE_FILLABLE, MERGE_SCATTER, MERGE_NONE };
+
+
+    /// The objects with one path and type, and their merging state
+    struct MergeGroup {
+      string type;
+      MergeKind kind;
+      vector<const AnalysisObject*> inputs;
+      vector<AnalysisObject*> items;
+      vector<double> sfs;
+    };
+
+
+    MergeKind mergeKind(const string& aotype) {
+      if (aotype == "Counter" || aotype == "Histo1D" || aotype == "Histo2D" ||
+          aotype == "Profile1D" || aotype == "Profile2D" ||
+          aotype == "CountHisto1D" || aotype == "CountHisto2D") return MERGE_FILLABLE;
+      if (aotype == "Scatter1D" || aotype == "Scatter2D" || aotype == "Scatter3D") return MERGE_SCATTER;
+      return MERGE_NONE;
+    }
+
+
+    /// Run @a task for each index below @a ntasks on up to @a nthreads threads
+    void runParallel(size_t ntasks, size_t nthreads, const function<void(size_t)>& task) {
+      const size_t nworkers = min(ntasks, nthreads);
+      if (nworkers <= 1) {
+        for (size_t i = 0; i < ntasks; ++i) task(i);
+        return;
+      }
+      atomic<size_t> next(0);
+      exception_ptr error;
+      mutex error_mutex;
+      auto work = [&]() {
+        for (size_t i = next++; i < ntasks; i = next++) {
+          try {
+            task(i);
+          } catch (...) {
+            lock_guard<mutex> lock(error_mutex);
+            if (!error) error = current_exception();
+            next = ntasks;
+          }
+        }
+      };
+      vector<thread> workers;
+      for (size_t i = 1; i < nworkers; ++i) workers.push_back(thread(work));
+      work();
+      for (thread& t : workers) t.join();
+      if (error) rethrow_exception(error);
+    }
+
+
+    template <typename T>
+    void addAs(AnalysisObject& a, const AnalysisObject& b) {
+      dynamic_cast<T&>(a) += dynamic_cast<const T&>(b);
+    }
+
+
+    /// Add two counters, histograms or profiles of the same type
+    void addFillable(AnalysisObject& a, const AnalysisObject& b) {
+      const string& aotype = a.type();
+      if (aotype == "Counter") addAs<Counter>(a, b);
+      else if (aotype == "Histo1D") addAs<Histo1D>(a, b);
+      else if (aotype == "Histo2D") addAs<Histo2D>(a, b);
+      else if (aotype == "Profile1D") addAs<Profile1D>(a, b);
+      else if (aotype == "Profile2D") addAs<Profile2D>(a, b);
+      else if (aotype == "CountHisto1D") addAs<CountHisto1D>(a, b);
+      else if (aotype == "CountHisto2D") addAs<CountHisto2D>(a, b);
+      else throw LogicError("Cannot add analysis objects of type " + aotype);
+    }
+
+
+    /// Sum the values of two scatters, adding the errors of each source in quadrature
+    template <typename S>
+    void addScatterAs(AnalysisObject& a, const AnalysisObject& b) {
+      S& sa = dynamic_cast<S&>(a);
+      const S& sb = dynamic_cast<const S&>(b);
+      if (sa.numPoints() != sb.numPoints()) {
+        throw LogicError("Cannot merge scatters with different numbers of points for " + a.path());
+      }
+      const size_t dim = sa.dim();
+      const vector<string> avars = sa.variations(), bvars = sb.variations();
+      for (size_t i = 0; i < sa.numPoints(); ++i) {
+        Point& pa = sa.point(i);
+        const Point& pb = sb.point(i);
+        pa.setVal(dim, pa.val(dim) + pb.val(dim));
+        for (const string& var : bvars) {
+          pair<double,double> e(0.0, 0.0);
+          if (find(avars.begin(), avars.end(), var) != avars.end()) e = pa.errs(dim, var);
+          const pair<double,double>& eb = pb.errs(dim, var);
+          e.first = sqrt(sqr(e.first) + sqr(eb.first));
+          e.second = sqrt(sqr(e.second) + sqr(eb.second));
+          pa.setErrs(dim, e, var);
+        }
+      }
+    }
+
+
+    void addScatter(AnalysisObject& a, const AnalysisObject& b) {
+      const string& aotype = a.type();
+      if (aotype == "Scatter1D") addScatterAs<Scatter1D>(a, b);
+      else if (aotype == "Scatter2D") addScatterAs<Scatter2D>(a, b);
+      else if (aotype == "Scatter3D") addScatterAs<Scatter3D>(a, b);
+      else throw LogicError("Cannot add analysis objects of type " + aotype);
+    }
+
+
+    /// Undo any normalisation of @a ao, returning its contribution to the sum of factors
+    double unscale(AnalysisObject& ao, MergeKind kind) {
+      if (kind == MERGE_NONE) return 0.0;
+      const double scaledby = ao.annotation<double>("ScaledBy", 0.0);
+      const double hscale = (scaledby != 0) ? 1/scaledby : 0.0;
+      if (hscale != 0 && kind == MERGE_FILLABLE) dynamic_cast<Fillable&>(ao).scaleW(hscale);
+      return hscale + (kind == MERGE_SCATTER ? 1.0 : 0.0);
+    }
+
+
+    /// Add @a b into @a a
+    void combine(AnalysisObject& a, const AnalysisObject& b, MergeKind kind) {
+      if (kind == MERGE_FILLABLE) addFillable(a, b);
+      else if (kind == MERGE_SCATTER) addScatter(a, b);
+    }
+
+
+    /// Reapply the average normalisation, given the sum of the undone factors
+    void rescale(AnalysisObject& ao, MergeKind kind, double sum_sfs) {
+      if (sum_sfs == 0) return;
+      if (kind == MERGE_FILLABLE) {
+        dynamic_cast<Fillable&>(ao).scaleW(1/sum_sfs);
+      } else if (kind == MERGE_SCATTER) {
+        Scatter& s = dynamic_cast<Scatter&>(ao);
+        s.scale(s.dim(), 1/sum_sfs);
+      }
+    }
+
+
+    /// @brief Input stream buffer over file @a filename, read ahead a chunk at a time
+    ///
+    /// The next chunk is read on a background thread while the current one is
+    /// parsed, so at most two chunks of the file are held in memory at once.
+    class PrefetchBuf : public streambuf {
+    public:
+
+      PrefetchBuf(const string& filename, size_t chunksize=4 << 20)
+        : _filename(filename), _chunksize(chunksize)
+      {
+        if (filename == "-") {
+          _in = &cin;
+        } else {
+          _file.open(filename.c_str(), ios::binary);
+          if (_file.fail()) throw ReadError("Reading from filename " + filename + " failed");
+          _in = &_file;
+        }
+        _next = async(launch::async, &PrefetchBuf::readChunk, this);
+      }
+
+      /// Wait for any read in progress, since it uses the file
+      ~PrefetchBuf() {
+        if (_next.valid()) _next.wait();
+      }
+
+    protected:
+
+      int_type underflow() {
+        if (gptr() < egptr()) return traits_type::to_int_type(*gptr());
+        if (!_next.valid()) return traits_type::eof();
+        _chunk = _next.get();
+        if (_chunk.empty()) return traits_type::eof();
+        _next = async(launch::async, &PrefetchBuf::readChunk, this);
+        setg(&_chunk[0], &_chunk[0], &_chunk[0] + _chunk.size());
+        return traits_type::to_int_type(*gptr());
+      }
+
+    private:
+
+      /// The next chunk of the file, or an empty string at its end
+      string readChunk() {
+        string rtn(_chunksize, '\0');
+        _in->read(&rtn[0], rtn.size());
+        if (_in->bad()) throw ReadError("Reading from filename " + _filename + " failed");
+        rtn.resize(static_cast<size_t>(_in->gcount()));
+        return rtn;
+      }
+
+      string _filename;
+      size_t _chunksize;
+      ifstream _file;
+      istream* _in;
+      string _chunk;
+      future<string> _next;
+    };
+
+  }
+
+
+  vector<AnalysisObject*> merge(const vector< vector<AnalysisObject*> >& aoss, size_t nthreads) {
+    if (nthreads == 0) nthreads = max(thread::hardware_concurrency(), 1u);
+
+    // Group the objects by path, in order of first appearance
+    vector<MergeGroup> groups;
+    unordered_map<string, size_t> igroups;
+    for (const vector<AnalysisObject*>& aos : aoss) {
+      for (const AnalysisObject* ao : aos) {
+        const string path = ao->path();
+        unordered_map<string, size_t>::const_iterator ig = igroups.find(path);
+        if (ig == igroups.end()) {
+          ig = igroups.insert(make_pair(path, groups.size())).first;
+          groups.push_back(MergeGroup());
+          groups.back().type = ao->type();
+          groups.back().kind = mergeKind(groups.back().type);
+        }
+        MergeGroup& g = groups[ig->second];
+        if (ao->type() != g.type) continue;
+        if (g.kind == MERGE_NONE && !g.inputs.empty()) continue;
+        g.inputs.push_back(ao);
+      }
+    }
+
+    // Flat list of (group, item) tasks
+    vector< pair<size_t,size_t> > tasks;
+    for (size_t ig = 0; ig < groups.size(); ++ig) {
+      groups[ig].items.assign(groups[ig].inputs.size(), nullptr);
+      groups[ig].sfs.assign(groups[ig].inputs.size(), 0.0);
+      for (size_t i = 0; i < groups[ig].inputs.size(); ++i) tasks.push_back(make_pair(ig, i));
+    }
+
+    try {
+
+      // Copy each input, undoing any normalisation of the fillables
+      runParallel(tasks.size(), nthreads, [&](size_t itask) {
+          MergeGroup& g = groups[tasks[itask].first];
+          const size_t i = tasks[itask].second;
+          g.items[i] = g.inputs[i]->newclone();
+          g.sfs[i] = unscale(*g.items[i], g.kind);
+        });
+
+      // Reduce each group pairwise, a level of the tree at a time
+      for (size_t stride = 1; ; stride *= 2) {
+        tasks.clear();
+        for (size_t ig = 0; ig < groups.size(); ++ig) {
+          for (size_t i = 0; i + stride < groups[ig].items.size(); i += 2*stride) tasks.push_back(make_pair(ig, i));
+        }
+        if (tasks.empty()) break;
+        runParallel(tasks.size(), nthreads, [&](size_t itask) {
+            MergeGroup& g = groups[tasks[itask].first];
+            AnalysisObject*& a = g.items[tasks[itask].second];
+            AnalysisObject*& b = g.items[tasks[itask].second + stride];
+            combine(*a, *b, g.kind);
+            delete b;
+            b = nullptr;
+          });
+      }
+
+      // Reapply the average normalisation
+      runParallel(groups.size(), nthreads, [&](size_t ig) {
+          MergeGroup& g = groups[ig];
+          double sum_sfs = 0;
+          for (double sf : g.sfs) sum_sfs += sf;
+          rescale(*g.items[0], g.kind, sum_sfs);
+        });
+
+    } catch (...) {
+      for (MergeGroup& g : groups) {
+        for (AnalysisObject* ao : g.items) delete ao;
+      }
+      throw;
+    }
+
+    vector<AnalysisObject*> rtn;
+    rtn.reserve(groups.size());
+    for (const MergeGroup& g : groups) rtn.push_back(g.items[0]);
+    return rtn;
+  }
+
+
+
+  bool Merger::add(AnalysisObject* ao) {
+    const string path = ao->path();
+    unordered_map<string, size_t>::const_iterator ia = _index.find(path);
+    if (ia == _index.end()) {
+      const MergeKind kind = mergeKind(ao->type());
+      Accumulator acc = { ao, kind, 0.0 };
+      try {
+        acc.sum_sfs = unscale(*ao, kind);
+      } catch (...) {
+        delete ao;
+        throw;
+      }
+      _index[path] = _accs.size();
+      _accs.push_back(acc);
+      return true;
+    }
+
+    // Only objects of the type of the first with this path, and of a mergeable kind
+    Accumulator& acc = _accs[ia->second];
+    if (acc.kind == MERGE_NONE || ao->type() != acc.ao->type()) {
+      delete ao;
+      return false;
+    }
+    try {
+      const double sf = unscale(*ao, MergeKind(acc.kind));
+      combine(*acc.ao, *ao, MergeKind(acc.kind));
+      acc.sum_sfs += sf;
+    } catch (...) {
+      delete ao;
+      throw;
+    }
+    delete ao;
+    return true;
+  }
+
+
+  size_t Merger::add(const vector<AnalysisObject*>& aos, size_t nthreads) {
+    if (nthreads == 0) nthreads = max(thread::hardware_concurrency(), 1u);
+
+    // Group the objects by path, with empty accumulators for the new paths
+    const size_t naccs = _accs.size();
+    vector<MergeGroup> groups;
+    vector<size_t> iaccs;
+    unordered_map<size_t, size_t> igroups;
+    size_t nadded = 0;
+    for (const AnalysisObject* ao : aos) {
+      const string path = ao->path();
+      unordered_map<string, size_t>::const_iterator ia = _index.find(path);
+      if (ia == _index.end()) {
+        ia = _index.insert(make_pair(path, _accs.size())).first;
+        Accumulator acc = { nullptr, mergeKind(ao->type()), 0.0 };
+        _accs.push_back(acc);
+      }
+      unordered_map<size_t, size_t>::const_iterator ig = igroups.find(ia->second);
+      if (ig == igroups.end()) {
+        ig = igroups.insert(make_pair(ia->second, groups.size())).first;
+        const Accumulator& acc = _accs[ia->second];
+        groups.push_back(MergeGroup());
+        groups.back().type = acc.ao ? acc.ao->type() : ao->type();
+        groups.back().kind = MergeKind(acc.kind);
+        iaccs.push_back(ia->second);
+      }
+      // Only objects of the type of the first with this path, and of a mergeable kind
+      MergeGroup& g = groups[ig->second];
+      if (ao->type() != g.type) continue;
+      if (g.kind == MERGE_NONE && (_accs[ia->second].ao || !g.inputs.empty())) continue;
+      g.inputs.push_back(ao);
+      nadded += 1;
+    }
+
+    // Fold each group into its accumulator in order, a group per task
+    try {
+      runParallel(groups.size(), nthreads, [&](size_t ig) {
+          const MergeGroup& g = groups[ig];
+          Accumulator& acc = _accs[iaccs[ig]];
+          for (const AnalysisObject* input : g.inputs) {
+            unique_ptr<AnalysisObject> ao(input->newclone());
+            const double sf = unscale(*ao, g.kind);
+            if (acc.ao) combine(*acc.ao, *ao, g.kind);
+            else acc.ao = ao.release();
+            acc.sum_sfs += sf;
+          }
+        });
+    } catch (...) {
+      // Forget the new paths whose first object could not be merged
+      vector<Accumulator> kept(_accs.begin(), _accs.begin() + naccs);
+      for (unordered_map<string, size_t>::iterator ia = _index.begin(); ia != _index.end(); ) {
+        if (ia->second >= naccs) ia = _index.erase(ia);
+        else ++ia;
+      }
+      for (size_t i = naccs; i < _accs.size(); ++i) {
+        if (!_accs[i].ao) continue;
+        _index[_accs[i].ao->path()] = kept.size();
+        kept.push_back(_accs[i]);
+      }
+      _accs.swap(kept);
+      throw;
+    }
+    return nadded;
+  }
+
+
+  vector<AnalysisObject*> Merger::result() {
+    vector<AnalysisObject*> rtn;
+    rtn.reserve(_accs.size());
+    for (const Accumulator& acc : _accs) {
+      rescale(*acc.ao, MergeKind(acc.kind), acc.sum_sfs);
+      rtn.push_back(acc.ao);
+    }
+    _accs.clear();
+    _index.clear();
+    return rtn;
+  }
+
+
+  void Merger::reset() {
+    for (const Accumulator& acc : _accs) delete acc.ao;
+    _accs.clear();
+    _index.clear();
+  }
+
+
+
+  vector<AnalysisObject*> mergeFiles(const vector<string>& filenames,
+                                     const vector<string>& patterns, const vector<string>& unpatterns,
+                                     int verbosity) {
+    // Objects are selected by path before they are parsed
+    const Reader::PathFilter selected = Reader::mkPathFilter(patterns, unpatterns);
+
+    // Read each file ahead in the background while its objects are parsed and merged
+    Merger merger;
+    for (size_t i = 0; i < filenames.size(); ++i) {
+      const string& filename = filenames[i];
+      if (verbosity > 0) cerr << "Merging data file " << filename << " [" << i+1 << "/" << filenames.size() << "]" << endl;
+      PrefetchBuf buf(filename);
+      istream stream(&buf);
+      Reader& reader = (filename == "-") ? ReaderYODA::create() : mkReader(filename);
+      reader.readEach(stream, [&](AnalysisObject* ao) {
+          const string path = ao->path(), aotype = ao->type();
+          const MergeKind kind = mergeKind(aotype);
+          if (kind == MERGE_NONE && verbosity > 0) {
+            cerr << "WARNING: Analysis object " << path << " of type " << aotype << " cannot be merged" << endl;
+          } else if (kind == MERGE_SCATTER && verbosity > 1) {
+            cerr << "WARNING: scatter object '" << path << "' cannot be merged: will perform simple average" << endl;
+          }
+          if (!merger.add(ao) && kind != MERGE_NONE) {
+            cerr << "Unexpected type for analysis object '" << path << "' from " << filename << ": " << aotype << endl;
+          }
+        }, selected);
+    }
+    return merger.result();
+  }
+
+
+}
@@ -0,0 +1,73 @@
+// -*- C++ -*-
+//
+// This file is part of YODA -- Yet more Objects for Data Analysis
+// Copyright (C) 2008-2021 The YODA collaboration (see AUTHORS for details)
+//
+#include "YODA/MultiHisto1D.h"
+
+using namespace std;
+
+namespace YODA {
+
+
+  MultiHisto1D::MultiHisto1D(const std::vector<std::string>& streams, const Histo1D& h)
+    : AnalysisObject("MultiHisto1D", h.path(), h, h.title()),
+      MultiWeighted(streams),
+      _binning(h, "")
+  {
+    _binning.reset();
+    _bins = MultiDbns<Dbn1D>(_binning.numBins(), streams.size());
+    _flows = MultiDbns<Dbn1D>(3, streams.size());
+  }
+
+
+  MultiHisto1D::MultiHisto1D(const MultiHisto1D& h, const std::string& path)
+    : AnalysisObject("MultiHisto1D", (path.size() == 0) ? h.path() : path, h, h.title()),
+      MultiWeighted(h),
+      _binning(h._binning),
+      _bins(h._bins), _flows(h._flows)
+  { }
+
+
+  void MultiHisto1D::fill(double x, const double* weights, double fraction) {
+    if (std::isnan(x)) throw RangeError("X is NaN");
+
+    // Fill the overall distributions
+    _flows.fill(TOTAL, x, 0, 0, weights, fraction);
+
+    // Fill the bins and overflows, with one lookup for all the streams
+    if (numBins() == 0) return;
+    if (inRange(x, xMin(), xMax())) {
+      const ssize_t ibin = _binning.binIndexAt(x);
+      if (ibin >= 0) _bins.fill(ibin, x, 0, 0, weights, fraction);
+    } else if (x < xMin()) {
+      _flows.fill(UFLOW, x, 0, 0, weights, fraction);
+    } else if (x >= xMax()) {
+      _flows.fill(OFLOW, x, 0, 0, weights, fraction);
+    }
+  }
+
+
+  Histo1D MultiHisto1D::histo(size_t i) const {
+    std::vector<HistoBin1D> bins;
+    bins.reserve(numBins());
+    for (size_t ibin = 0; ibin < numBins(); ++ibin) {
+      bins.push_back(HistoBin1D(_binning.bin(ibin).xEdges(), _bins.dbn(ibin, i)));
+    }
+    Histo1D rtn(bins, _flows.dbn(TOTAL, i), _flows.dbn(UFLOW, i), _flows.dbn(OFLOW, i));
+    _expandInto(*this, rtn, i);
+    return rtn;
+  }
+
+
+  MultiHisto1D& MultiHisto1D::operator += (const MultiHisto1D& h) {
+    _checkStreams(h);
+    if (!_binning.sameBinning(h._binning)) throw LogicError("Attempted to add MultiHisto1Ds with different binnings");
+    _bins += h._bins;
+    _flows += h._flows;
+    _clearScales();
+    return *this;
+  }
+
+
+}
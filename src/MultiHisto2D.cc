@@ -0,0 +1,70 @@
+// -*- C++ -*-
+//
+// This file is part of YODA -- Yet more Objects for Data Analysis
+// Copyright (C) 2008-2021 The YODA collaboration (see AUTHORS for details)
+//
+#include "YODA/MultiHisto2D.h"
+
+using namespace std;
+
+namespace YODA {
+
+
+  MultiHisto2D::MultiHisto2D(const std::vector<std::string>& streams, const Histo2D& h)
+    : AnalysisObject("MultiHisto2D", h.path(), h, h.title()),
+      MultiWeighted(streams),
+      _binning(h, "")
+  {
+    _binning.reset();
+    _bins = MultiDbns<Dbn2D>(_binning.numBins(), streams.size());
+    _total = MultiDbns<Dbn2D>(1, streams.size());
+  }
+
+
+  MultiHisto2D::MultiHisto2D(const MultiHisto2D& h, const std::string& path)
+    : AnalysisObject("MultiHisto2D", (path.size() == 0) ? h.path() : path, h, h.title()),
+      MultiWeighted(h),
+      _binning(h._binning),
+      _bins(h._bins), _total(h._total)
+  { }
+
+
+  void MultiHisto2D::fill(double x, double y, const double* weights, double fraction) {
+    if (std::isnan(x) || std::isnan(y)) throw RangeError(std::isnan(x) ? "X is NaN" : "Y is NaN");
+
+    // Fill the overall distributions
+    _total.fill(0, x, y, 0, weights, fraction);
+
+    // Fill the bins, with one lookup for all the streams
+    if (numBins() == 0) return;
+    if (inRange(x, xMin(), xMax()) && inRange(y, yMin(), yMax())) {
+      const int ibin = _binning.binIndexAt(x, y);
+      if (ibin >= 0) _bins.fill(ibin, x, y, 0, weights, fraction);
+    }
+  }
+
+
+  Histo2D MultiHisto2D::histo(size_t i) const {
+    std::vector<HistoBin2D> bins;
+    bins.reserve(numBins());
+    for (size_t ibin = 0; ibin < numBins(); ++ibin) {
+      const HistoBin2D& b = _binning.bin(ibin);
+      bins.push_back(HistoBin2D(b.xEdges(), b.yEdges(), _bins.dbn(ibin, i)));
+    }
+    Histo2D rtn(bins, _total.dbn(0, i), Histo2D::Outflows(8));
+    _expandInto(*this, rtn, i);
+    return rtn;
+  }
+
+
+  MultiHisto2D& MultiHisto2D::operator += (const MultiHisto2D& h) {
+    _checkStreams(h);
+    if (!_binning.sameBinning(h._binning)) throw LogicError("Attempted to add MultiHisto2Ds with different binnings");
+    _bins += h._bins;
+    _total += h._total;
+    _clearScales();
+    return *this;
+  }
+
+
+}
@@ -0,0 +1,72 @@
+// -*- C++ -*-
+//
+// This file is part of YODA -- Yet more Objects for Data Analysis
+// Copyright (C) 2008-2021 The YODA collaboration (see AUTHORS for details)
+//
+#include "YODA/MultiProfile1D.h"
+
+using namespace std;
+
+namespace YODA {
+
+
+  MultiProfile1D::MultiProfile1D(const std::vector<std::string>& streams, const Profile1D& p)
+    : AnalysisObject("MultiProfile1D", p.path(), p, p.title()),
+      MultiWeighted(streams),
+      _binning(p, "")
+  {
+    _binning.reset();
+    _bins = MultiDbns<Dbn2D>(_binning.numBins(), streams.size());
+    _flows = MultiDbns<Dbn2D>(3, streams.size());
+  }
+
+
+  MultiProfile1D::MultiProfile1D(const MultiProfile1D& p, const std::string& path)
+    : AnalysisObject("MultiProfile1D", (path.size() == 0) ? p.path() : path, p, p.title()),
+      MultiWeighted(p),
+      _binning(p._binning),
+      _bins(p._bins), _flows(p._flows)
+  { }
+
+
+  void MultiProfile1D::fill(double x, double y, const double* weights, double fraction) {
+    if (std::isnan(x) || std::isnan(y)) throw RangeError(std::isnan(x) ? "X is NaN" : "Y is NaN");
+
+    // Fill the overall distributions
+    _flows.fill(TOTAL, x, y, 0, weights, fraction);
+
+    // Fill the bins and overflows, with one lookup for all the streams
+    if (numBins() == 0) return;
+    if (inRange(x, xMin(), xMax())) {
+      const ssize_t ibin = _binning.binIndexAt(x);
+      if (ibin >= 0) _bins.fill(ibin, x, y, 0, weights, fraction);
+    } else if (x < xMin()) {
+      _flows.fill(UFLOW, x, y, 0, weights, fraction);
+    } else if (x >= xMax()) {
+      _flows.fill(OFLOW, x, y, 0, weights, fraction);
+    }
+  }
+
+
+  Profile1D MultiProfile1D::profile(size_t i) const {
+    std::vector<ProfileBin1D> bins;
+    bins.reserve(numBins());
+    for (size_t ibin = 0; ibin < numBins(); ++ibin) {
+      bins.push_back(ProfileBin1D(_binning.bin(ibin).xEdges(), _bins.dbn(ibin, i)));
+    }
+    Profile1D rtn(bins, _flows.dbn(TOTAL, i), _flows.dbn(UFLOW, i), _flows.dbn(OFLOW, i));
+    _expandInto(*this, rtn, i);
+    return rtn;
+  }
+
+
+  MultiProfile1D& MultiProfile1D::operator += (const MultiProfile1D& p) {
+    _checkStreams(p);
+    if (!_binning.sameBinning(p._binning)) throw LogicError("Attempted to add MultiProfile1Ds with different binnings");
+    _bins += p._bins;
+    _flows += p._flows;
+    return *this;
+  }
+
+
+}
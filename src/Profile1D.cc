@@ -14,19 +14,24 @@ namespace YODA {
 
 
   void Profile1D::fill(double x, double y, double weight, double fraction) {
-    if ( std::isnan(x) ) throw RangeError("X is NaN");
-    if ( std::isnan(y) ) throw RangeError("Y is NaN");
+    if ( std::isnan(x) || std::isnan(y) ) {
+      if (_axis.nanPolicy() == FILL_THROW) throw RangeError(std::isnan(x) ? "X is NaN" : "Y is NaN");
+      _axis._fillNaN(weight, fraction);
+      return;
+    }
+
+    // Find the bin, applying the gap policy before anything is filled
+    const bool inrange = inRange(x, _axis.xMin(), _axis.xMax());
+    const ssize_t i = inrange ? _axis.binIndexAt(x) : -1;
+    if (inrange && i < 0) _axis._fillGap(x, weight, fraction);
 
     // Fill the overall distribution
     _axis.totalDbn().fill(x, y, weight, fraction);
 
     // Fill the bins and overflows
     /// Unify this with Histo1D's version, when binning and inheritance are reworked
-    if (inRange(x, _axis.xMin(), _axis.xMax())) {
-      try {
-        /// @todo Replace try block with a check that there is a bin at x
-        _binAt(x).fill(x, y, weight, fraction);
-      } catch (const RangeError& re) {    }
+    if (inrange) {
+      if (i >= 0) _axis._fillBin(i, x, y, weight, fraction);
     } else if (x < _axis.xMin()) {
       _axis.underflow().fill(x, y, weight, fraction);
     } else if (x >= _axis.xMax()) {
@@ -38,8 +43,59 @@ namespace YODA {
   }
 
 
+  void Profile1D::fillMany(size_t n, const double* xs, const double* ys,
+                           const double* weights, const double* fractions) {
+    // An empty axis has no range: let the scalar fill handle it
+    if (_axis.numBins() == 0) {
+      for (size_t k = 0; k < n; ++k) fill(xs[k], ys[k], weights ? weights[k] : 1.0, fractions ? fractions[k] : 1.0);
+      return;
+    }
+
+    const double xmin = _axis.xMin(), xmax = _axis.xMax();
+
+    // Look up the bin indices a chunk at a time, then accumulate in fill order
+    // so that every Dbn sees the same sequence as with scalar fills
+    bool filled = false;
+    ssize_t ibins[FILLMANY_CHUNK];
+    for (size_t k0 = 0; k0 < n; k0 += FILLMANY_CHUNK) {
+      const size_t nk = std::min(FILLMANY_CHUNK, n - k0);
+      _axis.binIndicesAt(nk, xs+k0, ibins);
+      for (size_t j = 0; j < nk; ++j) {
+        const size_t k = k0 + j;
+        const double x = xs[k], y = ys[k];
+        const double w = weights ? weights[k] : 1.0;
+        const double f = fractions ? fractions[k] : 1.0;
+        if (std::isnan(x) || std::isnan(y)) {
+          if (_axis.nanPolicy() == FILL_THROW) {
+            if (filled) _axis._setLock(true);
+            throw RangeError(std::isnan(x) ? "X is NaN" : "Y is NaN");
+          }
+          _axis._fillNaN(w, f);
+          continue;
+        }
+        if (ibins[j] < 0 && x >= xmin && x < xmax) {
+          if (filled) _axis._setLock(true);
+          _axis._fillGap(x, w, f);
+        }
+        _axis.totalDbn().fill(x, y, w, f);
+        filled = true;
+        if (ibins[j] >= 0) {
+          _axis._fillBin(ibins[j], x, y, w, f);
+        } else if (x < xmin) {
+          _axis.underflow().fill(x, y, w, f);
+        } else if (x >= xmax) {
+          _axis.overflow().fill(x, y, w, f);
+        }
+      }
+    }
+
+    // Lock the axis if any entry was filled, as the scalar fill would have
+    if (filled) _axis._setLock(true);
+  }
+
+
   void Profile1D::fillBin(size_t i, double y, double weight, double fraction) {
-    fill(bin(i).xMid(), y, weight, fraction);
+    fill(_axis.binMid(i), y, weight, fraction);
   }
 
 
@@ -64,17 +120,13 @@ namespace YODA {
 
   double Profile1D::sumW(bool includeoverflows) const {
     if (includeoverflows) return _axis.totalDbn().sumW();
-    double sumw = 0;
-    for (const Bin& b : bins()) sumw += b.sumW();
-    return sumw;
+    return _axis.binTotalDbn().sumW();
   }
 
 
   double Profile1D::sumW2(bool includeoverflows) const {
     if (includeoverflows) return _axis.totalDbn().sumW2();
-    double sumw2 = 0;
-    for (const Bin& b : bins()) sumw2 += b.sumW2();
-    return sumw2;
+    return _axis.binTotalDbn().sumW2();
   }
 
   // ^^^^^^^^^^^^^^^^^^
@@ -82,32 +134,28 @@ namespace YODA {
 
   double Profile1D::xMean(bool includeoverflows) const {
     if (includeoverflows) return _axis.totalDbn().xMean();
-    Dbn2D dbn;
-    for (const ProfileBin1D& b : bins()) dbn += b.dbn();
+    const Dbn2D dbn = _axis.binTotalDbn();
     return dbn.xMean();
   }
 
 
   double Profile1D::xVariance(bool includeoverflows) const {
     if (includeoverflows) return _axis.totalDbn().xVariance();
-    Dbn2D dbn;
-    for (const ProfileBin1D& b : bins()) dbn += b.dbn();
+    const Dbn2D dbn = _axis.binTotalDbn();
     return dbn.xVariance();
   }
 
 
   double Profile1D::xStdErr(bool includeoverflows) const {
     if (includeoverflows) return _axis.totalDbn().xStdErr();
-    Dbn2D dbn;
-    for (const ProfileBin1D& b : bins()) dbn += b.dbn();
+    const Dbn2D dbn = _axis.binTotalDbn();
     return dbn.xStdErr();
   }
 
 
   double Profile1D::xRMS(bool includeoverflows) const {
     if (includeoverflows) return _axis.totalDbn().xRMS();
-    Dbn2D dbn;
-    for (const ProfileBin1D& b : bins()) dbn += b.dbn();
+    const Dbn2D dbn = _axis.binTotalDbn();
     return dbn.xRMS();
   }
 
@@ -13,21 +13,31 @@ namespace YODA {
 
 
   void Profile2D::fill(double x, double y, double z, double weight, double fraction) {
-    if ( std::isnan(x) ) throw RangeError("X is NaN");
-    if ( std::isnan(y) ) throw RangeError("Y is NaN");
-    if ( std::isnan(z) ) throw RangeError("Z is NaN");
+    if ( std::isnan(x) || std::isnan(y) || std::isnan(z) ) {
+      if (_axis.nanPolicy() == FILL_THROW)
+        throw RangeError(std::isnan(x) ? "X is NaN" : std::isnan(y) ? "Y is NaN" : "Z is NaN");
+      _axis._fillNaN(weight, fraction);
+      return;
+    }
+
+    // Queue the fill if buffering, leaving the bin lookup to the flush
+    if (_axis.fillBufferSize() > 0) {
+      _axis._bufferFill(x, y, z, weight, fraction);
+      _axis._setLock(true);
+      return;
+    }
+
+    // Find the bin, applying the gap policy before anything is filled
+    const bool inrange = inRange(x, _axis.xMin(), _axis.xMax()) && inRange(y, _axis.yMin(), _axis.yMax());
+    const int i = inrange ? _axis.binIndexAt(x, y) : -1;
+    if (inrange && i < 0) _axis._fillGap(x, y, weight, fraction);
 
     // Fill the overall distribution
     _axis.totalDbn().fill(x, y, z, weight, fraction);
 
     // Fill the bins and overflows
     /// Unify this with Histo2D's version, when binning and inheritance are reworked
-    if (inRange(x, _axis.xMin(), _axis.xMax()) && inRange(y, _axis.yMin(), _axis.yMax())) {
-      try {
-        /// @todo Replace try block with a check that there is a bin at x, y
-        _binAt(x, y).fill(x, y, z, weight, fraction);
-      } catch (const RangeError& re) {    }
-    }
+    if (i >= 0) _axis._fillBin(i, x, y, z, weight, fraction);
     /// @todo Reinstate! With outflow axis bin lookup
     // else {
     //   size_t ix(0), iy(0);
@@ -41,8 +51,14 @@ namespace YODA {
   }
 
 
+  void Profile2D::fillMany(size_t n, const double* xs, const double* ys, const double* zs,
+                           const double* weights, const double* fractions) {
+    _axis._fillMany(n, xs, ys, zs, weights, fractions);
+  }
+
+
   void Profile2D::fillBin(size_t i, double z, double weight, double fraction) {
-    pair<double, double> mid = bin(i).xyMid();
+    const pair<double, double> mid = _axis.binMid(i);
     fill(mid.first, mid.second, z, weight, fraction);
   }
 
@@ -67,17 +83,13 @@ namespace YODA {
 
   double Profile2D::sumW(bool includeoverflows) const {
     if (includeoverflows) return _axis.totalDbn().sumW2();
-    double sumw = 0;
-    for (const Bin& b : bins()) sumw += b.sumW();
-    return sumw;
+    return _axis.binTotalDbn().sumW();
   }
 
 
   double Profile2D::sumW2(bool includeoverflows) const {
     if (includeoverflows) return _axis.totalDbn().sumW2();
-    double sumw2 = 0;
-    for (const Bin& b : bins()) sumw2 += b.sumW2();
-    return sumw2;
+    return _axis.binTotalDbn().sumW2();
   }
 
   // ^^^^^^^^^^^
@@ -85,64 +97,56 @@ namespace YODA {
 
   double Profile2D::xMean(bool includeoverflows) const {
     if (includeoverflows) return _axis.totalDbn().xMean();
-    Dbn3D dbn;
-    for (const ProfileBin2D& b : bins()) dbn += b.dbn();
+    const Dbn3D dbn = _axis.binTotalDbn();
     return dbn.xMean();
   }
 
 
   double Profile2D::yMean(bool includeoverflows) const {
     if (includeoverflows) return _axis.totalDbn().yMean();
-    Dbn3D dbn;
-    for (const ProfileBin2D& b : bins()) dbn += b.dbn();
+    const Dbn3D dbn = _axis.binTotalDbn();
     return dbn.yMean();
   }
 
 
   double Profile2D::xVariance(bool includeoverflows) const {
     if (includeoverflows) return _axis.totalDbn().xVariance();
-    Dbn3D dbn;
-    for (const ProfileBin2D& b : bins()) dbn += b.dbn();
+    const Dbn3D dbn = _axis.binTotalDbn();
     return dbn.xVariance();
   }
 
 
   double Profile2D::yVariance(bool includeoverflows) const {
     if (includeoverflows) return _axis.totalDbn().yVariance();
-    Dbn3D dbn;
-    for (const ProfileBin2D& b : bins()) dbn += b.dbn();
+    const Dbn3D dbn = _axis.binTotalDbn();
     return dbn.yVariance();
   }
 
 
   double Profile2D::xStdErr(bool includeoverflows) const {
     if (includeoverflows) return _axis.totalDbn().xStdErr();
-    Dbn3D dbn;
-    for (const ProfileBin2D& b : bins()) dbn += b.dbn();
+    const Dbn3D dbn = _axis.binTotalDbn();
     return dbn.xStdErr();
   }
 
 
   double Profile2D::yStdErr(bool includeoverflows) const {
     if (includeoverflows) return _axis.totalDbn().yStdErr();
-    Dbn3D dbn;
-    for (const ProfileBin2D& b : bins()) dbn += b.dbn();
+    const Dbn3D dbn = _axis.binTotalDbn();
     return dbn.yStdErr();
   }
 
 
   double Profile2D::xRMS(bool includeoverflows) const {
     if (includeoverflows) return _axis.totalDbn().xRMS();
-    Dbn3D dbn;
-    for (const ProfileBin2D& b : bins()) dbn += b.dbn();
+    const Dbn3D dbn = _axis.binTotalDbn();
     return dbn.xRMS();
   }
 
 
   double Profile2D::yRMS(bool includeoverflows) const {
     if (includeoverflows) return _axis.totalDbn().yRMS();
-    Dbn3D dbn;
-    for (const ProfileBin2D& b : bins()) dbn += b.dbn();
+    const Dbn3D dbn = _axis.binTotalDbn();
     return dbn.yRMS();
   }
 
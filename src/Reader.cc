@@ -8,6 +8,10 @@
 #include "YODA/ReaderAIDA.h"
 #include "YODA/ReaderFLAT.h"
 #include "YODA/Config/DummyConfig.h"
+#include <regex>
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
 
 using namespace std;
 
@@ -34,4 +38,39 @@ namespace YODA {
   }
 
 
+  Reader::PathFilter Reader::mkPathFilter(const vector<string>& patterns, const vector<string>& unpatterns) {
+    if (patterns.empty() && unpatterns.empty()) return PathFilter();
+    vector<regex> res, unres;
+    try {
+      for (const string& patt : patterns) res.push_back(regex(patt, regex::optimize));
+      for (const string& patt : unpatterns) unres.push_back(regex(patt, regex::optimize));
+    } catch (const regex_error& e) {
+      throw UserError("Invalid path regex: " + string(e.what()));
+    }
+    return [res, unres](const string& path) {
+      const auto matches = [&path](const regex& re) { return regex_search(path, re); };
+      if (!res.empty() && none_of(res.begin(), res.end(), matches)) return false;
+      return none_of(unres.begin(), unres.end(), matches);
+    };
+  }
+
+
+  vector<AnalysisObject*> Reader::readObjects(const string& filename, const vector<string>& paths) {
+    // Keep the first object with each of the paths, skipping the rest unread
+    const unordered_set<string> wanted(paths.begin(), paths.end());
+    unordered_map<string, AnalysisObject*> found;
+    readEach(filename, [&found](AnalysisObject* ao) {
+        if (!found.insert({ao->path(), ao}).second) delete ao;
+      }, [&wanted](const string& path) { return wanted.count(path) > 0; });
+    vector<AnalysisObject*> rtn;
+    for (const string& path : paths) {
+      auto it = found.find(path);
+      if (it == found.end() || !it->second) continue;
+      rtn.push_back(it->second);
+      it->second = nullptr;
+    }
+    return rtn;
+  }
+
+
 }
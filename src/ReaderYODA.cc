@@ -14,6 +14,8 @@
 #include "YODA/Counter.h"
 #include "YODA/Histo1D.h"
 #include "YODA/Histo2D.h"
+#include "YODA/CountHisto1D.h"
+#include "YODA/CountHisto2D.h"
 #include "YODA/Profile1D.h"
 #include "YODA/Profile2D.h"
 #include "YODA/Scatter1D.h"
@@ -34,6 +36,22 @@
 #include <locale>
 #include <string>
 #include <cstring>
+#include <cstdint>
+#include <cfloat>
+#include <cerrno>
+#include <clocale>
+#include <deque>
+#include <unordered_set>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 using namespace std;
 
 namespace YODA {
@@ -46,31 +64,357 @@ namespace YODA {
 
   namespace {
 
+    /// @brief A view of the characters [b, e) of a line
+    ///
+    /// Lines are only inspected and tokenised in place, so there is no need
+    /// to copy each one into a string first.
+    struct Span {
+      Span(const char* begin=0, const char* end=0) : b(begin), e(end) { }
+      explicit Span(const string& s) : b(s.data()), e(s.data() + s.size()) { }
+
+      size_t size() const { return e - b; }
+      bool empty() const { return b == e; }
+      bool startswith(char c) const { return b != e && *b == c; }
+
+      /// Does the line contain @a needle anywhere?
+      bool contains(const char* needle) const {
+        const size_t n = strlen(needle);
+        for (const char* p = b; size_t(e - p) >= n; ++p) {
+          p = static_cast<const char*>(memchr(p, needle[0], e - p));
+          if (!p || size_t(e - p) < n) return false;
+          if (memcmp(p, needle, n) == 0) return true;
+        }
+        return false;
+      }
+
+      bool operator == (const char* str) const {
+        const size_t n = strlen(str);
+        return size() == n && memcmp(b, str, n) == 0;
+      }
+
+      /// Trim whitespace from both ends, as Utils::itrim
+      void trim() {
+        while (b != e && std::isspace(static_cast<unsigned char>(*b))) b += 1;
+        while (e != b && std::isspace(static_cast<unsigned char>(e[-1]))) e -= 1;
+      }
+
+      string str() const { return string(b, e); }
+
+      const char *b, *e;
+    };
+
+
+    /// @brief Splitter of input into lines, handling LF, CRLF and CR endings as Utils::getline
+    ///
+    /// The lines are spans either directly into input which is wholly in
+    /// memory, e.g. a memory-mapped file, or into a buffer refilled from a
+    /// stream in large chunks, and are only valid until the next call. Every
+    /// line is followed by its line ending or a null, so that numbers can be
+    /// parsed straight from it.
+    class LineReader {
+    public:
+
+      /// Lines of the in-memory input [begin, end), which must end with a line ending
+      LineReader(const char* begin, const char* end)
+        : _sb(0), _pos(begin), _end(end), _nl(0), _eof(true)
+      { }
+
+      /// Lines read from stream buffer @a sb
+      LineReader(streambuf* sb)
+        : _sb(sb), _buf(CHUNK+1), _pos(&_buf[0]), _end(_pos), _nl(0), _eof(false)
+      { _buf[0] = '\0'; }
+
+      /// Start of the next line, for in-memory input
+      const char* pos() const { return _pos; }
+
+      /// Get the next line, returning false at the end of the input
+      bool next(Span& line) {
+        for (;;) {
+          const char* eol = _findEOL();
+          // A CR at the end of the buffer may be the start of a CRLF
+          if (eol && (*eol == '\n' || eol+1 < _end || _eof)) {
+            line = Span(_pos, eol);
+            _pos = eol + 1;
+            if (*eol == '\r' && _pos < _end && *_pos == '\n') _pos += 1;
+            return true;
+          }
+          if (_eof) {
+            // Also handle the case when the last line has no line ending
+            if (_pos == _end) return false;
+            line = Span(_pos, _end);
+            _pos = _end;
+            return true;
+          }
+          _refill();
+        }
+      }
+
+    private:
+
+      static const size_t CHUNK = 1 << 20;
+
+      /// Find the end of the line starting at _pos, or null if it is not yet in the buffer
+      const char* _findEOL() {
+        // Remember where the next LF is, so that CR-only input is not rescanned for one on every line
+        if (!_nl || _nl < _pos) {
+          _nl = static_cast<const char*>(memchr(_pos, '\n', _end - _pos));
+          if (!_nl) _nl = _end;
+        }
+        const char* cr = static_cast<const char*>(memchr(_pos, '\r', _nl - _pos));
+        if (cr) return cr;
+        return _nl < _end ? _nl : 0;
+      }
+
+      /// Move the incomplete last line to the front of the buffer and read the next chunk after it
+      void _refill() {
+        const size_t keep = _end - _pos;
+        if (keep > 0 && _pos != &_buf[0]) memmove(&_buf[0], _pos, keep);
+        if (keep + CHUNK + 1 > _buf.size()) _buf.resize(keep + CHUNK + 1);
+        const streamsize n = _sb->sgetn(&_buf[keep], CHUNK);
+        if (n <= 0) _eof = true;
+        _pos = &_buf[0];
+        _end = _pos + keep + (n > 0 ? n : 0);
+        _buf[_end - _pos] = '\0';
+        _nl = 0;
+      }
+
+      streambuf* _sb;
+      vector<char> _buf;
+      const char *_pos, *_end, *_nl;
+      bool _eof;
+    };
+
+
+    /// @brief Table of 5^q for q in [-342, 308], for converting decimals to binary
+    ///
+    /// Each entry is the top 64 bits of the power, scaled by a power of two to
+    /// have its highest bit set, together with the sum of q and that power's
+    /// binary exponent, floor(log2(5^q)), which is floor(q log2(10)). The
+    /// table is computed once, exactly, with simple big-integer arithmetic.
+    class PowersOfFive {
+    public:
+
+      static const int QMIN = -342, QMAX = 308;
+
+      static const PowersOfFive& get() {
+        static const PowersOfFive table;
+        return table;
+      }
+
+      uint64_t mantissa(int q) const { return _mantissas[q - QMIN]; }
+      int exponent10(int q) const { return _exponents[q - QMIN]; }
+
+    private:
+
+      PowersOfFive() : _mantissas(QMAX - QMIN + 1), _exponents(QMAX - QMIN + 1) {
+        // Positive powers by repeated multiplication, truncated to their top 64 bits
+        vector<uint32_t> big(1, 1);
+        for (int q = 0; q <= QMAX; ++q) {
+          _set(q, big, 0);
+          uint64_t carry = 0;
+          for (uint32_t& word : big) {
+            carry += 5 * uint64_t(word);
+            word = uint32_t(carry);
+            carry >>= 32;
+          }
+          if (carry) big.push_back(uint32_t(carry));
+        }
+        // Negative powers as floor(2^2048 / 5^-q), by repeated exact division
+        const size_t NBITS = 2048;
+        big.assign(NBITS/32 + 1, 0);
+        big.back() = 1;
+        for (int q = -1; q >= QMIN; --q) {
+          uint64_t rem = 0;
+          for (size_t i = big.size(); i-- > 0; ) {
+            rem = (rem << 32) | big[i];
+            big[i] = uint32_t(rem / 5);
+            rem %= 5;
+          }
+          while (big.back() == 0) big.pop_back();
+          _set(q, big, NBITS);
+        }
+      }
+
+      /// Set the entry for 5^q from the integer @a big, which is 5^q * 2^@a shift rounded down
+      void _set(int q, const vector<uint32_t>& big, size_t shift) {
+        const size_t nbits = 32*big.size() - _clz32(big.back());
+        uint64_t top = 0;
+        for (size_t bit = nbits; bit-- > 0 && nbits - bit <= 64; ) {
+          top = (top << 1) | ((big[bit/32] >> (bit%32)) & 1);
+        }
+        if (nbits < 64) top <<= 64 - nbits;
+        _mantissas[q - QMIN] = top;
+        _exponents[q - QMIN] = q + int(nbits - 1) - int(shift);
+      }
+
+      static int _clz32(uint32_t x) {
+        int n = 0;
+        while (!(x & 0x80000000u)) { x <<= 1; n += 1; }
+        return n;
+      }
+
+      vector<uint64_t> _mantissas;
+      vector<int> _exponents;
+    };
+
+
+    /// The high and low 64 bits of the 128-bit product of @a a and @a b
+    inline void multiply64(uint64_t a, uint64_t b, uint64_t& hi, uint64_t& lo) {
+      #ifdef __SIZEOF_INT128__
+      __extension__ typedef unsigned __int128 uint128;
+      const uint128 p = uint128(a) * b;
+      hi = uint64_t(p >> 64);
+      lo = uint64_t(p);
+      #else
+      const uint64_t alo = uint32_t(a), ahi = a >> 32, blo = uint32_t(b), bhi = b >> 32;
+      const uint64_t ll = alo*blo, lh = alo*bhi, hl = ahi*blo, hh = ahi*bhi;
+      const uint64_t mid = (ll >> 32) + uint32_t(lh) + uint32_t(hl);
+      hi = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+      lo = (mid << 32) | uint32_t(ll);
+      #endif
+    }
+
+
+    /// Number of leading zero bits of non-zero @a x
+    inline int clz64(uint64_t x) {
+      #ifdef __GNUC__
+      return __builtin_clzll(x);
+      #else
+      int n = 0;
+      while (!(x & (uint64_t(1) << 63))) { x <<= 1; n += 1; }
+      return n;
+      #endif
+    }
+
+
+    /// Parse a number with strtod in the "C" locale, whatever the locale of the program
+    double strtodC(const char* str, char** end) {
+      static const locale_t clocale = newlocale(LC_NUMERIC_MASK, "C", (locale_t)0);
+      const locale_t prev = uselocale(clocale);
+      if (!clocale || !prev) throw ReadError(std::string("Error setting locale: ") + strerror(errno));
+      const double rtn = std::strtod(str, end);
+      uselocale(prev);
+      return rtn;
+    }
+
+
+    /// @brief Locale-independent, correctly rounded parsing of a decimal number, as by strtod
+    ///
+    /// Decimals with up to 19 significant digits, which include all those
+    /// written by WriterYODA, are converted directly: exactly in floating
+    /// point if both the digits and the power of ten are small enough
+    /// (Clinger's fast path), and otherwise as by the Eisel-Lemire algorithm,
+    /// by multiplying the digits by a 64-bit approximation of the power of
+    /// ten. Everything else, e.g. longer decimals, infinities and NaNs,
+    /// results too near the midpoint between two doubles to be sure of the
+    /// rounding, and subnormal or overflowing results, is passed to strtod.
+    double parseDouble(const char* str, char** end) {
+      const char* p = str;
+      const bool neg = *p == '-';
+      if (neg || *p == '+') p += 1;
+      // Up to 19 significant digits, and the power of ten they are to be multiplied by
+      uint64_t w = 0;
+      int nsig = 0, q = 0;
+      bool digits = false;
+      for (; *p >= '0' && *p <= '9'; ++p) {
+        digits = true;
+        if (w != 0 || *p != '0') {
+          if (nsig++ == 19) return strtodC(str, end);
+          w = 10*w + (*p - '0');
+        }
+      }
+      if (*p == '.') {
+        for (++p; *p >= '0' && *p <= '9'; ++p) {
+          digits = true;
+          q -= 1;
+          if (w != 0 || *p != '0') {
+            if (nsig++ == 19) return strtodC(str, end);
+            w = 10*w + (*p - '0');
+          }
+        }
+      }
+      if (!digits) return strtodC(str, end);
+      if (*p == 'e' || *p == 'E') {
+        const char* pe = p + 1;
+        const bool eneg = *pe == '-';
+        if (eneg || *pe == '+') pe += 1;
+        if (*pe < '0' || *pe > '9') return strtodC(str, end);
+        int e = 0;
+        for (; *pe >= '0' && *pe <= '9'; ++pe) {
+          if (e < 100000) e = 10*e + (*pe - '0');
+        }
+        q += eneg ? -e : e;
+        p = pe;
+      }
+      // Leave anything but a whole token, e.g. hexadecimal, to strtod
+      if (*p != '\0' && !std::isspace(static_cast<unsigned char>(*p))) return strtodC(str, end);
+      *end = const_cast<char*>(p);
+      if (w == 0) return neg ? -0.0 : 0.0;
+
+      // Exact digits times an exact power of ten, rounded once
+      #if FLT_EVAL_METHOD == 0
+      static const double POW10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                      1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+      if (w <= (uint64_t(1) << 53) && q >= -22 && q <= 22) {
+        const double x = q < 0 ? double(w) / POW10[-q] : double(w) * POW10[q];
+        return neg ? -x : x;
+      }
+      #endif
+
+      // Eisel-Lemire: the top 54 bits of w * 5^q give the 53-bit mantissa and a rounding bit
+      if (q < PowersOfFive::QMIN || q > PowersOfFive::QMAX) return strtodC(str, end);
+      const PowersOfFive& pow5 = PowersOfFive::get();
+      const int lz = clz64(w);
+      uint64_t hi, lo;
+      multiply64(w << lz, pow5.mantissa(q), hi, lo);
+      const int upperbit = int(hi >> 63);
+      const int shift = upperbit + 9;
+      // The product is low by less than 2^64, so the rounding is only unsure just below a midpoint
+      const uint64_t rem = hi & ((uint64_t(1) << (shift + 1)) - 1);
+      const uint64_t half = uint64_t(1) << shift;
+      if (rem == half || rem == half - 1) return strtodC(str, end);
+      uint64_t mantissa = ((hi >> shift) + 1) >> 1;
+      int exponent = pow5.exponent10(q) + 63 + upperbit - lz + 1023;
+      if (mantissa == (uint64_t(1) << 53)) {
+        mantissa >>= 1;
+        exponent += 1;
+      }
+      if (exponent <= 0 || exponent >= 0x7FF) return strtodC(str, end);
+      const uint64_t bits = (uint64_t(neg) << 63) | (uint64_t(exponent) << 52) | (mantissa & ((uint64_t(1) << 52) - 1));
+      double x;
+      memcpy(&x, &bits, sizeof(x));
+      return x;
+    }
+
+
     /// Fast ASCII tokenizer, extended from FastIStringStream by Gavin Salam.
+    ///
+    /// Numbers are read with parseDouble, independently of the locale, and
+    /// words as spans of the line, without copying.
     class aistringstream {
     public:
       // Constructor from char*
       aistringstream(const char* line=0) {
         reset(line);
-        _set_locale();
       }
       // Constructor from std::string
       aistringstream(const string& line) {
         reset(line);
-        _set_locale();
-      }
-      ~aistringstream() {
-        _reset_locale();
       }
 
-      // Re-init to new line as char*
+      // Re-init to new null-terminated line as char*
       void reset(const char* line=0) {
-        _next = const_cast<char*>(line);
+        reset(line, line ? line + strlen(line) : 0);
+      }
+      // Re-init to new line as std::string
+      void reset(const string& line) { reset(line.c_str(), line.c_str() + line.size()); }
+      // Re-init to the line [begin, end), which must be followed by whitespace or a null
+      void reset(const char* begin, const char* end) {
+        _next = const_cast<char*>(begin);
         _new_next = _next;
+        _end = end;
         _error = false;
       }
-      // Re-init to new line as std::string
-      void reset(const string& line) { reset(line.c_str()); }
 
       // Tokenizing stream operator (forwards to specialisations)
       template<class T>
@@ -87,67 +431,399 @@ namespace YODA {
 
     private:
 
-      // Changes the thread-local locale to interpret numbers in the "C" locale
-      void _set_locale() {
-        _locale_set = newlocale(LC_NUMERIC_MASK, "C", NULL);
-        _locale_prev = uselocale(_locale_set);
-        if (!_locale_prev) {
-          throw ReadError(std::string("Error setting locale: ") + strerror(errno));
+      // Skip to the next token, returning false if the line has no more
+      bool _skip() {
+        while (_next < _end && std::isspace(static_cast<unsigned char>(*_next))) _next += 1;
+        _new_next = _next;
+        return _next < _end;
+      }
+
+      void _get(double& x) { x = _skip() ? parseDouble(_next, &_new_next) : 0; }
+      void _get(int& i) { i = _skip() ? std::strtol(_next, &_new_next, 10) : 0; } // force base 10!
+      void _get(long& i) { i = _skip() ? std::strtol(_next, &_new_next, 10) : 0; } // force base 10!
+      void _get(unsigned int& i) { i = _skip() ? std::strtoul(_next, &_new_next, 10) : 0; } // force base 10!
+      void _get(long unsigned int& i) { i = _skip() ? std::strtoul(_next, &_new_next, 10) : 0; } // force base 10!
+      void _get(Span& x) {
+        _skip();
+        while (_new_next < _end && !std::isspace(static_cast<unsigned char>(*_new_next))) _new_next += 1;
+        x = Span(_next, _new_next);
+      }
+
+      char *_next, *_new_next;
+      const char* _end;
+      bool _error;
+    };
+
+
+    /// Kinds of histogram and profile data lines
+    enum BinLine { BIN, TOTAL, UNDERFLOW, OVERFLOW };
+
+    /// Classify the trimmed data line @a line by its first word
+    BinLine binLine(const Span& line) {
+      const char* p = line.b;
+      while (p != line.e && !std::isspace(static_cast<unsigned char>(*p))) p += 1;
+      const Span word(line.b, p);
+      if (word == "Total") return TOTAL;
+      if (word == "Underflow") return UNDERFLOW;
+      if (word == "Overflow") return OVERFLOW;
+      return BIN;
+    }
+
+
+    /// A read-only memory map of a whole file, which is empty if it cannot be mapped
+    struct MappedFile {
+      MappedFile(const string& filename) : data(0), size(0) {
+        #ifndef _WIN32
+        const int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        struct stat st;
+        if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+          void* addr = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+          if (addr != MAP_FAILED) {
+            madvise(addr, st.st_size, MADV_SEQUENTIAL);
+            data = static_cast<const char*>(addr);
+            size = st.st_size;
+          }
         }
+        close(fd);
+        #endif
+      }
+
+      ~MappedFile() {
+        #ifndef _WIN32
+        if (data) munmap(const_cast<char*>(data), size);
+        #endif
       }
-      void _reset_locale() {
-        if (!uselocale(_locale_prev)) {
-          throw ReadError(std::string("Error setting locale: ") + strerror(errno));
+
+      const char* data;
+      size_t size;
+    };
+
+
+    /// @brief Follower of the BEGIN..END block structure, to find where the input can be split
+    ///
+    /// Lines are classified as by parseYODA, so that the input can be split
+    /// between blocks into pieces which parse just as they would in sequence.
+    /// Anything but well-formed blocks is reported, so that the rest of the
+    /// input can be left in one piece, to fail in the same way.
+    class BlockScanner {
+    public:
+
+      BlockScanner() : _inblock(false), _inanns(false), _fmt1(true) { }
+
+      /// Follow the next line, returning false if it is not part of a well-formed block
+      bool next(Span line) {
+        if (!_inanns) {
+          line.trim();
+          if (line.empty()) return true;
+          if (line.startswith('#') && !line.contains("BEGIN") && !line.contains("END")) return true;
         }
-        freelocale(_locale_set);
+        if (_inblock) {
+          if (line.contains("BEGIN ")) return false;
+          if (line.contains("END ")) {
+            _inblock = _inanns = false;
+          } else if (!_fmt1 && _inanns && line == "---") {
+            _inanns = false;
+          }
+          return true;
+        }
+        if (!line.contains("BEGIN ")) return false;
+        while (line.startswith('#')) {
+          line.b += 1;
+          line.trim();
+        }
+        // Only known types open a block
+        Span word = _word(line);
+        if (!(word == "BEGIN")) return false;
+        word = _word(line);
+        const string ctxstr = word.str();
+        static const char* const CONTEXTS[] = {
+          "YODA_COUNTER", "YODA_SCATTER1D", "YODA_SCATTER2D", "YODA_SCATTER3D",
+          "YODA_HISTO1D", "YODA_HISTO2D", "YODA_COUNTHISTO1D", "YODA_COUNTHISTO2D",
+          "YODA_PROFILE1D", "YODA_PROFILE2D" };
+        bool known = false;
+        for (const char* ctx : CONTEXTS) known |= Utils::startswith(ctxstr, ctx);
+        if (!known) return false;
+        const size_t vpos = ctxstr.find_last_of("V");
+        _fmt1 = vpos == string::npos || ctxstr.substr(vpos+1) == "1";
+        _inblock = true;
+        _inanns = !_fmt1;
+        return true;
       }
 
-      void _get(double& x) { x = std::strtod(_next, &_new_next); }
-      void _get(float& x) { x = std::strtof(_next, &_new_next); }
-      void _get(int& i) { i = std::strtol(_next, &_new_next, 10); } // force base 10!
-      void _get(long& i) { i = std::strtol(_next, &_new_next, 10); } // force base 10!
-      void _get(unsigned int& i) { i = std::strtoul(_next, &_new_next, 10); } // force base 10!
-      void _get(long unsigned int& i) { i = std::strtoul(_next, &_new_next, 10); } // force base 10!
-      void _get(string& x) {
-        /// @todo If _next and _new_next become null?
-        while (std::isspace(*_next)) _next += 1;
-        _new_next = _next;
-        while (!std::isspace(*_new_next)) _new_next += 1;
-        x = string(_next, _new_next-_next);
+      /// Is the input between blocks, so that it can be split after the last line?
+      bool between() const { return !_inblock; }
+
+    private:
+
+      /// Take the next whitespace-separated word from the front of @a line
+      static Span _word(Span& line) {
+        line.trim();
+        const char* p = line.b;
+        while (p != line.e && !std::isspace(static_cast<unsigned char>(*p))) p += 1;
+        const Span rtn(line.b, p);
+        line.b = p;
+        return rtn;
       }
 
-      locale_t _locale_set, _locale_prev;
-      char *_next, *_new_next;
-      bool _error;
+      bool _inblock, _inanns, _fmt1;
+    };
+
+
+    /// @brief Split a block of annotations into keys and values without a YAML parser
+    ///
+    /// Handles the common case of one "key: value" per line, where the value
+    /// is a plain scalar which YAML reads as the trimmed text and emits back
+    /// unchanged. Returns false, for the block to be parsed as YAML, if any
+    /// line is otherwise: e.g. a flow list or map, a quoted, null or
+    /// multi-line value, or a comment.
+    bool splitAnnotations(const string& block, vector<pair<Span,Span>>& anns) {
+      anns.clear();
+      const char* p = block.data();
+      const char* const end = p + block.size();
+      while (p != end) {
+        const char* eol = static_cast<const char*>(memchr(p, '\n', end - p));
+        if (!eol) eol = end;
+        if (p != eol) {
+          // Keys are words, followed by a colon and a space
+          if (!std::isalnum(static_cast<unsigned char>(*p)) && *p != '_') return false;
+          const char* q = p;
+          while (q != eol && *q > ' ' && *q < 0x7f && !strchr(":#,[]{}'\"", *q)) q += 1;
+          if (q == eol || *q != ':' || (q + 1 != eol && q[1] != ' ')) return false;
+          const Span key(p, q);
+          if (key == "null" || key == "Null" || key == "NULL") return false;
+          Span val(q + 1, eol);
+          while (val.startswith(' ')) val.b += 1;
+          while (!val.empty() && val.e[-1] == ' ') val.e -= 1;
+          // Null values are emitted as a tilde
+          if (val.empty() || val == "~" || val == "null" || val == "Null" || val == "NULL") {
+            static const char* const TILDE = "~";
+            anns.emplace_back(key, Span(TILDE, TILDE + 1));
+            p = eol == end ? end : eol + 1;
+            continue;
+          }
+          // Other values must be printable ASCII, start unlike any other YAML node, and not end early
+          if (strchr(",[]{}#&*!|>'\"%@`?:", *val.b) || val.e[-1] == ':') return false;
+          if (*val.b == '-' && (val.size() == 1 || val.b[1] == ' ')) return false;
+          for (const char* c = val.b; c != val.e; ++c) {
+            if (*c < ' ' || *c >= 0x7f) return false;
+            if (*c == ' ' && (c[-1] == ':' || c[1] == '#')) return false;
+          }
+          anns.emplace_back(key, val);
+        }
+        p = eol == end ? end : eol + 1;
+      }
+      return true;
+    }
+
+
+    /// A run of whole blocks, parsed on a worker thread
+    struct ParseTask {
+      ParseTask() : b(0), e(0), nline(0), done(false) { }
+      string text; //< Copy of the lines, when reading from a stream
+      const char *b, *e; //< The lines to parse
+      unsigned int nline; //< Number of input lines before them
+      vector<AnalysisObject*> aos;
+      exception_ptr err;
+      bool done;
+    };
+
+  }
+
+
+  /// @brief Parse YODA-format objects from @a lines, passing each to @a sink at the end of its block
+  ///
+  /// Blocks whose paths fail @a filter are skipped unparsed. Line numbers in
+  /// error messages are counted from @a nline.
+  static void parseYODA(LineReader& lines, const Reader::AOSink& sink, const Reader::PathFilter& filter,
+                        unsigned int nline=0);
+
+
+  /// @brief Parse YODA-format objects from @a lines on @a nthreads worker threads
+  ///
+  /// This thread reads the input, splits it into runs of blocks and hands
+  /// the parsed objects to @a sink in input order, so that reading, and
+  /// decompression for compressed streams, overlaps with parsing. The runs
+  /// point into in-memory input, or are copied from streams if @a copy.
+  static void parseYODAParallel(LineReader& lines, bool copy, size_t nthreads,
+                                const Reader::AOSink& sink, const Reader::PathFilter& filter) {
+    const size_t TASKSIZE = 1 << 18;
+    const size_t MAXTASKS = 4*nthreads;
+
+    mutex m;
+    condition_variable cv;
+    deque<ParseTask*> todo; //< Tasks not yet started, shared with the workers
+    bool finished = false;
+    deque< unique_ptr<ParseTask> > tasks; //< Tasks not yet handed over, in input order
+
+    // Parse tasks until there are no more
+    auto work = [&]() {
+      unique_lock<mutex> lock(m);
+      for (;;) {
+        cv.wait(lock, [&]{ return finished || !todo.empty(); });
+        if (todo.empty()) return;
+        ParseTask* t = todo.front();
+        todo.pop_front();
+        lock.unlock();
+        try {
+          LineReader tlines(t->b, t->e);
+          parseYODA(tlines, [t](AnalysisObject* ao) { t->aos.push_back(ao); }, filter, t->nline);
+        } catch (...) {
+          t->err = current_exception();
+        }
+        lock.lock();
+        t->done = true;
+        cv.notify_all();
+      }
+    };
+    vector<thread> workers;
+    for (size_t i = 0; i < nthreads; ++i) workers.push_back(thread(work));
+
+    // Hand over the objects of finished tasks in order, waiting while more than @a maxtasks are pending
+    auto deliver = [&](size_t maxtasks) {
+      while (!tasks.empty()) {
+        {
+          unique_lock<mutex> lock(m);
+          if (!tasks.front()->done && tasks.size() <= maxtasks) break;
+          cv.wait(lock, [&]{ return tasks.front()->done; });
+        }
+        ParseTask& t = *tasks.front();
+        for (AnalysisObject*& ao : t.aos) {
+          AnalysisObject* tmp = ao;
+          ao = nullptr;
+          sink(tmp);
+        }
+        if (t.err) rethrow_exception(t.err);
+        tasks.pop_front();
+      }
+    };
+
+    auto submit = [&](unique_ptr<ParseTask>& t) {
+      if (copy) {
+        t->b = t->text.data();
+        t->e = t->b + t->text.size();
+      } else {
+        t->e = lines.pos();
+      }
+      {
+        lock_guard<mutex> lock(m);
+        todo.push_back(t.get());
+      }
+      cv.notify_one();
+      tasks.push_back(std::move(t));
+      deliver(MAXTASKS);
+    };
+
+    auto stop = [&]() {
+      {
+        lock_guard<mutex> lock(m);
+        todo.clear();
+        finished = true;
+      }
+      cv.notify_all();
+      for (thread& w : workers) w.join();
     };
 
+    try {
+      Span line;
+      unsigned int nline = 0;
+      unique_ptr<ParseTask> t;
+      BlockScanner scanner;
+      bool splittable = true;
+      while (lines.next(line)) {
+        if (!t) {
+          t.reset(new ParseTask);
+          t->nline = nline;
+          t->b = line.b;
+        }
+        nline += 1;
+        if (copy) {
+          t->text.append(line.b, line.size());
+          t->text += '\n';
+        }
+        // Split after a block, unless something unexpected has been seen
+        if (splittable) splittable = scanner.next(line);
+        const size_t tsize = copy ? t->text.size() : lines.pos() - t->b;
+        if (splittable && scanner.between() && tsize >= TASKSIZE) submit(t);
+      }
+      if (t) submit(t);
+      deliver(0);
+    } catch (...) {
+      stop();
+      for (const unique_ptr<ParseTask>& t : tasks) {
+        for (AnalysisObject* ao : t->aos) delete ao;
+      }
+      throw;
+    }
+    stop();
+  }
+
+
+  /// Parse YODA-format objects from @a lines, in parallel if @a nthreads is not 1
+  static void parseYODA(LineReader& lines, bool copy, size_t nthreads,
+                        const Reader::AOSink& sink, const Reader::PathFilter& filter) {
+    if (nthreads == 0) nthreads = thread::hardware_concurrency();
+    if (nthreads > 1) parseYODAParallel(lines, copy, nthreads, sink, filter);
+    else parseYODA(lines, sink, filter);
   }
 
 
   void ReaderYODA::read(istream& inputStream, vector<AnalysisObject*>& aos) {
+    readEach(inputStream, [&aos](AnalysisObject* ao) { aos.push_back(ao); });
+  }
+
 
+  void ReaderYODA::readEach(istream& inputStream, const AOSink& sink, const PathFilter& filter, size_t nthreads) {
     #ifdef HAVE_LIBZ
     // NB. zstr auto-detects if file is deflated or plain-text
     zstr::istream stream(inputStream);
     #else
     istream& stream = inputStream;
     #endif
+    LineReader lines(stream.rdbuf());
+    parseYODA(lines, true, nthreads, sink, filter);
+  }
+
+
+  void ReaderYODA::readEach(const string& filename, const AOSink& sink, const PathFilter& filter, size_t nthreads) {
+    // Parse plain-text files in place, straight from the page cache. Compressed
+    // files, and those not ending with a line ending, go through the stream.
+    if (filename != "-") {
+      MappedFile file(filename);
+      const char* end = file.data + file.size;
+      const bool gzipped = file.size >= 2 && (unsigned char)file.data[0] == 0x1f && (unsigned char)file.data[1] == 0x8b;
+      if (file.data && !gzipped && (end[-1] == '\n' || end[-1] == '\r')) {
+        LineReader lines(file.data, end);
+        parseYODA(lines, false, nthreads, sink, filter);
+        return;
+      }
+    }
+    Reader::readEach(filename, sink, filter, nthreads);
+  }
+
+
+  static void parseYODA(LineReader& lines, const Reader::AOSink& sink, const Reader::PathFilter& filter,
+                        unsigned int nline) {
+
     // Data format parsing states, representing current data type
     /// @todo Extension to e.g. "bar" or multi-counter or binned-value types, and new formats for extended Scatter types
     enum Context { NONE, //< outside any data block
                    SCATTER1D, SCATTER2D, SCATTER3D,
                    COUNTER,
                    HISTO1D, HISTO2D,
+                   COUNTHISTO1D, COUNTHISTO2D,
                    PROFILE1D, PROFILE2D };
 
     /// State of the parser: line number, line, parser context, and pointer(s) to the object currently being assembled
-    unsigned int nline = 0;
-    string s;
+    Span line;
+    string s; //< Rewritten lines, for the format-1 annotation syntax
     Context context = NONE;
     //
     AnalysisObject* aocurr = NULL; //< Generic current AO pointer
     vector<HistoBin1D> h1binscurr; //< Current H1 bins container
     vector<HistoBin2D> h2binscurr; //< Current H2 bins container
+    vector<CountBin1D> c1binscurr; //< Current counts-only H1 bins container
+    vector<CountBin2D> c2binscurr; //< Current counts-only H2 bins container
     vector<ProfileBin1D> p1binscurr; //< Current P1 bins container
     vector<ProfileBin2D> p2binscurr; //< Current P2 bins container
     vector<Point1D> pt1scurr; //< Current Point1Ds container
@@ -156,6 +832,8 @@ namespace YODA {
     Counter* cncurr = NULL;
     Histo1D* h1curr = NULL;
     Histo2D* h2curr = NULL;
+    CountHisto1D* c1curr = NULL;
+    CountHisto2D* c2curr = NULL;
     Profile1D* p1curr = NULL;
     Profile2D* p2curr = NULL;
     Scatter1D* s1curr = NULL;
@@ -163,26 +841,28 @@ namespace YODA {
     Scatter3D* s3curr = NULL;
     //std::vector<std::string> variationscurr;
     string annscurr;
+    vector<pair<Span,Span>> annspans; //< Keys and values of simple annotations
 
     // Loop over all lines of the input file
     aistringstream aiss;
     bool in_anns = false;
+    bool skipping = false; //< In a block not selected by the filter
     string fmt = "1";
     //int nfmt = 1;
-    while (Utils::getline(stream, s)) {
+    while (lines.next(line)) {
       nline += 1;
 
 
       // CLEAN LINES IF NOT IN ANNOTATION MODE
       if (!in_anns) {
         // Trim the line
-        Utils::itrim(s);
+        line.trim();
 
         // Ignore blank lines
-        if (s.empty()) continue;
+        if (line.empty()) continue;
 
         // Ignore comments (whole-line only, without indent, and still allowed for compatibility on BEGIN/END lines)
-        if (s.find("#") == 0 && s.find("BEGIN") == string::npos && s.find("END") == string::npos) continue;
+        if (line.startswith('#') && !line.contains("BEGIN") && !line.contains("END")) continue;
       }
 
 
@@ -190,24 +870,32 @@ namespace YODA {
       if (context == NONE) {
 
         // We require a BEGIN line to start a context
-        if (s.find("BEGIN ") == string::npos) {
+        if (!line.contains("BEGIN ")) {
           stringstream ss;
-          ss << "Unexpected line in YODA format parsing when BEGIN expected: '" << s << "' on line " << nline;
+          ss << "Unexpected line in YODA format parsing when BEGIN expected: '" << line.str() << "' on line " << nline;
           throw ReadError(ss.str());
         }
 
         // Remove leading #s from the BEGIN line if necessary
-        while (s.find("#") == 0) s = Utils::trim(s.substr(1));
+        while (line.startswith('#')) {
+          line.b += 1;
+          line.trim();
+        }
 
         // Split into parts
         vector<string> parts;
-        istringstream iss(s); string tmp;
-        while (iss >> tmp) parts.push_back(tmp);
+        for (const char* p = line.b; p != line.e; ) {
+          while (p != line.e && std::isspace(static_cast<unsigned char>(*p))) p += 1;
+          const char* q = p;
+          while (q != line.e && !std::isspace(static_cast<unsigned char>(*q))) q += 1;
+          if (q != p) parts.push_back(string(p, q));
+          p = q;
+        }
 
         // Extract context from BEGIN type
         if (parts.size() < 2 || parts[0] != "BEGIN") {
           stringstream ss;
-          ss << "Unexpected BEGIN line structure when BEGIN expected: '" << s << "' on line " << nline;
+          ss << "Unexpected BEGIN line structure when BEGIN expected: '" << line.str() << "' on line " << nline;
           throw ReadError(ss.str());
         }
 
@@ -217,40 +905,35 @@ namespace YODA {
         // Get block path if possible
         const string path = (parts.size() >= 3) ? parts[2] : "";
 
-        // Set the new context and create a new AO to populate
+        // Set the new context
         /// @todo Use the block format version for (occasional, careful) format evolution
-        if (Utils::startswith(ctxstr, "YODA_COUNTER")) {
-          context = COUNTER;
-          cncurr = new Counter(path);
-          aocurr = cncurr;
-        } else if (Utils::startswith(ctxstr, "YODA_SCATTER1D")) {
-          context = SCATTER1D;
-          s1curr = new Scatter1D(path);
-          aocurr = s1curr;
-        } else if (Utils::startswith(ctxstr, "YODA_SCATTER2D")) {
-          context = SCATTER2D;
-          s2curr = new Scatter2D(path);
-          aocurr = s2curr;
-        } else if (Utils::startswith(ctxstr, "YODA_SCATTER3D")) {
-          context = SCATTER3D;
-          s3curr = new Scatter3D(path);
-          aocurr = s3curr;
-        } else if (Utils::startswith(ctxstr, "YODA_HISTO1D")) {
-          context = HISTO1D;
-          h1curr = new Histo1D(path);
-          aocurr = h1curr;
-        } else if (Utils::startswith(ctxstr, "YODA_HISTO2D")) {
-          context = HISTO2D;
-          h2curr = new Histo2D(path);
-          aocurr = h2curr;
-        } else if (Utils::startswith(ctxstr, "YODA_PROFILE1D")) {
-          context = PROFILE1D;
-          p1curr = new Profile1D(path);
-          aocurr = p1curr;
-        } else if (Utils::startswith(ctxstr, "YODA_PROFILE2D")) {
-          context = PROFILE2D;
-          p2curr = new Profile2D(path);
-          aocurr = p2curr;
+        if (Utils::startswith(ctxstr, "YODA_COUNTER")) context = COUNTER;
+        else if (Utils::startswith(ctxstr, "YODA_SCATTER1D")) context = SCATTER1D;
+        else if (Utils::startswith(ctxstr, "YODA_SCATTER2D")) context = SCATTER2D;
+        else if (Utils::startswith(ctxstr, "YODA_SCATTER3D")) context = SCATTER3D;
+        else if (Utils::startswith(ctxstr, "YODA_HISTO1D")) context = HISTO1D;
+        else if (Utils::startswith(ctxstr, "YODA_HISTO2D")) context = HISTO2D;
+        else if (Utils::startswith(ctxstr, "YODA_COUNTHISTO1D")) context = COUNTHISTO1D;
+        else if (Utils::startswith(ctxstr, "YODA_COUNTHISTO2D")) context = COUNTHISTO2D;
+        else if (Utils::startswith(ctxstr, "YODA_PROFILE1D")) context = PROFILE1D;
+        else if (Utils::startswith(ctxstr, "YODA_PROFILE2D")) context = PROFILE2D;
+
+        // Skip unwanted blocks, otherwise create a new AO to populate
+        skipping = context != NONE && filter && !filter(path);
+        if (!skipping) {
+          switch (context) {
+          case COUNTER: aocurr = cncurr = new Counter(path); break;
+          case SCATTER1D: aocurr = s1curr = new Scatter1D(path); break;
+          case SCATTER2D: aocurr = s2curr = new Scatter2D(path); break;
+          case SCATTER3D: aocurr = s3curr = new Scatter3D(path); break;
+          case HISTO1D: aocurr = h1curr = new Histo1D(path); break;
+          case HISTO2D: aocurr = h2curr = new Histo2D(path); break;
+          case COUNTHISTO1D: aocurr = c1curr = new CountHisto1D(path); break;
+          case COUNTHISTO2D: aocurr = c2curr = new CountHisto2D(path); break;
+          case PROFILE1D: aocurr = p1curr = new Profile1D(path); break;
+          case PROFILE2D: aocurr = p2curr = new Profile2D(path); break;
+          case NONE: break;
+          }
         }
         // cout << aocurr->path() << " " << nline << " " << context << endl;
 
@@ -267,14 +950,28 @@ namespace YODA {
 
 
         // Throw error if a BEGIN line is found
-        if (s.find("BEGIN ") != string::npos) ///< @todo require pos = 0 from fmt=V2
+        if (line.contains("BEGIN ")) ///< @todo require pos = 0 from fmt=V2
           throw ReadError("Unexpected BEGIN line in YODA format parsing before ending current BEGIN..END block");
 
 
+        // SKIPPING AN UNSELECTED BLOCK
+        // Only look for the end of the annotations, whose lines are not trimmed, and of the block
+        if (skipping) {
+          if (line.contains("END ")) {
+            skipping = false;
+            in_anns = false;
+            context = NONE;
+          } else if (in_anns && line == "---") {
+            in_anns = false;
+          }
+          continue;
+        }
+
+
         // FINISHING THE CURRENT CONTEXT
         // Clear/reset context and register AO
         /// @todo Throw error if mismatch between BEGIN (context) and END types
-        if (s.find("END ") != string::npos) { ///< @todo require pos = 0 from fmt=V2
+        if (line.contains("END ")) { ///< @todo require pos = 0 from fmt=V2
           switch (context) {
           case COUNTER:
             break;
@@ -286,6 +983,14 @@ namespace YODA {
             h2curr->addBins(h2binscurr);
             h2binscurr.clear();
             break;
+          case COUNTHISTO1D:
+            c1curr->addBins(c1binscurr);
+            c1binscurr.clear();
+            break;
+          case COUNTHISTO2D:
+            c2curr->addBins(c2binscurr);
+            c2binscurr.clear();
+            break;
           case PROFILE1D:
             p1curr->addBins(p1binscurr);
             p1binscurr.clear();
@@ -313,36 +1018,41 @@ namespace YODA {
             break;
           }
 
-          // Set all annotations
-          try {
-            YAML::Node anns = YAML::Load(annscurr);
-            // for (YAML::const_iterator it = anns.begin(); it != anns.end(); ++it) {
-            for (const auto& it : anns) {
-              const string key = it.first.as<string>();
-              // const string val = it.second.as<string>();
-              YAML::Emitter em;
-              em << YAML::Flow << it.second; //< use single-line formatting, for lists & maps
-              const string val = em.c_str();
-             // if (!(key.find("ErrorBreakdown") != string::npos))
-              aocurr->setAnnotation(key, val);
+          // Set all annotations, directly if they are simple enough
+          if (splitAnnotations(annscurr, annspans)) {
+            for (const auto& kv : annspans) aocurr->setAnnotation(kv.first.str(), kv.second.str());
+          } else {
+            try {
+              YAML::Node anns = YAML::Load(annscurr);
+              // for (YAML::const_iterator it = anns.begin(); it != anns.end(); ++it) {
+              for (const auto& it : anns) {
+                const string key = it.first.as<string>();
+                // const string val = it.second.as<string>();
+                YAML::Emitter em;
+                em << YAML::Flow << it.second; //< use single-line formatting, for lists & maps
+                const string val = em.c_str();
+               // if (!(key.find("ErrorBreakdown") != string::npos))
+                aocurr->setAnnotation(key, val);
+              }
+            } catch (...) {
+              /// @todo Is there a case for just giving up on these annotations, printing the error msg, and keep going? As an option?
+              const string err = "Problem during annotation parsing of YAML block:\n'''\n" + annscurr + "\n'''";
+              // cerr << err << endl;
+              throw ReadError(err);
             }
-          } catch (...) {
-            /// @todo Is there a case for just giving up on these annotations, printing the error msg, and keep going? As an option?
-            const string err = "Problem during annotation parsing of YAML block:\n'''\n" + annscurr + "\n'''";
-            // cerr << err << endl;
-            throw ReadError(err);
           }
           annscurr.clear();
           //variationscurr.clear();
           in_anns = false;
 
-          // Put this AO in the completed stack
-          aos.push_back(aocurr);
+          // Hand over the completed AO
+          sink(aocurr);
 
           // Clear all current-object pointers
           aocurr = nullptr;
           cncurr = nullptr;
           h1curr = nullptr; h2curr = nullptr;
+          c1curr = nullptr; c2curr = nullptr;
           p1curr = nullptr; p2curr = nullptr;
           s1curr = nullptr; s2curr = nullptr; s3curr = nullptr;
           context = NONE;
@@ -352,26 +1062,27 @@ namespace YODA {
 
         // ANNOTATIONS PARSING
         if (fmt == "1") {
-          // First convert to one-key-per-line YAML syntax
-          const size_t ieq = s.find("=");
-          if (ieq != string::npos) s.replace(ieq, 1, ": ");
-          // Special-case treatment for syntax clashes
-          const size_t icost = s.find(": *");
-          if (icost != string::npos) {
-            s.replace(icost, 1, ": '*");
-            s += "'";
-          }
-          // Store reformatted annotation
-          const size_t ico = s.find(":");
-          if (ico != string::npos) {
+          // Lines with a key, after conversion to one-key-per-line YAML syntax, are annotations
+          if (line.contains("=") || line.contains(":")) {
+            s = line.str();
+            const size_t ieq = s.find("=");
+            if (ieq != string::npos) s.replace(ieq, 1, ": ");
+            // Special-case treatment for syntax clashes
+            const size_t icost = s.find(": *");
+            if (icost != string::npos) {
+              s.replace(icost, 1, ": '*");
+              s += "'";
+            }
+            // Store reformatted annotation
             annscurr += (annscurr.empty() ? "" : "\n") + s;
             continue;
           }
         } else if (in_anns) {
-          if (s == "---") {
+          if (line == "---") {
             in_anns = false;
           } else {
-            annscurr += (annscurr.empty() ? "" : "\n") + s;
+            if (!annscurr.empty()) annscurr += "\n";
+            annscurr.append(line.b, line.size());
             // In order to handle multi-error points in scatters, we need to know which variations are stored, if any
             // can't wait until we process the annotations at the end, since need to know when filling points.
             // This is a little inelegant though...
@@ -390,7 +1101,7 @@ namespace YODA {
 
 
         // DATA PARSING
-        aiss.reset(s);
+        aiss.reset(line.b, line.e);
         // double sumw(0), sumw2(0), sumwx(0), sumwx2(0), sumwy(0), sumwy2(0), sumwz(0), sumwz2(0), sumwxy(0), sumwxz(0), sumwyz(0), n(0);
         switch (context) {
 
@@ -404,11 +1115,12 @@ namespace YODA {
 
         case HISTO1D:
           {
-            string xoflow1, xoflow2; double xmin(0), xmax(0);
+            Span xoflow1, xoflow2; double xmin(0), xmax(0);
             double sumw(0), sumw2(0), sumwx(0), sumwx2(0), n(0);
+            const BinLine kind = binLine(line);
             /// @todo Improve/factor this "bin" string-or-float parsing... esp for mixed case of 2D overflows
             /// @todo When outflows are treated as "infinity bins" and don't require a distinct type, string replace under/over -> -+inf
-            if (s.find("Total") != string::npos || s.find("Underflow") != string::npos || s.find("Overflow") != string::npos) {
+            if (kind != BIN) {
               aiss >> xoflow1 >> xoflow2;
             } else {
               aiss >> xmin >> xmax;
@@ -416,9 +1128,9 @@ namespace YODA {
             // The rest is the same for overflows and in-range bins
             aiss >> sumw >> sumw2 >> sumwx >> sumwx2 >> n;
             const Dbn1D dbn(n, sumw, sumw2, sumwx, sumwx2);
-            if (xoflow1 == "Total") h1curr->setTotalDbn(dbn);
-            else if (xoflow1 == "Underflow") h1curr->setUnderflow(dbn);
-            else if (xoflow1 == "Overflow")  h1curr->setOverflow(dbn);
+            if (kind == TOTAL) h1curr->setTotalDbn(dbn);
+            else if (kind == UNDERFLOW) h1curr->setUnderflow(dbn);
+            else if (kind == OVERFLOW)  h1curr->setOverflow(dbn);
             // else h1curr->addBin(HistoBin1D(std::make_pair(xmin,xmax), dbn));
             else h1binscurr.push_back(HistoBin1D(std::make_pair(xmin,xmax), dbn));
           }
@@ -426,13 +1138,14 @@ namespace YODA {
 
         case HISTO2D:
           {
-            string xoflow1, xoflow2, yoflow1, yoflow2; double xmin(0), xmax(0), ymin(0), ymax(0);
+            Span xoflow1, xoflow2, yoflow1, yoflow2; double xmin(0), xmax(0), ymin(0), ymax(0);
             double sumw(0), sumw2(0), sumwx(0), sumwx2(0), sumwy(0), sumwy2(0), sumwxy(0), n(0);
+            const BinLine kind = binLine(line);
             /// @todo Improve/factor this "bin" string-or-float parsing... esp for mixed case of 2D overflows
             /// @todo When outflows are treated as "infinity bins" and don't require a distinct type, string replace under/over -> -+inf
-            if (s.find("Total") != string::npos) {
+            if (kind == TOTAL) {
               aiss >> xoflow1 >> xoflow2; // >> yoflow1 >> yoflow2;
-            } else if (s.find("Underflow") != string::npos || s.find("Overflow") != string::npos) {
+            } else if (kind != BIN) {
               throw ReadError("2D histogram overflow syntax is not yet defined / handled");
             } else {
               aiss >> xmin >> xmax >> ymin >> ymax;
@@ -440,24 +1153,63 @@ namespace YODA {
             // The rest is the same for overflows and in-range bins
             aiss >> sumw >> sumw2 >> sumwx >> sumwx2 >> sumwy >> sumwy2 >> sumwxy >> n;
             const Dbn2D dbn(n, sumw, sumw2, sumwx, sumwx2, sumwy, sumwy2, sumwxy);
-            if (xoflow1 == "Total") h2curr->setTotalDbn(dbn);
-            // else if (xoflow1 == "Underflow") p1curr->setUnderflow(dbn);
-            // else if (xoflow1 == "Overflow")  p1curr->setOverflow(dbn);
+            if (kind == TOTAL) h2curr->setTotalDbn(dbn);
+            // else if (kind == UNDERFLOW) p1curr->setUnderflow(dbn);
+            // else if (kind == OVERFLOW)  p1curr->setOverflow(dbn);
             else {
-              assert(xoflow1.empty());
+              assert(kind == BIN);
               // h2curr->addBin(HistoBin2D(std::make_pair(xmin,xmax), std::make_pair(ymin,ymax), dbn));
               h2binscurr.push_back(HistoBin2D(std::make_pair(xmin,xmax), std::make_pair(ymin,ymax), dbn));
             }
           }
           break;
 
+        case COUNTHISTO1D:
+          {
+            Span xoflow1, xoflow2; double xmin(0), xmax(0);
+            double sumw(0), sumw2(0), n(0);
+            const BinLine kind = binLine(line);
+            if (kind != BIN) {
+              aiss >> xoflow1 >> xoflow2;
+            } else {
+              aiss >> xmin >> xmax;
+            }
+            // The rest is the same for overflows and in-range bins
+            aiss >> sumw >> sumw2 >> n;
+            const Dbn0D dbn(n, sumw, sumw2);
+            if (kind == TOTAL) c1curr->setTotalDbn(dbn);
+            else if (kind == UNDERFLOW) c1curr->setUnderflow(dbn);
+            else if (kind == OVERFLOW)  c1curr->setOverflow(dbn);
+            else c1binscurr.push_back(CountBin1D(std::make_pair(xmin,xmax), dbn));
+          }
+          break;
+
+        case COUNTHISTO2D:
+          {
+            Span xoflow1, xoflow2; double xmin(0), xmax(0), ymin(0), ymax(0);
+            double sumw(0), sumw2(0), n(0);
+            const BinLine kind = binLine(line);
+            if (kind == TOTAL) {
+              aiss >> xoflow1 >> xoflow2;
+            } else {
+              aiss >> xmin >> xmax >> ymin >> ymax;
+            }
+            // The rest is the same for the total and in-range bins
+            aiss >> sumw >> sumw2 >> n;
+            const Dbn0D dbn(n, sumw, sumw2);
+            if (kind == TOTAL) c2curr->setTotalDbn(dbn);
+            else c2binscurr.push_back(CountBin2D(std::make_pair(xmin,xmax), std::make_pair(ymin,ymax), dbn));
+          }
+          break;
+
         case PROFILE1D:
           {
-            string xoflow1, xoflow2; double xmin(0), xmax(0);
+            Span xoflow1, xoflow2; double xmin(0), xmax(0);
             double sumw(0), sumw2(0), sumwx(0), sumwx2(0), sumwy(0), sumwy2(0), n(0);
+            const BinLine kind = binLine(line);
             /// @todo Improve/factor this "bin" string-or-float parsing... esp for mixed case of 2D overflows
             /// @todo When outflows are treated as "infinity bins" and don't require a distinct type, string replace under/over -> -+inf
-            if (s.find("Total") != string::npos || s.find("Underflow") != string::npos || s.find("Overflow") != string::npos) {
+            if (kind != BIN) {
               aiss >> xoflow1 >> xoflow2;
             } else {
               aiss >> xmin >> xmax;
@@ -466,9 +1218,9 @@ namespace YODA {
             aiss >> sumw >> sumw2 >> sumwx >> sumwx2 >> sumwy >> sumwy2 >> n;
             const double DUMMYWXY = 0;
             const Dbn2D dbn(n, sumw, sumw2, sumwx, sumwx2, sumwy, sumwy2, DUMMYWXY);
-            if (xoflow1 == "Total") p1curr->setTotalDbn(dbn);
-            else if (xoflow1 == "Underflow") p1curr->setUnderflow(dbn);
-            else if (xoflow1 == "Overflow")  p1curr->setOverflow(dbn);
+            if (kind == TOTAL) p1curr->setTotalDbn(dbn);
+            else if (kind == UNDERFLOW) p1curr->setUnderflow(dbn);
+            else if (kind == OVERFLOW)  p1curr->setOverflow(dbn);
             // else p1curr->addBin(ProfileBin1D(std::make_pair(xmin,xmax), dbn));
             else p1binscurr.push_back(ProfileBin1D(std::make_pair(xmin,xmax), dbn));
           }
@@ -476,13 +1228,14 @@ namespace YODA {
 
         case PROFILE2D:
           {
-            string xoflow1, xoflow2, yoflow1, yoflow2; double xmin(0), xmax(0), ymin(0), ymax(0);
+            Span xoflow1, xoflow2, yoflow1, yoflow2; double xmin(0), xmax(0), ymin(0), ymax(0);
             double sumw(0), sumw2(0), sumwx(0), sumwx2(0), sumwy(0), sumwy2(0), sumwz(0), sumwz2(0), sumwxy(0), sumwxz(0), sumwyz(0), n(0);
+            const BinLine kind = binLine(line);
             /// @todo Improve/factor this "bin" string-or-float parsing... esp for mixed case of 2D overflows
             /// @todo When outflows are treated as "infinity bins" and don't require a distinct type, string replace under/over -> -+inf
-            if (s.find("Total") != string::npos) {
+            if (kind == TOTAL) {
               aiss >> xoflow1 >> xoflow2; // >> yoflow1 >> yoflow2;
-            } else if (s.find("Underflow") != string::npos || s.find("Overflow") != string::npos) {
+            } else if (kind != BIN) {
               throw ReadError("2D profile overflow syntax is not yet defined / handled");
             } else {
               aiss >> xmin >> xmax >> ymin >> ymax;
@@ -490,11 +1243,11 @@ namespace YODA {
             // The rest is the same for overflows and in-range bins
             aiss >> sumw >> sumw2 >> sumwx >> sumwx2 >> sumwy >> sumwy2 >> sumwz >> sumwz2 >> sumwxy >> sumwxz >> sumwyz >> n;
             const Dbn3D dbn(n, sumw, sumw2, sumwx, sumwx2, sumwy, sumwy2, sumwz, sumwz2, sumwxy, sumwxz, sumwyz);
-            if (xoflow1 == "Total") p2curr->setTotalDbn(dbn);
-            // else if (xoflow1 == "Underflow") p2curr->setUnderflow(dbn);
-            // else if (xoflow1 == "Overflow")  p2curr->setOverflow(dbn);
+            if (kind == TOTAL) p2curr->setTotalDbn(dbn);
+            // else if (kind == UNDERFLOW) p2curr->setUnderflow(dbn);
+            // else if (kind == OVERFLOW)  p2curr->setOverflow(dbn);
             else {
-              assert(xoflow1.empty());
+              assert(kind == BIN);
               // p2curr->addBin(ProfileBin2D(std::make_pair(xmin,xmax), std::make_pair(ymin,ymax), dbn));
               p2binscurr.push_back(ProfileBin2D(std::make_pair(xmin,xmax), std::make_pair(ymin,ymax), dbn));
             }
@@ -557,163 +1310,252 @@ namespace YODA {
   }
 
 
-  Index ReaderYODA::mkIndex(std::istream& inputStream) {
-    Index::AOIndex hmap;
-    hmap.insert({"Histo1D", unordered_map<string, int>()});
-    hmap.insert({"Histo2D", unordered_map<string, int>()});
-    hmap.insert({"Profile1D", unordered_map<string, int>()});
-    hmap.insert({"Profile2D", unordered_map<string, int>()});
-    hmap.insert({"Scatter1D", unordered_map<string, int>()});
-    hmap.insert({"Scatter2D", unordered_map<string, int>()});
-    hmap.insert({"Scatter3D", unordered_map<string, int>()});
-    hmap.insert({"Counter", unordered_map<string, int>()});
-
-    //#ifdef HAVE_LIBZ
-    //// NB. zstr auto-detects if file is deflated or plain-text
-    // zstr::istream stream(inputStream);
-    //#else
-    istream& stream = inputStream;
-    //#endif
-    enum Context {
-      NONE,
-      SCATTER1D,
-      SCATTER2D,
-      SCATTER3D,
-      COUNTER,
-      HISTO1D,
-      HISTO2D,
-      PROFILE1D,
-      PROFILE2D
-    };
+  namespace {
 
-    /// State of the parser: line number, line, parser context, and pointer(s)
-    /// to the object currently being assembled
+    /// Names of the indexed object types, by BEGIN-line context prefix
+    const vector< pair<string, string> > INDEXTYPES = {
+      {"YODA_COUNTER", "Counter"},
+      {"YODA_SCATTER1D", "Scatter1D"}, {"YODA_SCATTER2D", "Scatter2D"}, {"YODA_SCATTER3D", "Scatter3D"},
+      {"YODA_HISTO1D", "Histo1D"}, {"YODA_HISTO2D", "Histo2D"},
+      {"YODA_COUNTHISTO1D", "CountHisto1D"}, {"YODA_COUNTHISTO2D", "CountHisto2D"},
+      {"YODA_PROFILE1D", "Profile1D"}, {"YODA_PROFILE2D", "Profile2D"} };
+
+
+    /// Index map with an empty entry for each type
+    Index::AOIndex emptyAOIndex() {
+      Index::AOIndex hmap;
+      for (const auto& ctx_type : INDEXTYPES) hmap.insert({ctx_type.second, unordered_map<string, int>()});
+      return hmap;
+    }
+
+
+    /// @brief Size and modification time of file @a filename, or an empty string if unknown
+    ///
+    /// A sidecar index is only used if this matches the stamp it was made with.
+    string fileStamp(const string& filename) {
+      #ifndef _WIN32
+      struct stat st;
+      if (stat(filename.c_str(), &st) != 0) return "";
+      ostringstream os;
+      os << st.st_size << " " << st.st_mtim.tv_sec << "." << st.st_mtim.tv_nsec;
+      return os.str();
+      #else
+      return "";
+      #endif
+    }
+
+
+    const string INDEXHEADER = "YODA_INDEX_V1";
+
+  }
+
+
+  /// @brief Index the objects in @a lines, with their positions if @a base is the start of in-memory input
+  ///
+  /// Blocks are followed, and bins and points counted, as by parseYODA.
+  static Index indexYODA(LineReader& lines, const char* base) {
+    Index::AOIndex hmap = emptyAOIndex();
+    Index::ExtentIndex extents;
+
+    /// State of the parser: line number, block type, path, position and bin count
     unsigned int nline = 0;
-    string s;
-    Context context = NONE;
-    std::string curpath = "";
+    Span line;
+    const string* curtype = nullptr;
+    bool counted = false, binned = false;
+    string curpath;
+    size_t offset = 0;
     int nbins = 0;
 
     // Loop over all lines of the input file
     bool in_anns = false;
     string fmt = "1";
-    while (std::getline(stream, s)) {
+    const char* next = lines.pos();
+    while (lines.next(line)) {
+      const char* start = next;
+      next = lines.pos();
       nline += 1;
       if (!in_anns) {
-        Utils::itrim(s);
-        if (s.empty())
-          continue;
-        if (s.find("#") == 0 && s.find("BEGIN") == string::npos &&
-            s.find("END") == string::npos)
-          continue;
+        line.trim();
+        if (line.empty()) continue;
+        if (line.startswith('#') && !line.contains("BEGIN") && !line.contains("END")) continue;
       }
-      if (context == NONE) {
-        if (s.find("BEGIN ") == string::npos) {
+      if (!curtype) {
+        if (!line.contains("BEGIN ")) {
           stringstream ss;
-          ss << "Unexpected line in YODA format parsing when BEGIN expected: '"
-             << s << "' on line " << nline;
+          ss << "Unexpected line in YODA format parsing when BEGIN expected: '" << line.str() << "' on line " << nline;
           throw ReadError(ss.str());
         }
-        while (s.find("#") == 0)
-          s = Utils::trim(s.substr(1));
+        offset = base ? start - base : 0;
+        while (line.startswith('#')) {
+          line.b += 1;
+          line.trim();
+        }
         vector<string> parts;
-        istringstream iss(s);
+        istringstream iss(line.str());
         string tmp;
-        while (iss >> tmp)
-          parts.push_back(tmp);
-
+        while (iss >> tmp) parts.push_back(tmp);
         if (parts.size() < 2 || parts[0] != "BEGIN") {
           stringstream ss;
-          ss << "Unexpected BEGIN line structure when BEGIN expected: '" << s
-             << "' on line " << nline;
+          ss << "Unexpected BEGIN line structure when BEGIN expected: '" << line.str() << "' on line " << nline;
           throw ReadError(ss.str());
         }
-        const string ctxstr = parts[1];
+        const string& ctxstr = parts[1];
         curpath = (parts.size() >= 3) ? parts[2] : "";
         nbins = 0;
-        if (Utils::startswith(ctxstr, "YODA_COUNTER")) {
-          context = COUNTER;
-        } else if (Utils::startswith(ctxstr, "YODA_SCATTER1D")) {
-          context = SCATTER1D;
-        } else if (Utils::startswith(ctxstr, "YODA_SCATTER2D")) {
-          context = SCATTER2D;
-        } else if (Utils::startswith(ctxstr, "YODA_SCATTER3D")) {
-          context = SCATTER3D;
-        } else if (Utils::startswith(ctxstr, "YODA_HISTO1D")) {
-          context = HISTO1D;
-        } else if (Utils::startswith(ctxstr, "YODA_HISTO2D")) {
-          context = HISTO2D;
-        } else if (Utils::startswith(ctxstr, "YODA_PROFILE1D")) {
-          context = PROFILE1D;
-        } else if (Utils::startswith(ctxstr, "YODA_PROFILE2D")) {
-          context = PROFILE2D;
+        for (const auto& ctx_type : INDEXTYPES) {
+          if (Utils::startswith(ctxstr, ctx_type.first)) {
+            curtype = &ctx_type.second;
+            break;
+          }
         }
+        // Counters have no bins, and histograms and profiles also have total and overflow lines
+        counted = curtype && *curtype != "Counter";
+        binned = counted && curtype->find("Scatter") == string::npos;
         const size_t vpos = ctxstr.find_last_of("V");
         fmt = vpos != string::npos ? ctxstr.substr(vpos + 1) : "1";
-        if (fmt != "1")
-          in_anns = true;
+        if (fmt != "1") in_anns = true;
       } else { //< not a BEGIN line
-        if (s.find("BEGIN ") != string::npos)
-          throw ReadError("Unexpected BEGIN line in YODA format parsing before "
-                          "ending current BEGIN..END block");
+        if (line.contains("BEGIN "))
+          throw ReadError("Unexpected BEGIN line in YODA format parsing before ending current BEGIN..END block");
         // FINISHING THE CURRENT CONTEXT
-        if (s.find("END ") != string::npos) {
-          if (context == HISTO1D) {
-            hmap["Histo1D"].insert({curpath, nbins});
-          } else if (context == HISTO2D) {
-            hmap["Histo2D"].insert({curpath, nbins});
-          } else if (context == PROFILE1D) {
-            hmap["Profile1D"].insert({curpath, nbins});
-          } else if (context == PROFILE2D) {
-            hmap["Profile2D"].insert({curpath, nbins});
-          } else if (context == SCATTER1D) {
-            hmap["Scatter1D"].insert({curpath, nbins});
-          } else if (context == SCATTER2D) {
-            hmap["Scatter2D"].insert({curpath, nbins});
-          } else if (context == SCATTER3D) {
-            hmap["Scatter3D"].insert({curpath, nbins});
-          } else if (context == COUNTER) {
-            hmap["Counter"].insert({curpath, nbins});
-          }
+        if (line.contains("END ")) {
+          hmap[*curtype].insert({curpath, nbins});
+          if (base) extents.insert({curpath, Index::Extent{offset, static_cast<size_t>(lines.pos() - base) - offset}});
           in_anns = false;
-          context = NONE;
+          curtype = nullptr;
           continue;
         }
-        // ANNOTATIONS PARSING
+        // Skip annotations, i.e. lines with a key in the format-1 syntax, or up to --- from format 2
         if (fmt == "1") {
-          // First convert to one-key-per-line YAML syntax
-          const size_t ieq = s.find("=");
-          if (ieq != string::npos)
-            s.replace(ieq, 1, ": ");
-          // Special-case treatment for syntax clashes
-          const size_t icost = s.find(": *");
-          if (icost != string::npos) {
-            s.replace(icost, 1, ": '*");
-            s += "'";
-          }
-          // Store reformatted annotation
-          const size_t ico = s.find(":");
-          if (ico != string::npos)
-            continue;
+          if (line.contains("=") || line.contains(":")) continue;
         } else if (in_anns) {
-          if (s == "---")
-            in_anns = false;
+          if (line == "---") in_anns = false;
           continue;
         }
+        if (binned && binLine(line) != BIN) continue;
+        if (counted) nbins++;
+      }
+    }
+    return Index(hmap, extents);
+  }
 
-        if ((context == HISTO1D) || (context == HISTO2D) ||
-            (context == PROFILE1D) || (context == PROFILE2D)) {
-          if (s.find("Total") != string::npos ||
-              s.find("Underflow") != string::npos ||
-              s.find("Overflow") != string::npos)
-            continue;
-          nbins++;
-        } else if ((context == SCATTER1D) || (context == SCATTER2D) ||
-                   (context == SCATTER3D)) {
-          nbins++;
+
+  Index ReaderYODA::mkIndex(std::istream& inputStream) {
+    #ifdef HAVE_LIBZ
+    // NB. zstr auto-detects if file is deflated or plain-text
+    zstr::istream stream(inputStream);
+    #else
+    istream& stream = inputStream;
+    #endif
+    LineReader lines(stream.rdbuf());
+    return indexYODA(lines, nullptr);
+  }
+
+
+  Index ReaderYODA::mkIndex(const string& filename) {
+    // Use an up-to-date sidecar index if there is one
+    if (filename != "-") {
+      const string stamp = fileStamp(filename);
+      ifstream idxfile(indexFilename(filename).c_str());
+      string header;
+      if (!stamp.empty() && idxfile && getline(idxfile, header) && header == INDEXHEADER + " " + stamp) {
+        Index::AOIndex hmap = emptyAOIndex();
+        Index::ExtentIndex extents;
+        Index::Extent extent;
+        int nbins;
+        string type, path;
+        while (idxfile >> extent.offset >> extent.length >> nbins >> type >> path) {
+          hmap[type].insert({path, nbins});
+          extents.insert({path, extent});
         }
+        if (idxfile.eof()) return Index(hmap, extents);
+      }
+    }
+    // Otherwise index plain-text files in place, with the object positions
+    if (filename != "-") {
+      MappedFile file(filename);
+      const char* end = file.data + file.size;
+      const bool gzipped = file.size >= 2 && (unsigned char)file.data[0] == 0x1f && (unsigned char)file.data[1] == 0x8b;
+      if (file.data && !gzipped && (end[-1] == '\n' || end[-1] == '\r')) {
+        LineReader lines(file.data, end);
+        return indexYODA(lines, file.data);
       }
     }
-    return Index(hmap);
+    return Reader::mkIndex(filename);
+  }
+
+
+  void ReaderYODA::writeIndexFile(const string& filename) {
+    const string stamp = fileStamp(filename);
+    MappedFile file(filename);
+    const char* end = file.data + file.size;
+    if (stamp.empty() || !file.data || (end[-1] != '\n' && end[-1] != '\r'))
+      throw WriteError("Cannot index " + filename + ": only uncompressed files ending with a line ending can be indexed");
+    LineReader lines(file.data, end);
+    writeIndexFile(filename, indexYODA(lines, file.data));
   }
+
+
+  void ReaderYODA::writeIndexFile(const string& filename, const Index& idx) {
+    const string stamp = fileStamp(filename);
+    if (stamp.empty() || !idx.hasExtents())
+      throw WriteError("Cannot index " + filename + " without the positions of its objects");
+
+    // Write to a temporary file and move it into place, so that readers never see a partial index
+    const string idxname = indexFilename(filename), tmpname = idxname + ".tmp";
+    {
+      ofstream out(tmpname.c_str());
+      out << INDEXHEADER << " " << stamp << "\n";
+      for (const auto& type_paths : idx.getAOIndex()) {
+        for (const auto& path_nbins : type_paths.second) {
+          const Index::Extent& extent = idx.getExtents().at(path_nbins.first);
+          out << extent.offset << " " << extent.length << " " << path_nbins.second << " "
+              << type_paths.first << " " << path_nbins.first << "\n";
+        }
+      }
+      if (!out) throw WriteError("Writing index file " + tmpname + " failed");
+    }
+    if (std::rename(tmpname.c_str(), idxname.c_str()) != 0)
+      throw WriteError("Writing index file " + idxname + " failed");
+  }
+
+
+  void ReaderYODA::removeIndexFile(const string& filename) {
+    const string idxname = indexFilename(filename);
+    ifstream idxfile(idxname.c_str());
+    string header;
+    if (!idxfile || !getline(idxfile, header) || !Utils::startswith(header, INDEXHEADER)) return;
+    idxfile.close();
+    std::remove(idxname.c_str());
+  }
+
+
+  vector<AnalysisObject*> ReaderYODA::readObjects(const string& filename, const vector<string>& paths) {
+    // Compressed files can't be read at an offset, so are searched for the objects
+    const Index idx = mkIndex(filename);
+    if (!idx.hasExtents()) return Reader::readObjects(filename, paths);
+
+    // Read and parse each object's block on its own
+    vector<AnalysisObject*> rtn;
+    try {
+      ifstream in(filename.c_str(), ios::binary);
+      string block;
+      unordered_set<string> done;
+      for (const string& path : paths) {
+        auto it = idx.getExtents().find(path);
+        if (it == idx.getExtents().end() || !done.insert(path).second) continue;
+        block.resize(it->second.length);
+        if (!in.seekg(it->second.offset) || !in.read(&block[0], block.size()))
+          throw ReadError("Reading object " + path + " from " + filename + " failed");
+        LineReader lines(block.data(), block.data() + block.size());
+        parseYODA(lines, [&rtn](AnalysisObject* ao) { rtn.push_back(ao); }, Reader::PathFilter());
+      }
+    } catch (...) {
+      for (AnalysisObject* ao : rtn) delete ao;
+      throw;
+    }
+    return rtn;
+  }
+
+
 }
@@ -0,0 +1,75 @@
+// -*- C++ -*-
+//
+// This file is part of YODA -- Yet more Objects for Data Analysis
+// Copyright (C) 2008-2021 The YODA collaboration (see AUTHORS for details)
+//
+#include "YODA/Weights.h"
+#include <algorithm>
+#include <map>
+#include <mutex>
+
+using namespace std;
+
+namespace YODA {
+
+
+  WeightsSchema::Ptr WeightsSchema::intern(std::vector<std::string> keys) {
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+    // Reuse this thread's last schema without locking, as when making a Weights per event
+    static thread_local std::vector<std::string> last_keys;
+    static thread_local Ptr last;
+    if (last && keys == last_keys) return last;
+
+    // Share one schema per distinct key set for as long as any Weights uses it
+    static std::map<std::vector<std::string>, std::weak_ptr<const WeightsSchema> > registry;
+    static size_t sweep_size = 16;
+    static std::mutex registry_mutex;
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    std::weak_ptr<const WeightsSchema>& entry = registry[keys];
+    Ptr rtn = entry.lock();
+    if (!rtn) {
+      rtn = std::make_shared<const WeightsSchema>(keys);
+      entry = rtn;
+      // Drop the entries of expired schemas whenever the registry has doubled since the last sweep
+      if (registry.size() > sweep_size) {
+        for (auto it = registry.begin(); it != registry.end(); ) {
+          if (it->second.expired()) it = registry.erase(it);
+          else ++it;
+        }
+        sweep_size = std::max<size_t>(16, 2*registry.size());
+      }
+    }
+    last_keys.swap(keys);
+    last = rtn;
+    return rtn;
+  }
+
+
+  const size_t WeightsSchema::npos;
+
+
+  size_t WeightsSchema::index(const std::string& key) const {
+    const std::vector<std::string>::const_iterator it = std::lower_bound(_keys.begin(), _keys.end(), key);
+    if (it == _keys.end() || *it != key) return npos;
+    return it - _keys.begin();
+  }
+
+
+  void Weights::_init(const std::vector<std::string>& keys, const std::vector<double>& values) {
+    _schema = WeightsSchema::intern(keys);
+    _values.assign(_schema->size(), 0.0);
+    for (size_t i = 0; i < keys.size(); ++i) {
+      _values[_schema->index(keys[i])] = values[i];
+    }
+  }
+
+
+  const WeightsSchema::Ptr& Weights::_singleSchema() {
+    static const WeightsSchema::Ptr single = WeightsSchema::intern(std::vector<std::string>(1, "0"));
+    return single;
+  }
+
+
+}
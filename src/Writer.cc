@@ -110,6 +110,18 @@ namespace YODA {
       writeHisto1D(stream, dynamic_cast<const Histo1D&>(ao));
     } else if (aotype == "Histo2D") {
       writeHisto2D(stream, dynamic_cast<const Histo2D&>(ao));
+    } else if (aotype == "CountHisto1D") {
+      writeCountHisto1D(stream, dynamic_cast<const CountHisto1D&>(ao));
+    } else if (aotype == "CountHisto2D") {
+      writeCountHisto2D(stream, dynamic_cast<const CountHisto2D&>(ao));
+    } else if (aotype == "MultiCounter") {
+      writeMultiCounter(stream, dynamic_cast<const MultiCounter&>(ao));
+    } else if (aotype == "MultiHisto1D") {
+      writeMultiHisto1D(stream, dynamic_cast<const MultiHisto1D&>(ao));
+    } else if (aotype == "MultiHisto2D") {
+      writeMultiHisto2D(stream, dynamic_cast<const MultiHisto2D&>(ao));
+    } else if (aotype == "MultiProfile1D") {
+      writeMultiProfile1D(stream, dynamic_cast<const MultiProfile1D&>(ao));
     } else if (aotype == "Profile1D") {
       writeProfile1D(stream, dynamic_cast<const Profile1D&>(ao));
     } else if (aotype == "Profile2D") {
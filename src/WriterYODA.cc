@@ -4,6 +4,7 @@
 // Copyright (C) 2008-2021 The YODA collaboration (see AUTHORS for details)
 //
 #include "YODA/WriterYODA.h"
+#include "YODA/ReaderYODA.h"
 
 #include "yaml-cpp/yaml.h"
 #ifdef YAML_NAMESPACE
@@ -12,6 +13,8 @@
 
 #include <iostream>
 #include <iomanip>
+#include <fstream>
+#include <cstdio>
 using namespace std;
 
 namespace YODA {
@@ -59,11 +62,13 @@ namespace YODA {
     ios_base::fmtflags oldflags = os.flags();
     os << scientific << showpoint << setprecision(_aoprecision);
 
+    const std::streamoff start = _blockStart(os);
     os << "BEGIN " << _iotypestr("COUNTER") << " " << c.path() << "\n";
     _writeAnnotations(os, c);
     os << "# sumW\t sumW2\t numEntries\n";
     os << c.sumW()  << "\t" << c.sumW2() << "\t" << c.numEntries() << "\n";
     os << "END " << _iotypestr("COUNTER") << "\n\n";
+    _indexBlock(os, start, "Counter", c, 0);
 
     os.flags(oldflags);
   }
@@ -73,6 +78,7 @@ namespace YODA {
     ios_base::fmtflags oldflags = os.flags();
     os << scientific << showpoint << setprecision(_aoprecision);
 
+    const std::streamoff start = _blockStart(os);
     os << "BEGIN " << _iotypestr("HISTO1D") << " " << h.path() << "\n";
     _writeAnnotations(os, h);
     try {
@@ -103,6 +109,7 @@ namespace YODA {
       os << b.numEntries() << "\n";
     }
     os << "END " << _iotypestr("HISTO1D") << "\n\n";
+    _indexBlock(os, start, "Histo1D", h, h.numBins());
 
     os.flags(oldflags);
   }
@@ -111,6 +118,7 @@ namespace YODA {
   void WriterYODA::writeHisto2D(std::ostream& os, const Histo2D& h) {
     ios_base::fmtflags oldflags = os.flags();
     os << scientific << showpoint << setprecision(_aoprecision);
+    const std::streamoff start = _blockStart(os);
     os << "BEGIN " << _iotypestr("HISTO2D") << " " << h.path() << "\n";
     _writeAnnotations(os, h);
     try {
@@ -156,6 +164,64 @@ namespace YODA {
       os << b.numEntries() << "\n";
     }
     os << "END " << _iotypestr("HISTO2D") << "\n\n";
+    _indexBlock(os, start, "Histo2D", h, h.numBins());
+
+    os.flags(oldflags);
+  }
+
+
+  void WriterYODA::writeCountHisto1D(std::ostream& os, const CountHisto1D& h) {
+    ios_base::fmtflags oldflags = os.flags();
+    os << scientific << showpoint << setprecision(_aoprecision);
+
+    const std::streamoff start = _blockStart(os);
+    os << "BEGIN " << _iotypestr("COUNTHISTO1D") << " " << h.path() << "\n";
+    _writeAnnotations(os, h);
+    os << "# Area: " << h.integral() << "\n";
+    os << "# ID\t ID\t sumw\t sumw2\t numEntries\n";
+    os << "Total   \tTotal   \t";
+    os << h.totalDbn().sumW()  << "\t" << h.totalDbn().sumW2()  << "\t";
+    os << h.totalDbn().numEntries() << "\n";
+    os << "Underflow\tUnderflow\t";
+    os << h.underflow().sumW()  << "\t" << h.underflow().sumW2()  << "\t";
+    os << h.underflow().numEntries() << "\n";
+    os << "Overflow\tOverflow\t";
+    os << h.overflow().sumW()  << "\t" << h.overflow().sumW2()  << "\t";
+    os << h.overflow().numEntries() << "\n";
+    os << "# xlow\t xhigh\t sumw\t sumw2\t numEntries\n";
+    for (const CountBin1D& b : h.bins()) {
+      os << b.xMin() << "\t" << b.xMax() << "\t";
+      os << b.sumW()    << "\t" << b.sumW2()    << "\t";
+      os << b.numEntries() << "\n";
+    }
+    os << "END " << _iotypestr("COUNTHISTO1D") << "\n\n";
+    _indexBlock(os, start, "CountHisto1D", h, h.numBins());
+
+    os.flags(oldflags);
+  }
+
+
+  void WriterYODA::writeCountHisto2D(std::ostream& os, const CountHisto2D& h) {
+    ios_base::fmtflags oldflags = os.flags();
+    os << scientific << showpoint << setprecision(_aoprecision);
+
+    const std::streamoff start = _blockStart(os);
+    os << "BEGIN " << _iotypestr("COUNTHISTO2D") << " " << h.path() << "\n";
+    _writeAnnotations(os, h);
+    os << "# Volume: " << h.integral() << "\n";
+    os << "# ID\t ID\t sumw\t sumw2\t numEntries\n";
+    os << "Total   \tTotal   \t";
+    os << h.totalDbn().sumW()  << "\t" << h.totalDbn().sumW2()  << "\t";
+    os << h.totalDbn().numEntries() << "\n";
+    os << "# xlow\t xhigh\t ylow\t yhigh\t sumw\t sumw2\t numEntries\n";
+    for (const CountBin2D& b : h.bins()) {
+      os << b.xMin() << "\t" << b.xMax() << "\t";
+      os << b.yMin() << "\t" << b.yMax() << "\t";
+      os << b.sumW()     << "\t" << b.sumW2()     << "\t";
+      os << b.numEntries() << "\n";
+    }
+    os << "END " << _iotypestr("COUNTHISTO2D") << "\n\n";
+    _indexBlock(os, start, "CountHisto2D", h, h.numBins());
 
     os.flags(oldflags);
   }
@@ -165,6 +231,7 @@ namespace YODA {
     ios_base::fmtflags oldflags = os.flags();
     os << scientific << showpoint << setprecision(_aoprecision);
 
+    const std::streamoff start = _blockStart(os);
     os << "BEGIN " << _iotypestr("PROFILE1D") << " " << p.path() << "\n";
     _writeAnnotations(os, p);
     os << "# ID\t ID\t sumw\t sumw2\t sumwx\t sumwx2\t sumwy\t sumwy2\t numEntries\n";
@@ -192,6 +259,7 @@ namespace YODA {
       os << b.numEntries() << "\n";
     }
     os << "END " << _iotypestr("PROFILE1D") << "\n\n";
+    _indexBlock(os, start, "Profile1D", p, p.numBins());
 
     os.flags(oldflags);
   }
@@ -201,6 +269,7 @@ namespace YODA {
     ios_base::fmtflags oldflags = os.flags();
     os << scientific << showpoint << setprecision(_aoprecision);
 
+    const std::streamoff start = _blockStart(os);
     os << "BEGIN " << _iotypestr("PROFILE2D") << " " << p.path() << "\n";
     _writeAnnotations(os, p);
     os << "# sumw\t sumw2\t sumwx\t sumwx2\t sumwy\t sumwy2\t sumwz\t sumwz2\t sumwxy\t numEntries\n";
@@ -242,6 +311,7 @@ namespace YODA {
       os << b.numEntries() << "\n";
     }
     os << "END " << _iotypestr("PROFILE2D") << "\n\n";
+    _indexBlock(os, start, "Profile2D", p, p.numBins());
 
     os.flags(oldflags);
   }
@@ -256,6 +326,7 @@ namespace YODA {
     auto sclone =  s.clone();
     sclone.writeVariationsToAnnotations();
 
+    const std::streamoff start = _blockStart(os);
     os << "BEGIN " << _iotypestr("SCATTER1D") << " " << s.path() << "\n";
     _writeAnnotations(os, sclone);
 
@@ -270,6 +341,7 @@ namespace YODA {
       os <<  "\n";
     }
     os << "END " << _iotypestr("SCATTER1D") << "\n\n";
+    _indexBlock(os, start, "Scatter1D", s, s.numPoints());
 
     os << flush;
     os.flags(oldflags);
@@ -279,6 +351,7 @@ namespace YODA {
   void WriterYODA::writeScatter2D(std::ostream& os, const Scatter2D& s) {
     ios_base::fmtflags oldflags = os.flags();
     os << scientific << showpoint << setprecision(_aoprecision);
+    const std::streamoff start = _blockStart(os);
     os << "BEGIN " << _iotypestr("SCATTER2D") << " " << s.path() << "\n";
 
     // Write annotations.
@@ -303,6 +376,7 @@ namespace YODA {
       os <<  "\n";
     }
     os << "END " << _iotypestr("SCATTER2D") << "\n\n";
+    _indexBlock(os, start, "Scatter2D", s, s.numPoints());
 
     os << flush;
     os.flags(oldflags);
@@ -312,6 +386,7 @@ namespace YODA {
   void WriterYODA::writeScatter3D(std::ostream& os, const Scatter3D& s) {
     ios_base::fmtflags oldflags = os.flags();
     os << scientific << showpoint << setprecision(_aoprecision);
+    const std::streamoff start = _blockStart(os);
     os << "BEGIN " << _iotypestr("SCATTER3D") << " " << s.path() << "\n";
 
     // write annotations
@@ -337,10 +412,41 @@ namespace YODA {
       os <<  "\n";
     }
     os << "END " << _iotypestr("SCATTER3D") << "\n\n";
+    _indexBlock(os, start, "Scatter3D", s, s.numPoints());
 
     os << flush;
     os.flags(oldflags);
   }
 
 
+  std::streamoff WriterYODA::_blockStart(std::ostream& os) const {
+    return _indexing ? static_cast<std::streamoff>(os.tellp()) : 0;
+  }
+
+
+  void WriterYODA::_indexBlock(std::ostream& os, std::streamoff start, const std::string& type,
+                               const AnalysisObject& ao, int nbins) {
+    if (!_indexing) return;
+    // The block ends with the END line's line ending, before the blank line after it
+    const size_t length = static_cast<size_t>(static_cast<std::streamoff>(os.tellp()) - start) - 1;
+    // As when indexing by reading, only the first block with each path has its position kept
+    _indexed[type].insert({ao.path(), nbins});
+    _extents.insert({ao.path(), Index::Extent{static_cast<size_t>(start), length}});
+  }
+
+
+  void WriterYODA::writeIndex(const std::string& filename) {
+    const Index idx(_indexed, _extents);
+    _indexed.clear();
+    _extents.clear();
+    ifstream file(filename.c_str(), ios::binary | ios::ate);
+    if (file && idx.hasExtents() && static_cast<size_t>(file.tellg()) >= _indexthreshold) {
+      ReaderYODA::writeIndexFile(filename, idx);
+    } else {
+      // Don't leave the index of an earlier file by this name, in case it looks up to date
+      ReaderYODA::removeIndexFile(filename);
+    }
+  }
+
+
 }
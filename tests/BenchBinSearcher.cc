@@ -0,0 +1,49 @@
+#include "YODA/Utils/BinSearcher.h"
+#include "YODA/Utils/Formatting.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <vector>
+
+using namespace YODA;
+using namespace std;
+
+
+/// Time a callable, returning the cost per lookup in ns
+template <typename FN>
+double nsPerLookup(FN fn, size_t nlookups) {
+  const auto start = chrono::steady_clock::now();
+  fn();
+  const auto stop = chrono::steady_clock::now();
+  return chrono::duration<double, nano>(stop - start).count() / nlookups;
+}
+
+
+/// Benchmark of bin lookups in irregular binnings of 10 to 1e6 bins, with an optional number of lookups as argument
+int main(int argc, char** argv) {
+  const size_t N = (argc > 1) ? atol(argv[1]) : 1000000;
+
+  MSG_BLUE("Lookup cost per value for " << N << " random values in random-width binnings: ");
+  size_t sink = 0; //< keeps the lookups from being optimised away
+  MSG(PAD(10) << "Nbins" << PAD(18) << "std::upper_bound" << PAD(18) << "index()" << PAD(18) << "indices()");
+  for (size_t nbins = 10; nbins <= 1000000; nbins *= 10) {
+    vector<double> edges = {0};
+    for (size_t i = 0; i < nbins; ++i) edges.push_back(edges.back() + 0.1 + rand()/static_cast<double>(RAND_MAX));
+    const Utils::BinSearcher bs(edges);
+
+    vector<double> xs(N);
+    for (double& x : xs) x = edges.back()*rand()/static_cast<double>(RAND_MAX);
+    vector<size_t> out(N);
+
+    size_t sum = 0;
+    const double tref = nsPerLookup([&]{ for (double x : xs) sum += upper_bound(edges.begin(), edges.end(), x) - edges.begin(); }, N);
+    const double tindex = nsPerLookup([&]{ for (double x : xs) sum += bs.index(x); }, N);
+    const double tindices = nsPerLookup([&]{ bs.indices(xs.data(), N, out.data()); }, N);
+    sum += out[0];
+    MSG(PAD(10) << nbins << PAD(18) << tref << PAD(18) << tindex << PAD(18) << tindices);
+    sink += sum;
+  }
+  MSG("Checksum of the lookups: " << sink);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,73 @@
+#include "YODA/Histo1D.h"
+#include "YODA/Histo2D.h"
+#include "YODA/Profile1D.h"
+#include "YODA/Profile2D.h"
+#include "YODA/Utils/Formatting.h"
+#include <chrono>
+#include <cstdlib>
+#include <vector>
+
+using namespace YODA;
+using namespace std;
+
+
+/// Time a callable, returning the cost per fill entry in ns
+template <typename FN>
+double nsPerEntry(FN fn, size_t nentries) {
+  const auto start = chrono::steady_clock::now();
+  fn();
+  const auto stop = chrono::steady_clock::now();
+  return chrono::duration<double, nano>(stop - start).count() / nentries;
+}
+
+
+/// Benchmark of scalar vs. batched fills, with an optional number of entries as argument
+int main(int argc, char** argv) {
+  const size_t N = (argc > 1) ? atol(argv[1]) : 1000000;
+
+  vector<double> xs(N), ys(N), zs(N), ws(N);
+  for (size_t i = 0; i < N; ++i) {
+    xs[i] = -10 + 120*(rand()/static_cast<double>(RAND_MAX));
+    ys[i] = -10 + 120*(rand()/static_cast<double>(RAND_MAX));
+    zs[i] = rand()/static_cast<double>(RAND_MAX);
+    ws[i] = rand()/static_cast<double>(RAND_MAX);
+  }
+
+  MSG_BLUE("Fill cost per entry for " << N << " entries (scalar fill vs. fillMany): ");
+
+  Histo1D h1a(100, 0, 100), h1b(100, 0, 100);
+  const double th1a = nsPerEntry([&]{ for (size_t i = 0; i < N; ++i) h1a.fill(xs[i], ws[i]); }, N);
+  const double th1b = nsPerEntry([&]{ h1b.fillMany(N, xs.data(), ws.data()); }, N);
+  MSG(PAD(20) << "Histo1D: " << th1a << " ns vs. " << th1b << " ns");
+
+  Profile1D p1a(100, 0, 100), p1b(100, 0, 100);
+  const double tp1a = nsPerEntry([&]{ for (size_t i = 0; i < N; ++i) p1a.fill(xs[i], zs[i], ws[i]); }, N);
+  const double tp1b = nsPerEntry([&]{ p1b.fillMany(N, xs.data(), zs.data(), ws.data()); }, N);
+  MSG(PAD(20) << "Profile1D: " << tp1a << " ns vs. " << tp1b << " ns");
+
+  Histo2D h2a(100, 0, 100, 100, 0, 100), h2b(100, 0, 100, 100, 0, 100);
+  const double th2a = nsPerEntry([&]{ for (size_t i = 0; i < N; ++i) h2a.fill(xs[i], ys[i], ws[i]); }, N);
+  const double th2b = nsPerEntry([&]{ h2b.fillMany(N, xs.data(), ys.data(), ws.data()); }, N);
+  MSG(PAD(20) << "Histo2D: " << th2a << " ns vs. " << th2b << " ns");
+
+  Profile2D p2a(100, 0, 100, 100, 0, 100), p2b(100, 0, 100, 100, 0, 100);
+  const double tp2a = nsPerEntry([&]{ for (size_t i = 0; i < N; ++i) p2a.fill(xs[i], ys[i], zs[i], ws[i]); }, N);
+  const double tp2b = nsPerEntry([&]{ p2b.fillMany(N, xs.data(), ys.data(), zs.data(), ws.data()); }, N);
+  MSG(PAD(20) << "Profile2D: " << tp2a << " ns vs. " << tp2b << " ns");
+
+  MSG_BLUE("Fill cost per entry for " << N << " entries into 316x316 bins (direct vs. buffered fills): ");
+
+  Histo2D h2c(316, 0, 100, 316, 0, 100), h2d(316, 0, 100, 316, 0, 100);
+  h2d.setFillBuffer();
+  const double th2c = nsPerEntry([&]{ for (size_t i = 0; i < N; ++i) h2c.fill(xs[i], ys[i], ws[i]); }, N);
+  const double th2d = nsPerEntry([&]{ for (size_t i = 0; i < N; ++i) h2d.fill(xs[i], ys[i], ws[i]); h2d.flushFills(); }, N);
+  MSG(PAD(20) << "Histo2D: " << th2c << " ns vs. " << th2d << " ns");
+
+  Profile2D p2c(316, 0, 100, 316, 0, 100), p2d(316, 0, 100, 316, 0, 100);
+  p2d.setFillBuffer();
+  const double tp2c = nsPerEntry([&]{ for (size_t i = 0; i < N; ++i) p2c.fill(xs[i], ys[i], zs[i], ws[i]); }, N);
+  const double tp2d = nsPerEntry([&]{ for (size_t i = 0; i < N; ++i) p2d.fill(xs[i], ys[i], zs[i], ws[i]); p2d.flushFills(); }, N);
+  MSG(PAD(20) << "Profile2D: " << tp2c << " ns vs. " << tp2d << " ns");
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,78 @@
+#include "YODA/Histo1D.h"
+#include "YODA/Profile1D.h"
+#include "YODA/ReaderYODA.h"
+#include "YODA/WriterYODA.h"
+#include "YODA/Utils/Formatting.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+using namespace YODA;
+using namespace std;
+
+
+/// Time reading a file with @a fn, returning the throughput in MB/s
+template <typename FN>
+double mbPerSec(FN fn, size_t nbytes) {
+  const auto start = chrono::steady_clock::now();
+  fn();
+  const auto stop = chrono::steady_clock::now();
+  return nbytes / 1e6 / chrono::duration<double>(stop - start).count();
+}
+
+
+/// Benchmark of YODA-format reading, with an optional file size in MB, file path and number of threads as arguments
+int main(int argc, char** argv) {
+  const size_t MB = (argc > 1) ? atol(argv[1]) : 64;
+  const string filename = (argc > 2) ? argv[2] : "benchread.yoda";
+  const size_t nthreads = (argc > 3) ? atol(argv[3]) : 0;
+
+  // A synthetic file of filled histograms and profiles
+  vector<AnalysisObject*> aos;
+  for (size_t i = 0; i < 100; ++i) {
+    const string n = to_string(i);
+    Histo1D* h = new Histo1D(100, 0, 100, "/BENCH/h" + n, "Histo");
+    Profile1D* p = new Profile1D(100, 0, 100, "/BENCH/p" + n, "Profile");
+    for (size_t j = 0; j < 10000; ++j) {
+      const double x = -10 + 120*(rand()/static_cast<double>(RAND_MAX));
+      const double w = rand()/static_cast<double>(RAND_MAX);
+      h->fill(x, w);
+      p->fill(x, x*w, w);
+    }
+    aos.push_back(h);
+    aos.push_back(p);
+  }
+  ostringstream os;
+  WriterYODA::create().write(os, aos);
+  for (AnalysisObject* ao : aos) delete ao;
+  const string block = os.str();
+  size_t nbytes = 0, ncopies = 0;
+  {
+    ofstream out(filename.c_str(), ios::binary);
+    while (nbytes < MB << 20) {
+      out << block;
+      nbytes += block.size();
+      ncopies += 1;
+    }
+  }
+
+  MSG_BLUE("Read throughput for a " << nbytes/1000000 << " MB file of " << 200*ncopies << " objects: ");
+
+  size_t nread = 0;
+  const Reader::AOSink count = [&](AnalysisObject* ao) { nread += 1; delete ao; };
+  const double tfile = mbPerSec([&]{ ReaderYODA::create().readEach(filename, count); }, nbytes);
+  MSG(PAD(20) << "From file: " << tfile << " MB/s");
+  const double tstream = mbPerSec([&]{ ifstream in(filename.c_str()); ReaderYODA::create().readEach(in, count); }, nbytes);
+  MSG(PAD(20) << "From stream: " << tstream << " MB/s");
+  const double tpar = mbPerSec([&]{ ReaderYODA::create().readEach(filename, count, Reader::PathFilter(), nthreads); }, nbytes);
+  MSG(PAD(20) << "In parallel: " << tpar << " MB/s");
+  const Reader::PathFilter one = Reader::mkPathFilter({"^/BENCH/h0$"}, {});
+  const double tsel = mbPerSec([&]{ ReaderYODA::create().readEach(filename, count, one); }, nbytes);
+  MSG(PAD(20) << "Selecting 1 in 200: " << tsel << " MB/s");
+
+  remove(filename.c_str());
+  return nread == (3*200 + 1)*ncopies ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,108 @@
+#include "YODA/Histo1D.h"
+#include "YODA/WriterYODA.h"
+#include "YODA/Utils/Formatting.h"
+#include "TestUtils.h"
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <vector>
+
+using namespace YODA;
+using namespace std;
+
+
+int main() {
+  MSG_BLUE("Testing auto-binned histograms: ");
+
+  // Positive, skewed fill values and weights
+  vector<double> xs, ws;
+  for (size_t i = 0; i < 3000; ++i) {
+    xs.push_back(exp(6*(rand()/static_cast<double>(RAND_MAX))));
+    ws.push_back(0.5 + rand()/static_cast<double>(RAND_MAX));
+  }
+  const vector<double> xbuf(xs.begin(), xs.begin()+1000);
+  const double xmin = *min_element(xbuf.begin(), xbuf.end());
+  const double xmax = *max_element(xbuf.begin(), xbuf.end());
+
+  MSG_(PAD(70) << "Checking fills are held back until the buffer is full: ");
+  Histo1D h1(20, AUTOBIN_LIN, 1000);
+  for (size_t i = 0; i < 999; ++i) h1.fill(xs[i], ws[i]);
+  if (!h1.autoBinPending()) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  h1.fill(xs[999], ws[999]);
+  if (h1.autoBinPending() || h1.numBins() != 20 || h1.xMin() != xmin || !(h1.xMax() > xmax)) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking replayed fills match a directly booked histogram: ");
+  Histo1D h2(h1.xEdges());
+  for (size_t i = 0; i < 1000; ++i) h2.fill(xs[i], ws[i]);
+  if (!sameContent(h1, h2) || h1.numEntries(false) != 1000) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking later fills outside the chosen range go to the outflows: ");
+  h1.fill(xmin - 1); h1.fill(2*xmax, 2.0); h1.fill(numeric_limits<double>::infinity());
+  if (h1.underflow().numEntries() != 1 || h1.overflow().numEntries() != 2 || h1.overflow().sumW() != 3) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking batched fills through the buffer match scalar fills: ");
+  Histo1D h3(20, AUTOBIN_LOG, 1000), h4(20, AUTOBIN_LOG, 1000);
+  for (size_t i = 0; i < xs.size(); ++i) h3.fill(xs[i], ws[i]);
+  h4.fillMany(xs, ws);
+  if (!sameContent(h3, h4)) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking log binning of a positive sample: ");
+  const vector<double> logedges = h3.xEdges();
+  const double r0 = logedges[1]/logedges[0], r1 = logedges[19]/logedges[18];
+  if (logedges.size() != 21 || !fuzzyEquals(r0, r1, 1e-6) || !(logedges.back() > xmax)) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking quantile binning gives similar bin contents: ");
+  Histo1D h5(10, AUTOBIN_QUANTILE, 1000);
+  for (size_t i = 0; i < 1000; ++i) h5.fill(xs[i]);
+  for (const HistoBin1D& b : h5.bins()) {
+    if (fabs(b.numEntries() - 100) > 1) {
+      MSG_RED("FAIL");
+      return -1;
+    }
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking a part-filled histogram reads unbooked until booked: ");
+  Histo1D h6(10, AUTOBIN_LIN);
+  h6.fill(1); h6.fill(3); h6.fill(2, 2.0);
+  if (!h6.autoBinPending() || h6.numBins() != 0 || h6.sumW() != 0) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  h6.autoBook();
+  if (h6.sumW() != 4 || h6.autoBinPending() || h6.xMin() != 1 || h6.bin(9).sumW() != 1) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  try {
+    h6.addBin(10, 20);
+    MSG_RED("FAIL");
+    return -1;
+  } catch (const LockError&) { }
+  MSG_GREEN("PASS");
+
+  return EXIT_SUCCESS;
+}
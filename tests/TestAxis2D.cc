@@ -0,0 +1,114 @@
+#include "YODA/Axis2D.h"
+#include "YODA/HistoBin2D.h"
+#include "YODA/Utils/Formatting.h"
+#include <cstdlib>
+#include <vector>
+
+using namespace YODA;
+using namespace std;
+
+typedef Axis2D<HistoBin2D, Dbn2D> Axis;
+
+
+/// Index of the bin containing (x, y) by a scan over all bins, or -1
+int scanIndexAt(const Axis& axis, double x, double y) {
+  for (size_t i = 0; i < axis.numBins(); ++i) {
+    const HistoBin2D& b = axis.bin(i);
+    if (x >= b.xMin() && x < b.xMax() && y >= b.yMin() && y < b.yMax()) return i;
+  }
+  return -1;
+}
+
+
+/// Check single and batched lookups against a scan, at random points and on and around the bin corners
+bool checkLookups(const Axis& axis) {
+  vector<double> xs, ys;
+  for (size_t i = 0; i < axis.numBins(); ++i) {
+    for (double dx : {-1e-9, 0.0, 1e-9}) {
+      for (double dy : {-1e-9, 0.0, 1e-9}) {
+        xs.push_back(axis.bin(i).xMin() + dx);
+        ys.push_back(axis.bin(i).yMin() + dy);
+        xs.push_back(axis.bin(i).xMax() + dx);
+        ys.push_back(axis.bin(i).yMax() + dy);
+      }
+    }
+  }
+  for (size_t i = 0; i < 10000; ++i) {
+    xs.push_back(-1 + 12*(rand()/static_cast<double>(RAND_MAX)));
+    ys.push_back(-1 + 12*(rand()/static_cast<double>(RAND_MAX)));
+  }
+  vector<ssize_t> out(xs.size());
+  axis.binIndicesAt(xs.size(), xs.data(), ys.data(), out.data());
+  for (size_t k = 0; k < xs.size(); ++k) {
+    const int iref = scanIndexAt(axis, xs[k], ys[k]);
+    if (axis.binIndexAt(xs[k], ys[k]) != iref || out[k] != iref) {
+      MSG("(" << xs[k] << ", " << ys[k] << ") => " << axis.binIndexAt(xs[k], ys[k]) << ", " << out[k] << " != " << iref);
+      return false;
+    }
+  }
+  return true;
+}
+
+
+int main() {
+  MSG_BLUE("Testing Axis2D bin indexing: ");
+
+  // Rows of bins with staggered edges, along y and transposed along x, with some gaps
+  vector<HistoBin2D> rowbins, colbins;
+  for (size_t r = 0; r < 40; ++r) {
+    const double x0 = 0.011*r;
+    for (size_t c = 0; c < 20; ++c) {
+      if ((r + c) % 7 == 0) continue;
+      const double xlow = (c == 0) ? 0 : x0 + 0.5*c, xhigh = (c == 19) ? 10 : x0 + 0.5*(c+1);
+      rowbins.push_back(HistoBin2D(xlow, xhigh, 0.25*r, 0.25*(r+1)));
+      colbins.push_back(HistoBin2D(0.25*r, 0.25*(r+1), xlow, xhigh));
+    }
+  }
+  const vector<double> regedges = {0, 1, 2, 3, 5, 8, 10};
+
+  MSG_(PAD(70) << "Checking staggered row binning lookups: ");
+  Axis rowaxis(rowbins);
+  if (!checkLookups(rowaxis)) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking staggered column binning lookups: ");
+  Axis colaxis(colbins);
+  if (!checkLookups(colaxis)) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking grid binning lookups: ");
+  Axis gridaxis(regedges, regedges);
+  if (!checkLookups(gridaxis)) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking erasing a region of staggered bins: ");
+  size_t nerased = 0;
+  for (size_t i = 0; i < rowaxis.numBins(); ++i) nerased += rowaxis.bin(i).yMin() >= 2.5 && rowaxis.bin(i).yMax() <= 5;
+  const size_t nbefore = rowaxis.numBins();
+  rowaxis.eraseBins(make_pair(-1.0, 11.0), make_pair(2.5, 5.1));
+  if (nerased == 0 || rowaxis.numBins() != nbefore - nerased || rowaxis.binIndexAt(5.5, 3) != -1 || !checkLookups(rowaxis)) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking that overlapping staggered bins are rejected: ");
+  rowbins.push_back(HistoBin2D(4.99, 5.01, 0, 0.25));
+  try {
+    Axis overlapaxis(rowbins);
+    MSG_RED("FAIL");
+    return -1;
+  } catch (const RangeError&) { }
+  MSG_GREEN("PASS");
+
+  return EXIT_SUCCESS;
+}
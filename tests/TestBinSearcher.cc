@@ -48,5 +48,158 @@ int main() {
   TESTBS(bs3, 101, 11);
   TESTBS(bs3, 102, 11);
 
+  // Regular binnings use arithmetic lookup, which must agree exactly with the edge search
+  const vector< vector<double> > regedges = { linspace(100, 0, 100), linspace(50, 0, 1),
+                                              linspace(20, -5, 5), linspace(37, -2.2, 13.7) };
+  for (const vector<double>& edges : regedges) {
+    YODA::Utils::BinSearcher bs(edges);
+    MSG("Regular lookup for " << edges.size()-1 << " bins in " << edges.front() << ".." << edges.back()
+        << ": " << boolalpha << bs.regular());
+    vector<double> xs;
+    for (double e : edges) {
+      xs.push_back(e);
+      xs.push_back(nextafter(e, -numeric_limits<double>::infinity()));
+      xs.push_back(nextafter(e, numeric_limits<double>::infinity()));
+    }
+    for (size_t i = 0; i < 1000; ++i) xs.push_back(edges.front() - 1 + (edges.back()-edges.front()+2)*rand()/static_cast<double>(RAND_MAX));
+    for (double x : xs) {
+      const size_t iref = upper_bound(edges.begin(), edges.end(), x) - edges.begin();
+      if (bs.index(x) != iref) {
+        MSG(x << " => " << bs.index(x) << " != " << iref);
+        rtn = 1;
+      }
+    }
+  }
+
+  // An irregular edge list must not be treated as regular
+  YODA::Utils::BinSearcher bs4({0, 1, 2, 4});
+  if (bs4.regular()) rtn = 1;
+  TESTBS(bs4, 3, 3);
+
+  // Binnings uniform in a transform of x should be estimated with that transform, and
+  // explicitly chosen or user-supplied transforms must not change the lookup results
+  vector<double> sqrtedges, cubeedges, logitedges;
+  for (size_t i = 0; i <= 50; ++i) {
+    sqrtedges.push_back(sqr(i/5.0));
+    cubeedges.push_back(cbrt(-8 + 16*i/50.0));
+    logitedges.push_back(1/(1 + exp(-(-4 + 8*i/50.0))));
+  }
+  const vector< pair<vector<double>, YODA::Utils::EstTransform> > transformedges =
+    { {sqrtedges, YODA::Utils::EST_SQRT}, {cubeedges, YODA::Utils::EST_POWER},
+      {logitedges, YODA::Utils::EST_LOGIT}, {logedges, YODA::Utils::EST_LOG} };
+  for (const auto& edges_tr : transformedges) {
+    const vector<double>& edges = edges_tr.first;
+    const YODA::Utils::BinSearcher bsauto(edges);
+    const YODA::Utils::BinSearcher bsuser(edges, [](double x) { return tanh(x); });
+    MSG("Estimator transform for edges " << edges.front() << ".." << edges.back() << ": "
+        << bsauto.estimator().transform() << " " << boolalpha << (bsauto.estimator().transform() == edges_tr.second));
+    if (bsauto.estimator().transform() != edges_tr.second) rtn = 1;
+    for (size_t i = 0; i < 1000; ++i) {
+      const double x = edges.front() - 1 + (edges.back()-edges.front()+2)*rand()/static_cast<double>(RAND_MAX);
+      const size_t iref = upper_bound(edges.begin(), edges.end(), x) - edges.begin();
+      if (bsauto.index(x) != iref || bsuser.index(x) != iref) {
+        MSG(x << " => " << bsauto.index(x) << ", " << bsuser.index(x) << " != " << iref);
+        rtn = 1;
+      }
+    }
+  }
+
+  // Binnings with several bin-width scales get a learned piecewise-linear estimate, and
+  // the error of a learned estimate is bounded for any binning
+  vector<double> multiedges;
+  for (double x = 1; x < 10; x += 0.5) multiedges.push_back(x);
+  for (double x = 10; x < 100; x += 5) multiedges.push_back(x);
+  for (double x = 100; x < 1000; x += 50) multiedges.push_back(x);
+  for (double x = 1000; x <= 5000; x += 500) multiedges.push_back(x);
+  const YODA::Utils::BinSearcher bsmulti(multiedges), bsmultilin(multiedges, YODA::Utils::EST_LIN);
+  vector<double> multixs;
+  for (size_t i = 0; i < 10000; ++i) multixs.push_back(exp(log(5000)*rand()/static_cast<double>(RAND_MAX)));
+  MSG("Learned estimator for multi-scale binning: " << boolalpha
+      << (bsmulti.estimator().transform() == YODA::Utils::EST_PIECEWISE) << ", hit rate "
+      << bsmulti.estimatorHitRate(multixs) << " vs. " << bsmultilin.estimatorHitRate(multixs) << " for linear");
+  if (bsmulti.estimator().transform() != YODA::Utils::EST_PIECEWISE) rtn = 1;
+  // Large binnings, which also have a B-tree index, may be learned too
+  vector<double> bigmultiedges;
+  for (double w : {0.001, 0.01, 0.1, 1.0})
+    for (size_t i = 0; i < 25000; ++i) bigmultiedges.push_back((bigmultiedges.empty() ? 0 : bigmultiedges.back()) + w);
+  const YODA::Utils::BinSearcher bsbigmulti(bigmultiedges);
+  MSG("Learned estimator for large multi-scale binning: " << boolalpha
+      << (bsbigmulti.estimator().transform() == YODA::Utils::EST_PIECEWISE));
+  if (bsbigmulti.estimator().transform() != YODA::Utils::EST_PIECEWISE) rtn = 1;
+  // A searcher rebuilt for changed edges keeps the previous choice, unless the edges have much multiplied
+  vector<double> multiedges2(multiedges.begin(), multiedges.end()-1);
+  const YODA::Utils::BinSearcher bsmulti2(multiedges2, bsmultilin), bsmulti3(bigmultiedges, bsmultilin);
+  if (bsmulti2.estimator().transform() != YODA::Utils::EST_LIN ||
+      bsmulti3.estimator().transform() != YODA::Utils::EST_PIECEWISE) {
+    MSG("Rebuilt estimator transforms " << bsmulti2.estimator().transform() << ", " << bsmulti3.estimator().transform());
+    rtn = 1;
+  }
+  for (size_t i = 0; i < 1000; ++i) {
+    const double x = multiedges2.back()*rand()/static_cast<double>(RAND_MAX);
+    const size_t iref = upper_bound(multiedges2.begin(), multiedges2.end(), x) - multiedges2.begin();
+    if (bsmulti2.index(x) != iref) rtn = 1;
+  }
+  // A linear estimate of a linear binning is always right, up to the last bin and overflow
+  const YODA::Utils::BinSearcher bslin({0, 1, 2, 3, 4}, YODA::Utils::EST_LIN);
+  if (bslin.estimatorHitRate({0.5, 3.5, 3.999, 4, 7}) != 1) {
+    MSG("Linear estimator hit rate " << bslin.estimatorHitRate({0.5, 3.5, 3.999, 4, 7}) << " != 1");
+    rtn = 1;
+  }
+  for (size_t nedges : {20, 1000, 100000}) {
+    vector<double> edges;
+    double e = 0;
+    for (size_t i = 0; i < nedges; ++i) edges.push_back(e += 0.01 + sqr(rand()/static_cast<double>(RAND_MAX)));
+    const YODA::Utils::BinSearcher bs(edges, YODA::Utils::EST_PIECEWISE);
+    MSG("Learned estimator with " << bs.estimator().numSegments() << " segments for " << nedges << " edges");
+    for (size_t i = 0; i < 10000; ++i) {
+      const double x = edges.back()*rand()/static_cast<double>(RAND_MAX);
+      const size_t iref = upper_bound(edges.begin(), edges.end(), x) - edges.begin();
+      const size_t iest = bs.estimator().estindex(x);
+      if (bs.index(x) != iref || max(iest, iref) - min(iest, iref) > YODA::Utils::PIECEWISE_MAX_ERROR + 1) {
+        MSG(x << " => " << bs.index(x) << " (estimate " << iest << ") != " << iref);
+        rtn = 1;
+      }
+    }
+  }
+
+  // Batched lookups must agree exactly with index() for every instruction set, including
+  // infinities, NaNs and values exactly on edges, and either side of the bisection and
+  // B-tree thresholds. The large binnings also check index() against std::upper_bound.
+  const double inf = numeric_limits<double>::infinity();
+  TESTBS(bs4, inf, 4);
+  TESTBS(bs4, -inf, 0);
+  for (size_t nedges : {1, 2, 3, 5, 16, 17, 33, 100, 1000, 65536, 100000, 600000}) {
+    vector<double> edges;
+    double e = -10*(rand()/static_cast<double>(RAND_MAX));
+    for (size_t i = 0; i < nedges; ++i) edges.push_back(e += 0.01 + rand()/static_cast<double>(RAND_MAX));
+    YODA::Utils::BinSearcher bs(edges);
+    vector<double> xs = {inf, -inf, numeric_limits<double>::quiet_NaN()};
+    for (double e : edges) {
+      xs.push_back(e);
+      xs.push_back(nextafter(e, -inf));
+      xs.push_back(nextafter(e, inf));
+    }
+    for (size_t i = 0; i < 1000; ++i) xs.push_back(edges.front() - 1 + (edges.back()-edges.front()+2)*rand()/static_cast<double>(RAND_MAX));
+    vector<size_t> ixs(xs.size());
+    for (size_t k = 3; nedges >= 1000 && k < xs.size(); ++k) {
+      const size_t iref = upper_bound(edges.begin(), edges.end(), xs[k]) - edges.begin();
+      if (bs.index(xs[k]) != iref) {
+        MSG("Lookup with " << nedges << " edges: " << xs[k] << " => " << bs.index(xs[k]) << " != " << iref);
+        rtn = 1;
+      }
+    }
+    for (YODA::Utils::SIMDLevel level : {YODA::Utils::SIMD_NONE, YODA::Utils::SIMD_SSE2, YODA::Utils::SIMD_AVX2}) {
+      bs.indices(xs.data(), xs.size(), ixs.data(), level);
+      for (size_t k = 0; k < xs.size(); ++k) {
+        if (ixs[k] != bs.index(xs[k])) {
+          MSG("Batched lookup with " << nedges << " edges, level " << level << ": "
+              << xs[k] << " => " << ixs[k] << " != " << bs.index(xs[k]));
+          rtn = 1;
+        }
+      }
+    }
+  }
+  MSG("Batched lookups use instruction set level " << YODA::Utils::BinSearcher::simdLevel());
+
   return rtn;
 }
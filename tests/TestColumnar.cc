@@ -0,0 +1,175 @@
+#include "YODA/Histo1D.h"
+#include "YODA/Histo2D.h"
+#include "YODA/Profile1D.h"
+#include "YODA/Profile2D.h"
+#include "YODA/WriterYODA.h"
+#include "YODA/Utils/Formatting.h"
+#include "TestUtils.h"
+#include <sstream>
+#include <vector>
+
+using namespace YODA;
+using namespace std;
+
+
+int main() {
+  MSG_BLUE("Testing columnar bin storage: ");
+
+  vector<double> xs, ys, zs, ws;
+  for (size_t i = 0; i < 3000; ++i) {
+    xs.push_back(randomCoord());
+    ys.push_back(randomCoord());
+    zs.push_back(rand()/static_cast<double>(RAND_MAX));
+    ws.push_back(randomWeight());
+  }
+  const size_t nhalf = xs.size()/2;
+
+  MSG_(PAD(70) << "Checking columnar Histo1D fills against bin fills: ");
+  Histo1D h1a(20, 0, 10), h1b(20, 0, 10);
+  h1b.setColumnar();
+  for (size_t i = 0; i < nhalf; ++i) {
+    h1a.fill(xs[i], ws[i]);
+    h1b.fill(xs[i], ws[i]);
+  }
+  h1a.fillMany(xs.size()-nhalf, &xs[nhalf], &ws[nhalf]);
+  h1b.fillMany(xs.size()-nhalf, &xs[nhalf], &ws[nhalf]);
+  for (size_t i = 0; i < 200; ++i) {
+    h1a.fillBin(i % 20, ws[i]);
+    h1b.fillBin(i % 20, ws[i]);
+  }
+  if (!h1b.columnar() || !sameContent(h1a, h1b) ||
+      h1a.sumW(false) != h1b.sumW(false) || h1a.xMean(false) != h1b.xMean(false)) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking columnar Histo1D mixed-fraction fills: ");
+  Histo1D h1e(20, 0, 10), h1f(20, 0, 10);
+  h1f.setColumnar();
+  for (size_t i = 0; i < xs.size(); ++i) {
+    const double w = i % 3 ? 1.0 : ws[i], f = i % 2 ? 1.0 : 0.1;
+    h1e.fill(xs[i], w, f);
+    h1f.fill(xs[i], w, f);
+  }
+  if (!sameContent(h1e, h1f) || h1e.numEntries() != h1f.numEntries() || h1e.bin(4).numEntries() != h1f.bin(4).numEntries()) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking columnar Histo1D scaling and combination: ");
+  Histo1D h1c = h1a, h1d = h1b;
+  h1c.scaleW(0.3); h1d.scaleW(0.3);
+  h1c += h1a; h1d += h1b;
+  h1c += h1b; h1d += h1a;
+  h1c -= h1a; h1d -= h1b;
+  if (!h1d.columnar() || !sameContent(h1c, h1d) || h1c.sumW2(false) != h1d.sumW2(false)) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking columnar Histo1D interleaved bin access and reset: ");
+  for (size_t i = 0; i < 100; ++i) {
+    h1c.bin(i % 20).fillBin(ws[i]);
+    h1d.bin(i % 20).fillBin(ws[i]);
+    h1c.fill(xs[i], ws[i]);
+    h1d.fill(xs[i], ws[i]);
+    if (h1c.bin(3).sumW() != h1d.bin(3).sumW()) {
+      MSG_RED("FAIL");
+      return -1;
+    }
+  }
+  const Histo1D& h1dc = h1d;
+  const HistoBin1D& b3 = h1dc.bin(3);
+  h1c.fill(1.6, 2.0); h1d.fill(1.6, 2.0);
+  if (!sameContent(h1c, h1d) || b3.sumW() != h1c.bin(3).sumW()) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  h1c.reset(); h1d.reset();
+  h1d.setColumnar(false);
+  if (h1d.columnar() || !sameContent(h1c, h1d) || h1d.sumW(false) != 0) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking columnar Profile1D against bin storage: ");
+  Profile1D p1a(20, 0, 10), p1b(20, 0, 10);
+  p1b.setColumnar();
+  for (size_t i = 0; i < xs.size(); ++i) {
+    p1a.fill(xs[i], zs[i], ws[i]);
+    p1b.fill(xs[i], zs[i], ws[i]);
+  }
+  p1a.scaleW(2.5); p1b.scaleW(2.5);
+  p1a += p1a; p1b += p1b;
+  if (!sameContent(p1a, p1b) || p1a.xMean(false) != p1b.xMean(false)) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking columnar buffered Histo2D against bin storage: ");
+  Histo2D h2a(20, 0, 10, 10, 0, 10), h2b(20, 0, 10, 10, 0, 10);
+  h2b.setColumnar();
+  h2b.setFillBuffer(500);
+  for (size_t i = 0; i < xs.size(); ++i) {
+    h2a.fill(xs[i], ys[i], ws[i]);
+    h2b.fill(xs[i], ys[i], ws[i]);
+  }
+  Histo2D h2c = h2a, h2d = h2b;
+  h2c.scaleW(0.7); h2d.scaleW(0.7);
+  h2c -= h2a; h2d -= h2b;
+  h2b.flushFills();
+  if (!sameContent(h2a, h2b) || !sameContent(h2c, h2d) ||
+      h2c.sumW(false) != h2d.sumW(false) || h2c.yMean(false) != h2d.yMean(false)) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking columnar Profile2D against bin storage: ");
+  Profile2D p2a(20, 0, 10, 10, 0, 10), p2b(20, 0, 10, 10, 0, 10);
+  p2b.setColumnar();
+  for (size_t i = 0; i < xs.size(); ++i) {
+    p2a.fill(xs[i], ys[i], zs[i], ws[i]);
+    p2b.fill(xs[i], ys[i], zs[i], ws[i]);
+  }
+  p2a.fillMany(xs, ys, zs, ws); p2b.fillMany(xs, ys, zs, ws);
+  p2a.scaleW(0.5); p2b.scaleW(0.5);
+  if (!sameContent(p2a, p2b) || p2a.sumW(false) != p2b.sumW(false)) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking columnar unit-fill counts stay exact above 2^53: ");
+  const double big = 9007199254740992.0;
+  Histo1D h1g(2, 0, 2), h1h(2, 0, 2), h1i(2, 0, 2);
+  h1h.setColumnar();
+  for (Histo1D* h : {&h1g, &h1h, &h1i}) {
+    h->bin(0).dbn() = Dbn1D(big, big, big, 0, 0);
+    h->fill(0.5);
+    h->fill(0.5);
+    h->fill(1.5, 2.0);
+  }
+  h1g += h1i; h1h += h1i;
+  h1g.fill(0.5); h1h.fill(0.5);
+  const uint64_t nbig = 2*9007199254740992ull + 5;
+  if (!sameContent(h1g, h1h) || h1g.bin(0).dbn().numUnitFills() != nbig || h1h.bin(0).dbn().numUnitFills() != nbig ||
+      h1g.sumW(false) != h1h.sumW(false) || h1g.sumW2(false) != h1h.sumW2(false)) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  h1g -= h1i; h1h -= h1i;
+  h1g.scaleW(0.5); h1h.scaleW(0.5);
+  if (!sameContent(h1g, h1h) || h1h.bin(0).dbn().isUnweighted()) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,141 @@
+#include "YODA/CountHisto1D.h"
+#include "YODA/CountHisto2D.h"
+#include "YODA/ReaderYODA.h"
+#include "YODA/WriterYODA.h"
+#include "YODA/WriterFLAT.h"
+#include "YODA/Utils/Formatting.h"
+#include "TestUtils.h"
+#include <sstream>
+#include <vector>
+
+using namespace YODA;
+using namespace std;
+
+
+// Read back a single object from its serialisation
+AnalysisObject* readBack(const string& s) {
+  istringstream is(s);
+  vector<AnalysisObject*> aos = ReaderYODA::create().read(is);
+  return aos.size() == 1 ? aos[0] : nullptr;
+}
+
+
+int main() {
+  MSG_BLUE("Testing counts-only histograms: ");
+
+  vector<double> xs, ys, ws;
+  for (size_t i = 0; i < 3000; ++i) {
+    xs.push_back(randomCoord());
+    ys.push_back(randomCoord());
+    ws.push_back(randomWeight());
+  }
+
+  MSG_(PAD(70) << "Checking CountHisto1D counts against Histo1D: ");
+  Histo1D h1(20, 0, 10, "/h1", "Counts");
+  CountHisto1D c1a(20, 0, 10, "/h1", "Counts"), c1b(20, 0, 10, "/h1", "Counts");
+  for (size_t i = 0; i < xs.size(); ++i) {
+    h1.fill(xs[i], ws[i]);
+    c1a.fill(xs[i], ws[i]);
+  }
+  c1b.fillMany(xs, ws);
+  if (written(c1a) != written(c1b) || written(c1a) != written(CountHisto1D(h1)) ||
+      c1a.sumW(false) != h1.sumW(false) || c1a.overflow().sumW2() != h1.overflow().sumW2()) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking CountHisto1D bins are smaller and focus on the midpoint: ");
+  if (sizeof(CountBin1D) >= sizeof(HistoBin1D) || sizeof(CountBin2D) >= sizeof(HistoBin2D) ||
+      c1a.bin(3).xFocus() != c1a.bin(3).xMid() || mkHisto1D(c1a).bin(3).xFocus() != c1a.bin(3).xMid()) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking Histo1D conversion gives the bin-weighted x mean: ");
+  const Histo1D c1h = mkHisto1D(c1a);
+  double c1sumwx = 0;
+  for (const CountBin1D& b : c1a.bins()) c1sumwx += b.sumW()*b.xMid();
+  const double c1flowwx = c1a.underflow().sumW()*c1a.xMin() + c1a.overflow().sumW()*c1a.xMax();
+  if (c1h.sumW() != c1a.sumW() || !fuzzyEquals(c1h.xMean(false), c1sumwx/c1a.sumW(false)) ||
+      !fuzzyEquals(c1h.xMean(), (c1sumwx + c1flowwx)/c1a.sumW())) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking CountHisto1D scaling and combination against Histo1D: ");
+  Histo1D h1s = h1;
+  CountHisto1D c1s = c1a;
+  c1s.setColumnar();
+  h1s.scaleW(0.3); c1s.scaleW(0.3);
+  h1s += h1; c1s += c1a;
+  h1s -= h1; c1s -= c1a;
+  if (written(c1s) != written(CountHisto1D(h1s))) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking CountHisto1D YODA-format round trip: ");
+  AnalysisObject* ao1 = readBack(written(c1a));
+  if (!ao1 || ao1->type() != "CountHisto1D" || written(*ao1) != written(c1a)) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  delete ao1;
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking CountHisto1D is written as a Histo1D by other writers: ");
+  ostringstream flat1, flat2;
+  WriterFLAT::write(flat1, c1a);
+  WriterFLAT::write(flat2, mkHisto1D(c1a));
+  if (flat1.str() != flat2.str()) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking CountHisto2D counts against Histo2D: ");
+  Histo2D h2(20, 0, 10, 10, 0, 10, "/h2", "Counts");
+  CountHisto2D c2a(20, 0, 10, 10, 0, 10, "/h2", "Counts"), c2b(20, 0, 10, 10, 0, 10, "/h2", "Counts");
+  c2b.setFillBuffer(500);
+  for (size_t i = 0; i < xs.size(); ++i) {
+    h2.fill(xs[i], ys[i], ws[i]);
+    c2a.fill(xs[i], ys[i], ws[i]);
+    c2b.fill(xs[i], ys[i], ws[i]);
+  }
+  c2b.flushFills();
+  if (written(c2a) != written(c2b) || written(c2a) != written(CountHisto2D(h2)) ||
+      c2a.sumW(false) != h2.sumW(false) || c2a.bin(7).yFocus() != c2a.bin(7).yMid()) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking Histo2D conversion gives the bin-weighted x and y means: ");
+  const Histo2D c2h = mkHisto2D(c2a);
+  double c2sumwx = 0, c2sumwy = 0;
+  for (const CountBin2D& b : c2a.bins()) {
+    c2sumwx += b.sumW()*b.xMid();
+    c2sumwy += b.sumW()*b.yMid();
+  }
+  if (!fuzzyEquals(c2h.xMean(), c2sumwx/c2a.sumW(false)) || !fuzzyEquals(c2h.yMean(), c2sumwy/c2a.sumW(false)) ||
+      !fuzzyEquals(c2h.xMean(false), c2h.xMean())) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking CountHisto2D YODA-format round trip: ");
+  AnalysisObject* ao2 = readBack(written(c2a));
+  if (!ao2 || ao2->type() != "CountHisto2D" || written(*ao2) != written(c2a)) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  delete ao2;
+  MSG_GREEN("PASS");
+
+  return EXIT_SUCCESS;
+}
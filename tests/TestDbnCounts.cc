@@ -0,0 +1,107 @@
+#include "YODA/Histo1D.h"
+#include "YODA/ReaderYODA.h"
+#include "YODA/WriterYODA.h"
+#include "YODA/Utils/Formatting.h"
+#include <sstream>
+
+using namespace YODA;
+using namespace std;
+
+
+int main() {
+  MSG_BLUE("Testing unweighted-count distributions: ");
+
+  MSG_(PAD(70) << "Checking unit fills keep exact integer counts: ");
+  Dbn0D d0;
+  for (size_t i = 0; i < 1000; ++i) d0.fill();
+  if (!d0.isUnweighted() || d0.numEntries() != 1000 || d0.sumW() != 1000 || d0.sumW2() != 1000 ||
+      d0.effNumEntries() != 1000 || sizeof(Dbn0D) != 4*sizeof(double) || sizeof(Dbn1D) != 6*sizeof(double)) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking non-unit fills go to the floating-point sums: ");
+  Dbn0D d1 = d0;
+  d1.fill(2.0);
+  d1.fill(1.0, 0.5);
+  d1.fill();
+  if (d1.isUnweighted() || d1.numUnitFills() != 1001 || d1.numEntries() != 1002.5 || d1.sumW() != 1003.5 || d1.sumW2() != 1005.5) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking arithmetic on mixed unit and weighted fills: ");
+  Dbn0D sum = d0 + d0, mixed = d0 + d1, diff = d0 - d0;
+  Dbn0D scaled = d0;
+  scaled.scaleW(0.5);
+  if (!sum.isUnweighted() || sum.sumW2() != 2000 || mixed.isUnweighted() || mixed.sumW() != 2003.5 ||
+      mixed.numEntries() != 2002.5 || diff.sumW() != 0 || diff.sumW2() != 2000 ||
+      scaled.sumW() != 500 || scaled.sumW2() != 250) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking zero weight sums are not taken for unit fills: ");
+  Dbn0D dzero(1, 0.5, -0.0), dneg;
+  dneg.fill(1.0, -1.0);
+  dneg.scaleW(0.0);
+  if (dzero.isUnweighted() || dzero.numEntries() != 1 || dzero.sumW() != 0.5 ||
+      dneg.isUnweighted() || dneg.numEntries() != -1 || dneg.sumW2() != 0) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking counts stay exact above 2^53: ");
+  const double big = 9007199254740992.0;
+  Dbn0D dbig(big, big, big), dsum(big, big, big);
+  dbig.fill();
+  dbig.fill();
+  dsum += Dbn0D(3, 3, 3);
+  dsum.fill();
+  if (!dbig.isUnweighted() || dbig.numEntries() != big + 2 || dbig.sumW2() != big + 2 ||
+      !dsum.isUnweighted() || dsum.sumW() != big + 4 || big + 1.0 + 1.0 != big) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking unit-fill Dbn1D moments match the general formulae: ");
+  Dbn1D d1a, d1b(0, 0, 0, 0, 0);
+  double sumwx = 0, sumwx2 = 0;
+  for (size_t i = 0; i < 1000; ++i) {
+    const double x = 10*(rand()/static_cast<double>(RAND_MAX));
+    d1a.fill(x);
+    sumwx += 1.0*1.0*x;
+    sumwx2 += 1.0*1.0*x*x;
+  }
+  d1b.fill(3.0, 0.5);
+  if (!d1a.isUnweighted() || d1a.sumWX() != sumwx || d1a.sumWX2() != sumwx2 ||
+      d1b.isUnweighted() || d1b.sumWX() != 1.5) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking unit-fill counts survive a YODA-format round trip: ");
+  Histo1D h(10, 0, 10, "/h", "Counts");
+  for (size_t i = 0; i < 500; ++i) h.fill(10*(rand()/static_cast<double>(RAND_MAX)));
+  h.fill(5.5, 3.0);
+  ostringstream os;
+  WriterYODA::write(os, h);
+  istringstream is(os.str());
+  vector<AnalysisObject*> aos = ReaderYODA::create().read(is);
+  Histo1D* hr = aos.size() == 1 ? dynamic_cast<Histo1D*>(aos[0]) : nullptr;
+  if (!hr || !hr->bin(0).dbn().isUnweighted() || hr->bin(5).dbn().isUnweighted() ||
+      hr->bin(0).numEntries() != h.bin(0).numEntries() || hr->totalDbn().isUnweighted()) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  delete hr;
+  MSG_GREEN("PASS");
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,198 @@
+#include "YODA/Counter.h"
+#include "YODA/Histo1D.h"
+#include "YODA/Histo2D.h"
+#include "YODA/Profile1D.h"
+#include "YODA/Profile2D.h"
+#include "YODA/WriterYODA.h"
+#include "YODA/Utils/Formatting.h"
+#include "TestUtils.h"
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <vector>
+
+using namespace YODA;
+using namespace std;
+
+
+int main() {
+  MSG_BLUE("Testing batched fills: ");
+
+  // Fill values including outflows, exact bin edges and a bin gap
+  vector<double> xs, ys, zs, ws, fs;
+  for (size_t i = 0; i < 2000; ++i) {
+    xs.push_back(randomCoord());
+    ys.push_back(randomCoord());
+    zs.push_back(rand()/static_cast<double>(RAND_MAX));
+    ws.push_back(0.5 + rand()/static_cast<double>(RAND_MAX));
+    fs.push_back(rand()/static_cast<double>(RAND_MAX));
+  }
+  xs[10] = 0; xs[11] = 10; xs[12] = 5; xs[13] = numeric_limits<double>::infinity();
+
+  MSG_(PAD(70) << "Checking Histo1D batched fills against scalar fills: ");
+  Histo1D h1a(10, 0, 10), h1b(10, 0, 10);
+  h1a.addBin(11, 12); h1b.addBin(11, 12);
+  for (size_t i = 0; i < xs.size(); ++i) h1a.fill(xs[i], ws[i], fs[i]);
+  h1b.fillMany(xs, ws, fs);
+  if (!sameContent(h1a, h1b)) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking Histo1D batched fills with unit weights: ");
+  Histo1D h1c(10, 0, 10), h1d(10, 0, 10);
+  for (size_t i = 0; i < xs.size(); ++i) h1c.fill(xs[i]);
+  h1d.fillMany(xs.size(), xs.data());
+  if (!sameContent(h1c, h1d)) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking Histo1D batched fills stop at a NaN: ");
+  Histo1D h1e(10, 0, 10), h1f(10, 0, 10);
+  vector<double> xnan(xs.begin(), xs.begin()+100);
+  xnan[50] = numeric_limits<double>::quiet_NaN();
+  for (size_t i = 0; i < 50; ++i) h1e.fill(xnan[i]);
+  try {
+    h1f.fillMany(xnan);
+    MSG_RED("FAIL");
+    return -1;
+  } catch (const RangeError&) { }
+  if (!sameContent(h1e, h1f)) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking Profile1D batched fills against scalar fills: ");
+  Profile1D p1a(10, 0, 10), p1b(10, 0, 10);
+  for (size_t i = 0; i < xs.size(); ++i) p1a.fill(xs[i], zs[i], ws[i], fs[i]);
+  p1b.fillMany(xs, zs, ws, fs);
+  if (!sameContent(p1a, p1b)) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking Histo2D batched fills against scalar fills: ");
+  Histo2D h2a(10, 0, 10, 5, 0, 10), h2b(10, 0, 10, 5, 0, 10);
+  for (size_t i = 0; i < xs.size(); ++i) h2a.fill(xs[i], ys[i], ws[i], fs[i]);
+  h2b.fillMany(xs, ys, ws, fs);
+  if (!sameContent(h2a, h2b)) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking Profile2D batched fills against scalar fills: ");
+  Profile2D p2a(10, 0, 10, 5, 0, 10), p2b(10, 0, 10, 5, 0, 10);
+  for (size_t i = 0; i < xs.size(); ++i) p2a.fill(xs[i], ys[i], zs[i], ws[i], fs[i]);
+  p2b.fillMany(xs, ys, zs, ws, fs);
+  if (!sameContent(p2a, p2b)) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking buffered Histo2D fills against direct fills: ");
+  Histo2D h2c(10, 0, 10, 5, 0, 10), h2d(10, 0, 10, 5, 0, 10);
+  h2c.eraseBin(7); h2d.eraseBin(7);
+  h2c.setGapPolicy(FILL_COUNT); h2d.setGapPolicy(FILL_COUNT);
+  h2d.setFillBuffer(300);
+  for (size_t i = 0; i < xs.size(); ++i) {
+    h2c.fill(xs[i], ys[i], ws[i], fs[i]);
+    h2d.fill(xs[i], ys[i], ws[i], fs[i]);
+  }
+  h2d.flushFills();
+  if (!sameContent(h2c, h2d) || h2c.gapDbn().sumW() != h2d.gapDbn().sumW()) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking buffered Profile2D fills against direct fills: ");
+  Profile2D p2c(10, 0, 10, 5, 0, 10), p2d(10, 0, 10, 5, 0, 10);
+  p2d.setFillBuffer(xs.size() + 1);
+  for (size_t i = 0; i < xs.size(); ++i) {
+    p2c.fill(xs[i], ys[i], zs[i], ws[i], fs[i]);
+    p2d.fill(xs[i], ys[i], zs[i], ws[i], fs[i]);
+  }
+  p2d.flushFills();
+  if (!sameContent(p2c, p2d)) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking buffered Profile2D batched fills against direct fills: ");
+  Profile2D p2e(10, 0, 10, 5, 0, 10), p2f(10, 0, 10, 5, 0, 10);
+  p2f.setFillBuffer(xs.size() / 3);
+  p2e.fill(0.5, 0.5, 1.0); p2f.fill(0.5, 0.5, 1.0);
+  for (size_t i = 0; i < xs.size(); ++i) p2e.fill(xs[i], ys[i], zs[i], ws[i], fs[i]);
+  p2f.fillMany(xs, ys, zs, ws, fs);
+  p2f.flushFills();
+  if (p2f.fillBufferSize() == 0 || !sameContent(p2e, p2f)) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking buffered gap fills throw when flushed: ");
+  Histo2D h2e(10, 0, 10, 5, 0, 10), h2f(10, 0, 10, 5, 0, 10);
+  h2e.eraseBin(7); h2f.eraseBin(7);
+  h2e.setGapPolicy(FILL_THROW); h2f.setGapPolicy(FILL_THROW);
+  h2f.setFillBuffer(xs.size() + 1);
+  size_t nrefused = 0;
+  for (size_t i = 0; i < xs.size(); ++i) {
+    h2f.fill(xs[i], ys[i], ws[i], fs[i]);
+    try {
+      h2e.fill(xs[i], ys[i], ws[i], fs[i]);
+    } catch (const RangeError&) {
+      ++nrefused;
+    }
+  }
+  bool flushthrew = false;
+  try {
+    h2f.flushFills();
+  } catch (const RangeError&) {
+    flushthrew = true;
+  }
+  if (nrefused == 0 || !flushthrew || !sameContent(h2e, h2f)) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking that const reads refuse queued fills until flushed: ");
+  h2e.fill(0.5, 0.5, 2.0); h2f.fill(0.5, 0.5, 2.0);
+  Histo2D h2g = h2f;
+  const Histo2D& h2fc = h2f;
+  bool readthrew = false;
+  try {
+    h2fc.sumW();
+  } catch (const UserError&) {
+    readthrew = true;
+  }
+  h2g.flushFills();
+  h2f.bin(0);
+  if (!readthrew || h2g.fillBufferSize() == 0 || h2g.sumW() != h2e.sumW() ||
+      !sameContent(h2e, h2fc) || !sameContent(h2e, h2g)) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking Counter batched fills against scalar fills: ");
+  Counter ca, cb;
+  for (size_t i = 0; i < ws.size(); ++i) ca.fill(ws[i], fs[i]);
+  cb.fillMany(ws, fs);
+  if (!sameContent(ca, cb)) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,137 @@
+#include "YODA/Histo1D.h"
+#include "YODA/Histo2D.h"
+#include "YODA/Profile1D.h"
+#include "YODA/Utils/Formatting.h"
+#include <cmath>
+#include <limits>
+#include <vector>
+
+using namespace YODA;
+using namespace std;
+
+
+int main() {
+  MSG_BLUE("Testing NaN and bin-gap fill policies: ");
+  const double nan = numeric_limits<double>::quiet_NaN();
+
+  // Two bins with a gap between them
+  Histo1D h(vector<HistoBin1D>{HistoBin1D(0, 1), HistoBin1D(2, 3)});
+
+  MSG_(PAD(70) << "Checking that NaN fills throw by default: ");
+  try {
+    h.fill(nan);
+    MSG_RED("FAIL");
+    return -1;
+  } catch (const RangeError&) { }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking that gap fills are ignored by default: ");
+  h.fill(1.5, 2);
+  if (h.sumW() != 2 || h.sumW(false) != 0 || h.gapDbn().numEntries() != 0) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking NaN and gap counting: ");
+  h.reset();
+  h.setNanPolicy(FILL_COUNT);
+  h.setGapPolicy(FILL_COUNT);
+  h.fill(nan, 3);
+  h.fill(1.5, 2);
+  h.fill(0.5, 1);
+  if (h.nanDbn().sumW() != 3 || h.gapDbn().sumW() != 2 || h.sumW() != 3 || h.sumW(false) != 1) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking ignored NaNs: ");
+  h.reset();
+  h.setNanPolicy(FILL_IGNORE);
+  h.fill(nan, 3);
+  if (h.nanDbn().numEntries() != 0 || h.numEntries() != 0) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking gap throwing: ");
+  h.setGapPolicy(FILL_THROW);
+  const double nbefore = h.numEntries();
+  try {
+    h.fill(1.5);
+    MSG_RED("FAIL");
+    return -1;
+  } catch (const RangeError&) { }
+  try {
+    h.fillMany(vector<double>{1.5});
+    MSG_RED("FAIL");
+    return -1;
+  } catch (const RangeError&) { }
+  if (h.numEntries() != nbefore) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking batched fills with counting policies: ");
+  Profile1D pa(vector<double>{0, 1, 2}), pb(vector<double>{0, 1, 2});
+  pa.eraseBin(1); pb.eraseBin(1); //< the next bin then leaves a gap from 1 to 3
+  pa.addBin(3, 4); pb.addBin(3, 4);
+  pa.setNanPolicy(FILL_COUNT); pb.setNanPolicy(FILL_COUNT);
+  pa.setGapPolicy(FILL_COUNT); pb.setGapPolicy(FILL_COUNT);
+  const vector<double> xs = {0.5, nan, 1.5, 3.5, -1, 5, 2.5, 0.1};
+  const vector<double> ys = {1, 2, 3, nan, 5, 6, 7, 8};
+  for (size_t i = 0; i < xs.size(); ++i) pa.fill(xs[i], ys[i], i+1);
+  pb.fillMany(xs, ys, vector<double>{1, 2, 3, 4, 5, 6, 7, 8});
+  if (pa.nanDbn().sumW() != 6 || pb.nanDbn().sumW() != 6 ||
+      pa.gapDbn().sumW() != 10 || pb.gapDbn().sumW() != 10 ||
+      pa.sumW() != pb.sumW() || pa.sumW(false) != pb.sumW(false)) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking 2D gap counting: ");
+  Histo2D h2(vector<HistoBin2D>{HistoBin2D(0, 1, 0, 1), HistoBin2D(1, 2, 1, 2)});
+  h2.setGapPolicy(FILL_COUNT);
+  h2.fill(1.5, 0.5, 2);
+  h2.fill(0.5, 0.5, 1);
+  if (h2.gapDbn().sumW() != 2 || h2.sumW(false) != 1) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking batches of NaNs alone leave the axes unlocked: ");
+  Histo1D hn(10, 0, 10);
+  Histo2D h2n(10, 0, 10, 10, 0, 10);
+  Profile1D pn(10, 0, 10);
+  hn.setNanPolicy(FILL_COUNT); h2n.setNanPolicy(FILL_COUNT); pn.setNanPolicy(FILL_COUNT);
+  hn.fillMany(vector<double>{nan, nan});
+  h2n.fillMany(vector<double>{nan, 1}, vector<double>{1, nan});
+  pn.fillMany(vector<double>{nan, 1}, vector<double>{1, nan});
+  hn.setNanPolicy(FILL_THROW);
+  bool threw = false;
+  try {
+    hn.fillMany(vector<double>{nan});
+  } catch (const RangeError&) {
+    threw = true;
+  }
+  try {
+    hn.addBin(10, 11);
+    h2n.addBin(make_pair(10, 11), make_pair(10, 11));
+    pn.addBin(10, 11);
+  } catch (const LockError&) {
+    threw = false;
+  }
+  if (!threw || hn.numBins() != 11 || h2n.numBins() != 101 || pn.numBins() != 11 ||
+      hn.nanDbn().numEntries() != 2) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  return EXIT_SUCCESS;
+}
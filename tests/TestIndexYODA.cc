@@ -0,0 +1,160 @@
+#include "YODA/Counter.h"
+#include "YODA/ReaderYODA.h"
+#include "YODA/WriterYODA.h"
+#include "YODA/Utils/Formatting.h"
+#include "TestUtils.h"
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+using namespace YODA;
+using namespace std;
+
+
+// Whether two indexes list the same objects at the same positions
+bool sameIndex(const Index& a, const Index& b) {
+  if (a.getAOIndex() != b.getAOIndex() || a.getExtents().size() != b.getExtents().size()) return false;
+  for (const auto& path_extent : a.getExtents()) {
+    const auto it = b.getExtents().find(path_extent.first);
+    if (it == b.getExtents().end() || it->second.offset != path_extent.second.offset ||
+        it->second.length != path_extent.second.length) return false;
+  }
+  return true;
+}
+
+
+// Serialisation of the objects with @a paths, read from file @a filename without an index
+string selected(const string& filename, const vector<string>& paths) {
+  vector<AnalysisObject*> aos = ReaderYODA::create().read(filename);
+  vector<AnalysisObject*> rtn;
+  for (const string& path : paths) {
+    for (AnalysisObject*& ao : aos) {
+      if (ao && ao->path() == path) {
+        rtn.push_back(ao);
+        ao = nullptr;
+        break;
+      }
+    }
+  }
+  for (AnalysisObject* ao : aos) delete ao;
+  return writtenAndDeleted(rtn);
+}
+
+
+int main() {
+  MSG_BLUE("Testing indexed reading of YODA files: ");
+
+  Reader& reader = ReaderYODA::create();
+  const string path = YODA_TESTS_SRC "/rivetexample.yoda";
+  const string gzpath = YODA_TESTS_SRC "/test.yoda.gz";
+
+  MSG_(PAD(70) << "Checking object positions are indexed for plain files only: ");
+  const Index idx = reader.mkIndex(path);
+  ifstream in(path.c_str());
+  const Index sidx = reader.mkIndex(in);
+  const Index gzidx = reader.mkIndex(gzpath);
+  if (idx.getExtents().size() != 632 || idx.getAOIndex() != sidx.getAOIndex() || sidx.hasExtents() ||
+      gzidx.hasExtents() || gzidx.getAOIndex().at("Histo1D").size() != 2) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking single objects are read as by full reads: ");
+  const vector<string> paths = { "/DELPHI_1996_S3430090/d35-x01-y01", "/ALEPH_1991_S2435284/d01-x01-y01",
+                                 "/nosuchpath", "/DELPHI_1996_S3430090/d35-x01-y01", "/MC_JETS/jet_HT" };
+  AnalysisObject* ao = reader.readObject(path, "/ALEPH_1991_S2435284/d02-x01-y01");
+  if (!ao || writtenAndDeleted({ao}) != selected(path, {"/ALEPH_1991_S2435284/d02-x01-y01"}) ||
+      reader.readObject(path, "/nosuchpath") != nullptr ||
+      writtenAndDeleted(reader.readObjects(path, paths)) != selected(path, paths) ||
+      writtenAndDeleted(reader.readObjects(gzpath, {"/some/other/histo", "/Myhisto1"})) != selected(gzpath, {"/some/other/histo", "/Myhisto1"})) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking large enough files are written with a sidecar index: ");
+  const string outpath = "testindexyoda.yoda", idxpath = ReaderYODA::indexFilename(outpath);
+  remove(idxpath.c_str());
+  vector<AnalysisObject*> aos = reader.read(path);
+  Writer& writer = WriterYODA::create();
+  writer.write(outpath, aos);
+  const bool byDefault = bool(ifstream(idxpath.c_str()));
+  writer.setIndexThreshold(1 << 30);
+  writer.write(outpath, aos);
+  if (byDefault || ifstream(idxpath.c_str())) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  writer.setIndexThreshold(1);
+  writer.write(outpath, aos);
+  writer.setIndexThreshold(0);
+  const string sidecar = [&]{ ifstream f(idxpath.c_str()); ostringstream os; os << f.rdbuf(); return os.str(); }();
+  const Index loaded = reader.mkIndex(outpath);
+  remove(idxpath.c_str());
+  const Index scanned = reader.mkIndex(outpath);
+  ofstream(idxpath.c_str()) << sidecar;
+  if (sidecar.empty() || !scanned.hasExtents() || !sameIndex(loaded, scanned) ||
+      writtenAndDeleted(reader.readObjects(outpath, paths)) != selected(outpath, paths)) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  // A doctored index is believed while the file is unchanged, and ignored after
+  MSG_(PAD(70) << "Checking sidecar indexes are used only while up to date: ");
+  const string target = "/ALEPH_1991_S2435284/d01-x01-y01";
+  const size_t ipath = sidecar.find(" Histo1D " + target + "\n");
+  const size_t inbins = sidecar.rfind(' ', ipath - 1);
+  ofstream(idxpath.c_str()) << sidecar.substr(0, inbins) << " 9999" << sidecar.substr(ipath);
+  const bool used = reader.mkIndex(outpath).getAOIndex().at("Histo1D").at(target) == 9999;
+  ofstream(outpath.c_str(), ios::app) << "\n";
+  const int nbins = reader.mkIndex(outpath).getAOIndex().at("Histo1D").at(target);
+  writer.setIndexThreshold(1 << 30);
+  writer.write(outpath, aos);
+  if (ipath == string::npos || !used || nbins != idx.getAOIndex().at("Histo1D").at(target) ||
+      ifstream(idxpath.c_str())) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking other files named like sidecar indexes are kept: ");
+  ofstream(idxpath.c_str()) << "not an index\n";
+  writer.write(outpath, aos);
+  writer.setIndexThreshold(0);
+  const string kept = [&]{ ifstream f(idxpath.c_str()); ostringstream os; os << f.rdbuf(); return os.str(); }();
+  if (kept != "not an index\n") {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking failed writes leave no positions for the next index: ");
+  Counter unwritable("/unwritable");
+  unwritable.setAnnotation("Type", "Unwritable");
+  vector<AnalysisObject*> badaos(aos.begin(), aos.end());
+  badaos.push_back(&unwritable);
+  writer.setIndexThreshold(1);
+  bool threw = false;
+  try {
+    writer.write(outpath, badaos);
+  } catch (const Exception&) {
+    threw = true;
+  }
+  ostringstream notindexed;
+  writer.write(notindexed, aos);
+  writer.write(outpath, vector<AnalysisObject*>(aos.begin() + aos.size()/2, aos.end()));
+  writer.setIndexThreshold(0);
+  const Index reloaded = reader.mkIndex(outpath);
+  remove(idxpath.c_str());
+  if (!threw || !sameIndex(reloaded, reader.mkIndex(outpath))) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  for (AnalysisObject* ao : aos) delete ao;
+  remove(idxpath.c_str());
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,153 @@
+#include "YODA/Merge.h"
+#include "YODA/Counter.h"
+#include "YODA/Histo1D.h"
+#include "YODA/Profile1D.h"
+#include "YODA/Scatter2D.h"
+#include "YODA/ReaderYODA.h"
+#include "YODA/WriterYODA.h"
+#include "YODA/Utils/Formatting.h"
+#include "TestUtils.h"
+#include <sstream>
+#include <vector>
+
+using namespace YODA;
+using namespace std;
+
+
+int main() {
+  MSG_BLUE("Testing merging of analysis objects: ");
+
+  // Runs with normalised and unnormalised objects, a scatter, and a type clash
+  const size_t nruns = 13;
+  vector< vector<AnalysisObject*> > runs(nruns);
+  Histo1D href(20, 0, 10, "/h", "Merge");
+  Profile1D pref(10, 0, 10, "/p", "Merge");
+  double sum_sfs = 0;
+  for (size_t n = 0; n < nruns; ++n) {
+    Histo1D* h = new Histo1D(20, 0, 10, "/h", "Merge");
+    Profile1D* p = new Profile1D(10, 0, 10, "/p", "Merge");
+    Counter* c = new Counter("/c", "Merge");
+    for (size_t i = 0; i < 1000; ++i) {
+      const double x = randomCoord();
+      const double w = randomWeight();
+      h->fill(x, w);
+      p->fill(x, x*w, w);
+      c->fill(w);
+    }
+    href += *h;
+    pref += *p;
+    const double sf = 0.5 + n;
+    h->scaleW(sf);
+    sum_sfs += 1/sf;
+    Scatter2D* s = new Scatter2D("/s", "Merge");
+    s->addPoint(1.0, n, 0.5, 0.5, 0.1, 0.2);
+    s->addPoint(2.0, 2*n, 0.5, 0.5, 0.3, 0.4);
+    AnalysisObject* m = (n == 0) ? static_cast<AnalysisObject*>(new Counter("/m", "Merge")) : new Histo1D(5, 0, 1, "/m", "Merge");
+    runs[n] = {h, p, c, s, m};
+  }
+  href.scaleW(1/sum_sfs);
+  const string inputs = written(runs[nruns-1]);
+
+  MSG_(PAD(70) << "Checking normalised histograms are averaged: ");
+  vector<AnalysisObject*> merged = merge(runs, 4);
+  if (merged.size() != 5 || merged[0]->path() != "/h" || merged[0]->type() != "Histo1D") {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  const Histo1D& hm = dynamic_cast<const Histo1D&>(*merged[0]);
+  bool ok = fuzzyEquals(hm.annotation<double>("ScaledBy"), 1/sum_sfs);
+  for (size_t i = 0; ok && i < href.numBins(); ++i) {
+    ok = fuzzyEquals(hm.bin(i).sumW(), href.bin(i).sumW()) && fuzzyEquals(hm.bin(i).sumW2(), href.bin(i).sumW2()) &&
+      hm.bin(i).numEntries() == href.bin(i).numEntries();
+  }
+  if (!ok) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking unnormalised profiles are summed: ");
+  const Profile1D& pm = dynamic_cast<const Profile1D&>(*merged[1]);
+  for (size_t i = 0; ok && i < pref.numBins(); ++i) {
+    ok = fuzzyEquals(pm.bin(i).sumWY(), pref.bin(i).sumWY()) && pm.bin(i).numEntries() == pref.bin(i).numEntries();
+  }
+  if (!ok || pm.hasAnnotation("ScaledBy")) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking scatters are averaged and type clashes skipped: ");
+  const Scatter2D& sm = dynamic_cast<const Scatter2D&>(*merged[3]);
+  if (!fuzzyEquals(sm.point(1).y(), nruns-1.0) || !fuzzyEquals(sm.point(0).yErrPlus(), 0.2*sqrt(nruns)/nruns) ||
+      merged[4]->type() != "Counter" || dynamic_cast<const Counter&>(*merged[4]).numEntries() != 0) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking the result does not depend on the number of threads: ");
+  vector<AnalysisObject*> merged1 = merge(runs, 1);
+  if (written(merged1) != written(merged) || written(runs[nruns-1]) != inputs) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking incremental merging matches the tree merge: ");
+  Merger merger;
+  for (const vector<AnalysisObject*>& aos : runs) {
+    for (const AnalysisObject* ao : aos) merger.add(ao->newclone());
+  }
+  vector<AnalysisObject*> mergedinc = merger.result();
+  const Histo1D& hi = dynamic_cast<const Histo1D&>(*mergedinc[0]);
+  ok = mergedinc.size() == merged.size() && merger.size() == 0;
+  for (size_t i = 0; ok && i < href.numBins(); ++i) {
+    ok = fuzzyEquals(hi.bin(i).sumW(), hm.bin(i).sumW()) && hi.bin(i).numEntries() == hm.bin(i).numEntries();
+  }
+  for (size_t i = 0; ok && i < mergedinc.size(); ++i) {
+    ok = mergedinc[i]->path() == merged[i]->path() && mergedinc[i]->type() == merged[i]->type();
+  }
+  if (!ok) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking merging whole runs in parallel matches single adds: ");
+  Merger single, batched;
+  size_t nadded = 0;
+  for (const vector<AnalysisObject*>& aos : runs) {
+    for (const AnalysisObject* ao : aos) single.add(*ao);
+    nadded += batched.add(aos, 4);
+  }
+  vector<AnalysisObject*> mergedsingle = single.result(), mergedbatch = batched.result();
+  if (nadded != 4*nruns + 1 || written(mergedbatch) != written(mergedsingle) || written(runs[nruns-1]) != inputs) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking streaming merging of files matches merging their contents: ");
+  const vector<string> files = { YODA_TESTS_SRC "/test1.yoda", YODA_TESTS_SRC "/test2.yoda", YODA_TESTS_SRC "/test.yoda.gz" };
+  vector<AnalysisObject*> mergedfiles = mergeFiles(files);
+  vector< vector<AnalysisObject*> > contents;
+  for (const string& file : files) contents.push_back(ReaderYODA::create().read(file));
+  vector<AnalysisObject*> mergedcontents = merge(contents);
+  if (mergedfiles.empty() || written(mergedfiles) != written(mergedcontents)) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  for (vector<AnalysisObject*>* aos : {&merged, &merged1, &mergedinc, &mergedsingle, &mergedbatch, &mergedfiles, &mergedcontents}) {
+    for (AnalysisObject* ao : *aos) delete ao;
+  }
+  for (vector<AnalysisObject*>& aos : contents) {
+    for (AnalysisObject* ao : aos) delete ao;
+  }
+  for (vector<AnalysisObject*>& aos : runs) {
+    for (AnalysisObject* ao : aos) delete ao;
+  }
+  return EXIT_SUCCESS;
+}
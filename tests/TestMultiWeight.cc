@@ -0,0 +1,108 @@
+#include "YODA/MultiCounter.h"
+#include "YODA/MultiHisto1D.h"
+#include "YODA/MultiHisto2D.h"
+#include "YODA/MultiProfile1D.h"
+#include "YODA/ReaderYODA.h"
+#include "YODA/WriterYODA.h"
+#include "YODA/Utils/Formatting.h"
+#include "TestUtils.h"
+#include <sstream>
+#include <vector>
+
+using namespace YODA;
+using namespace std;
+
+
+int main() {
+  MSG_BLUE("Testing multi-weight analysis objects: ");
+
+  const vector<string> streams = {"", "MUR2", "MUR0.5", "PDF1"};
+  const size_t nstreams = streams.size();
+
+  Counter c[4];
+  Histo1D h1[4], ph1 = Histo1D(20, 0, 10, "/h1", "Multi");
+  Histo2D h2[4];
+  Profile1D p1[4];
+  for (size_t i = 0; i < nstreams; ++i) {
+    c[i] = Counter("/c" + (streams[i].empty() ? "" : "[" + streams[i] + "]"), "Multi");
+    h1[i] = Histo1D(ph1, "/h1" + (streams[i].empty() ? "" : "[" + streams[i] + "]"));
+    h2[i] = Histo2D(10, 0, 10, 5, 0, 10, "/h2" + (streams[i].empty() ? "" : "[" + streams[i] + "]"), "Multi");
+    p1[i] = Profile1D(10, 0, 10, "/p1" + (streams[i].empty() ? "" : "[" + streams[i] + "]"), "Multi");
+  }
+  MultiCounter mc(streams, "/c", "Multi");
+  MultiHisto1D mh1(streams, ph1);
+  MultiHisto2D mh2(streams, 10, 0, 10, 5, 0, 10, "/h2", "Multi");
+  MultiProfile1D mp1(streams, 10, 0, 10, "/p1", "Multi");
+
+  for (size_t n = 0; n < 5000; ++n) {
+    const double x = randomCoord();
+    const double y = randomCoord();
+    vector<double> ws(nstreams);
+    ws[0] = (n % 3 == 0) ? 1.0 : randomWeight();
+    for (size_t i = 1; i < nstreams; ++i) ws[i] = ws[0] * (0.5 + (rand()/static_cast<double>(RAND_MAX)));
+    for (size_t i = 0; i < nstreams; ++i) {
+      c[i].fill(ws[i]);
+      h1[i].fill(x, ws[i]);
+      h2[i].fill(x, y, ws[i]);
+      p1[i].fill(x, y, ws[i]);
+    }
+    mc.fill(ws);
+    mh1.fill(x, ws);
+    mh2.fill(x, y, ws);
+    mp1.fill(x, y, ws);
+  }
+
+  MSG_(PAD(70) << "Checking each stream matches a separately filled object: ");
+  for (size_t i = 0; i < nstreams; ++i) {
+    if (written(mc.counter(i)) != written(c[i]) || written(mh1.histo(i)) != written(h1[i]) ||
+        written(mh2.histo(i)) != written(h2[i]) || written(mp1.profile(i)) != written(p1[i])) {
+      MSG_RED("FAIL");
+      return -1;
+    }
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking scaling and combination per stream: ");
+  MultiHisto1D mh1b(mh1);
+  mh1b += mh1;
+  mh1b.scaleW(2, 0.25);
+  Histo1D h1b = h1[2] + h1[2];
+  h1b.scaleW(0.25);
+  MultiCounter mcb(mc);
+  mcb.scaleW(0, 3);
+  Counter cb = c[0];
+  cb.scaleW(3);
+  if (written(mh1b.histo(2)) != written(h1b) || written(mh1b.histo(1)) != written(Histo1D(h1[1] + h1[1], "/h1[MUR2]")) ||
+      written(mcb.counter(0)) != written(cb) || (mh1b += mh1).histo(2).hasAnnotation("ScaledBy")) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking a multi-weight histogram is written as one object per stream: ");
+  ostringstream os;
+  WriterYODA::write(os, mh1);
+  istringstream is(os.str());
+  vector<AnalysisObject*> aos = ReaderYODA::create().read(is);
+  bool ok = aos.size() == nstreams;
+  for (size_t i = 0; ok && i < nstreams; ++i) {
+    ok = aos[i]->path() == h1[i].path() && aos[i]->type() == "Histo1D";
+  }
+  for (AnalysisObject* ao : aos) delete ao;
+  if (!ok) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking a fill with the wrong number of weights throws: ");
+  try {
+    mh1.fill(1.0, vector<double>(nstreams+1, 1.0));
+    MSG_RED("FAIL");
+    return -1;
+  } catch (const WeightError&) {
+    MSG_GREEN("PASS");
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,269 @@
+#include "YODA/ReaderYODA.h"
+#include "YODA/WriterYODA.h"
+#include "YODA/Counter.h"
+#include "YODA/Utils/Formatting.h"
+#include "TestUtils.h"
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace YODA;
+using namespace std;
+
+
+// Contents of a file
+string slurp(const string& filename) {
+  ifstream in(filename.c_str(), ios::binary);
+  ostringstream os;
+  os << in.rdbuf();
+  return os.str();
+}
+
+
+// Text with its LF line endings replaced by @a eol
+string withEndings(const string& text, const string& eol) {
+  string rtn;
+  for (char c : text) {
+    if (c == '\n') rtn += eol;
+    else rtn += c;
+  }
+  return rtn;
+}
+
+
+// Serialisation of the objects read from @a is or file @a filename on
+// @a nthreads threads, followed by the error message if reading fails,
+// optionally selecting objects by path regexes while reading
+string readWith(istream* is, const string& filename, size_t nthreads,
+                const vector<string>& patts={}, const vector<string>& unpatts={}) {
+  Reader& reader = ReaderYODA::create();
+  vector<AnalysisObject*> aos;
+  string err;
+  try {
+    if (is) reader.read(*is, aos, patts, unpatts, nthreads);
+    else reader.read(filename, aos, patts, unpatts, nthreads);
+  } catch (const ReadError& e) {
+    err = e.what();
+  }
+  return writtenAndDeleted(aos) + err;
+}
+
+
+// Serialisation of the objects read from @a text through a stream
+string readText(const string& text, size_t nthreads=1) {
+  istringstream is(text);
+  return readWith(&is, "", nthreads);
+}
+
+
+// Serialisation of the objects read from @a text written to a file
+string readFile(const string& text, size_t nthreads=1) {
+  ofstream("testreadyoda.yoda", ios::binary) << text;
+  return readWith(0, "testreadyoda.yoda", nthreads);
+}
+
+
+// Serialisation of the objects read from @a text and then selected by path regexes
+string selected(const string& text, const vector<string>& patts, const vector<string>& unpatts) {
+  const Reader::PathFilter filter = Reader::mkPathFilter(patts, unpatts);
+  istringstream is(text);
+  vector<AnalysisObject*> aos, rtn;
+  ReaderYODA::create().read(is, aos);
+  for (AnalysisObject* ao : aos) {
+    if (!filter || filter(ao->path())) rtn.push_back(ao);
+    else delete ao;
+  }
+  return writtenAndDeleted(rtn);
+}
+
+
+int main() {
+  MSG_BLUE("Testing the equivalence of the YODA reading paths: ");
+
+  const vector<string> files = { "test.yoda", "test1.yoda", "rivetexample.yoda", "iofilter.yoda" };
+  for (const string& file : files) {
+    const string path = YODA_TESTS_SRC "/" + file;
+    MSG_(PAD(70) << "Checking all reading paths agree for " + file + ": ");
+    const string text = slurp(path);
+    const string ref = readText(text);
+    if (ref.empty() || writtenAndDeleted(ReaderYODA::create().read(path)) != ref ||
+        readText(withEndings(text, "\r\n")) != ref || readFile(withEndings(text, "\r")) != ref) {
+      MSG_RED("FAIL");
+      return -1;
+    }
+    MSG_GREEN("PASS");
+  }
+
+  // Enough copies for lines, and CRLF pairs, to straddle the stream chunks
+  MSG_(PAD(70) << "Checking reads of inputs spanning many buffer chunks: ");
+  const string text = slurp(YODA_TESTS_SRC "/rivetexample.yoda");
+  string big;
+  while (big.size() < (3 << 20)) big += text;
+  const string ref = readFile(big);
+  if (ref.empty() || readText(big) != ref || readText(withEndings(big, "\r\n")) != ref) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking a final line without a line ending: ");
+  string unended = text;
+  while (!unended.empty() && (unended.back() == '\n' || unended.back() == '\r')) unended.pop_back();
+  if (readFile(unended) != readText(text) || readText(unended) != readText(text)) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking parallel reads match sequential ones: ");
+  for (size_t nthreads : {0, 2, 3, 8}) {
+    if (readFile(big, nthreads) != ref || readText(withEndings(big, "\r\n"), nthreads) != ref ||
+        readText(unended, nthreads) != readText(text)) {
+      MSG_RED("FAIL");
+      return -1;
+    }
+    const string gzpath = YODA_TESTS_SRC "/test.yoda.gz";
+    if (readWith(0, gzpath, nthreads) != readWith(0, gzpath, 1)) {
+      MSG_RED("FAIL");
+      return -1;
+    }
+  }
+  MSG_GREEN("PASS");
+
+  // The thread count is per call, so concurrent reads of the shared reader don't interfere
+  MSG_(PAD(70) << "Checking concurrent reads with different thread counts: ");
+  vector<AnalysisObject*> seqaos, paraos;
+  thread tseq([&]{ istringstream is(big); ReaderYODA::create().read(is, seqaos, {}, {}, 1); });
+  thread tpar([&]{ istringstream is(big); ReaderYODA::create().read(is, paraos, {}, {}, 4); });
+  tseq.join();
+  tpar.join();
+  if (writtenAndDeleted(seqaos) != ref || writtenAndDeleted(paraos) != ref) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  // Errors part-way through, which must leave the same objects read and the same message
+  MSG_(PAD(70) << "Checking parallel reads fail as sequential ones: ");
+  const string bad1 = big + "garbage\n" + big;
+  const string bad2 = big + "BEGIN YODA_HISTO2D_V2 /bad\n---\nUnderflow 0 0 0 0 0 0 0 0 0\nEND YODA_HISTO2D_V2\n" + big;
+  const string bad3 = big + "BEGIN YODA_HISTO1D_V2 /bad\nBEGIN YODA_HISTO1D_V2 /bad\n" + big;
+  for (const string& bad : {bad1, bad2, bad3}) {
+    const string seq = readText(bad);
+    if (seq.find("BEGIN") == string::npos || seq == ref || readText(bad, 4) != seq || readFile(bad, 4) != seq) {
+      MSG_RED("FAIL");
+      return -1;
+    }
+  }
+  MSG_GREEN("PASS");
+
+  // Selections with patterns and unpatterns, in both block formats
+  MSG_(PAD(70) << "Checking path-selected reads match selecting after reading: ");
+  const string v1text = slurp(YODA_TESTS_SRC "/iofilter.yoda");
+  const vector< vector<string> > selections = { {"jet_", "ALEPH"}, {"_[12]$", "d01-"}, {"nothing"} };
+  const vector< vector<string> > unselections = { {}, {"^/RAW/", "eta", "1995"} };
+  for (const vector<string>& patts : selections) {
+    for (const vector<string>& unpatts : unselections) {
+      for (const string& t : {v1text, text}) {
+        const string sel = selected(t, patts, unpatts);
+        istringstream is(t), is2(t);
+        if (readWith(&is, "", 1, patts, unpatts) != sel || readWith(&is2, "", 1, {}, unpatts) != selected(t, {}, unpatts)) {
+          MSG_RED("FAIL");
+          return -1;
+        }
+        ofstream("testreadyoda.yoda", ios::binary) << t;
+        if (readWith(0, "testreadyoda.yoda", 1, patts, unpatts) != sel ||
+            readWith(0, "testreadyoda.yoda", 3, patts, unpatts) != sel) {
+          MSG_RED("FAIL");
+          return -1;
+        }
+      }
+    }
+  }
+  MSG_GREEN("PASS");
+
+  // Unselected blocks are skipped without their contents being parsed
+  MSG_(PAD(70) << "Checking unselected blocks are skipped unparsed: ");
+  const vector<string> notbad = {"^/bad$"};
+  const string badtext = text + "BEGIN YODA_HISTO2D_V2 /bad\n---\nUnderflow 0 0 0 0 0 0 0 0 0\nEND YODA_HISTO2D_V2\n" + text;
+  for (size_t nthreads : {1, 4}) {
+    istringstream is(badtext);
+    if (readWith(&is, "", nthreads, {}, notbad) != selected(text + text, {}, notbad)) {
+      MSG_RED("FAIL");
+      return -1;
+    }
+  }
+  MSG_GREEN("PASS");
+
+  // Simple annotations are split directly, and must come out as through the YAML parser
+  MSG_(PAD(70) << "Checking simple annotations are read as by YAML: ");
+  const string anns = "Title: \nXLabel: $p_\\perp^{\\text{jet}}$ [GeV]\nA: -1.5e3\nB:   true  \nC: null\n"
+                      "D: it's \"quoted\"\nE: x#y, z:w\nF:\nG: 100%\nA: again";
+  const string counter = "BEGIN YODA_COUNTER_V2 /c\nPath: /c\nType: Counter\n" + anns +
+                         "\n---\n# sumW\t sumW2\t numEntries\n1 1 1\nEND YODA_COUNTER_V2\n";
+  const string yamlcounter = string(counter).insert(counter.find(anns), "List: [1, 2]\n");
+  istringstream is(counter), yamlis(yamlcounter);
+  vector<AnalysisObject*> fast = ReaderYODA::create().read(is), full = ReaderYODA::create().read(yamlis);
+  if (fast.size() != 1 || full.size() != 1 || full[0]->annotation("List") != "[1, 2]" ||
+      fast[0]->annotation("Title") != "~" || fast[0]->annotation("A") != "again") {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  full[0]->rmAnnotation("List");
+  if (writtenAndDeleted(fast) != writtenAndDeleted(full)) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  // Numbers are parsed as by strtod, so that they round-trip exactly at full precision
+  MSG_(PAD(70) << "Checking numbers are read correctly rounded at all precisions: ");
+  mt19937_64 rng(1234);
+  vector<Counter> counters;
+  for (int i = 0; i < 1000; ++i) {
+    double val[3];
+    for (double& v : val) {
+      do {
+        const uint64_t bits = rng() >> (i % 2 ? 0 : 12); //< also including subnormals
+        memcpy(&v, &bits, sizeof(v));
+      } while (!std::isfinite(v));
+    }
+    counters.push_back(Counter(Dbn0D(val[0], val[1], val[2]), "/numbers/" + Utils::toStr(i)));
+  }
+  vector<const Counter*> cptrs;
+  for (const Counter& c : counters) cptrs.push_back(&c);
+  Writer& writer = WriterYODA::create();
+  const int prevprecision = writer.precision();
+  for (int prec = 0; prec <= 20; ++prec) {
+    ostringstream os;
+    writer.setPrecision(prec);
+    writer.write(os, cptrs);
+    writer.setPrecision(prevprecision);
+    istringstream is(os.str());
+    vector<AnalysisObject*> aos = ReaderYODA::create().read(is);
+    bool ok = aos.size() == counters.size();
+    for (size_t i = 0; ok && i < aos.size(); ++i) {
+      const Counter* c = dynamic_cast<const Counter*>(aos[i]);
+      const double vals1[] = { counters[i].sumW(), counters[i].sumW2(), counters[i].numEntries() };
+      const double vals2[] = { c ? c->sumW() : 0, c ? c->sumW2() : 0, c ? c->numEntries() : 0 };
+      for (size_t j = 0; j < 3; ++j) {
+        ostringstream vs;
+        vs << scientific << showpoint << setprecision(prec) << vals1[j];
+        const double expected = prec >= 16 ? vals1[j] : strtod(vs.str().c_str(), nullptr);
+        ok &= c && memcmp(&vals2[j], &expected, sizeof(double)) == 0;
+      }
+    }
+    for (AnalysisObject* ao : aos) delete ao;
+    if (!ok) {
+      MSG_RED("FAIL");
+      return -1;
+    }
+  }
+  MSG_GREEN("PASS");
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,175 @@
+#include "YODA/Sharded.h"
+#include "YODA/Counter.h"
+#include "YODA/Histo1D.h"
+#include "YODA/Histo2D.h"
+#include "YODA/Profile1D.h"
+#include "YODA/Profile2D.h"
+#include "YODA/Utils/Formatting.h"
+#include <thread>
+#include <vector>
+
+using namespace YODA;
+using namespace std;
+
+
+/// Random fill coordinates for NTHREADS threads of NPERTHREAD fills each
+const size_t NTHREADS = 4, NPERTHREAD = 20000;
+vector<double> xs, ys, zs, wts;
+
+
+/// Fill each of the sharded objects from a pool of threads, each with its own slice of the coordinates
+void fillSharded(Sharded<Counter>& c, Sharded<Histo1D>& h1, Sharded<Histo2D>& h2,
+                 Sharded<Profile1D>& p1, Sharded<Profile2D>& p2) {
+  vector<thread> threads;
+  for (size_t t = 0; t < NTHREADS; ++t) {
+    threads.push_back(thread([&, t] {
+          for (size_t i = t*NPERTHREAD; i < (t+1)*NPERTHREAD; ++i) {
+            c.fill(wts[i]);
+            h1.fill(xs[i], wts[i]);
+            h2.fill(xs[i], ys[i], wts[i]);
+            p1.fill(xs[i], zs[i], wts[i]);
+            p2.fill(xs[i], ys[i], zs[i], wts[i]);
+          }
+        }));
+  }
+  for (thread& t : threads) t.join();
+}
+
+
+int main() {
+  MSG_BLUE("Testing thread-sharded fills: ");
+  for (size_t i = 0; i < NTHREADS*NPERTHREAD; ++i) {
+    xs.push_back(-10 + 120*(rand()/static_cast<double>(RAND_MAX)));
+    ys.push_back(-10 + 120*(rand()/static_cast<double>(RAND_MAX)));
+    zs.push_back(rand()/static_cast<double>(RAND_MAX));
+    wts.push_back(rand()/static_cast<double>(RAND_MAX));
+  }
+
+  // Serial reference fills, with one prior fill of the booked objects
+  Counter c("/c");
+  Histo1D h1(20, 0, 100, "/h1");
+  Histo2D h2(20, 0, 100, 10, 0, 100, "/h2");
+  Profile1D p1(20, 0, 100, "/p1");
+  Profile2D p2(20, 0, 100, 10, 0, 100, "/p2");
+  c.fill(2); h1.fill(50, 2); h2.fill(50, 50, 2); p1.fill(50, 0.5, 2); p2.fill(50, 50, 0.5, 2);
+  Sharded<Counter> sc(c), sc2(c);
+  Sharded<Histo1D> sh1(h1), sh12(h1);
+  Sharded<Histo2D> sh2(h2), sh22(h2);
+  Sharded<Profile1D> sp1(p1), sp12(p1);
+  Sharded<Profile2D> sp2(p2), sp22(p2);
+  for (size_t i = 0; i < NTHREADS*NPERTHREAD; ++i) {
+    c.fill(wts[i]);
+    h1.fill(xs[i], wts[i]);
+    h2.fill(xs[i], ys[i], wts[i]);
+    p1.fill(xs[i], zs[i], wts[i]);
+    p2.fill(xs[i], ys[i], zs[i], wts[i]);
+  }
+
+  MSG_(PAD(70) << "Checking that each thread fills its own replica: ");
+  fillSharded(sc, sh1, sh2, sp1, sp2);
+  if (sc.numShards() != NTHREADS || sh1.numShards() != NTHREADS || sp2.numShards() != NTHREADS) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking that merged replicas agree with serial fills: ");
+  const Counter mc = sc.merged();
+  const Histo1D mh1 = sh1.merged();
+  const Histo2D mh2 = sh2.merged();
+  const Profile1D mp1 = sp1.merged();
+  const Profile2D mp2 = sp2.merged();
+  bool ok = mh1.path() == "/h1" && mc.numEntries() == c.numEntries() && fuzzyEquals(mc.sumW(), c.sumW());
+  ok &= mh1.numEntries() == h1.numEntries() && fuzzyEquals(mh1.sumW(), h1.sumW());
+  ok &= mh2.numEntries() == h2.numEntries() && fuzzyEquals(mh2.sumW(), h2.sumW());
+  ok &= mp1.numEntries() == p1.numEntries() && fuzzyEquals(mp1.sumW(), p1.sumW());
+  ok &= mp2.numEntries() == p2.numEntries() && fuzzyEquals(mp2.sumW(), p2.sumW());
+  for (size_t i = 0; i < h1.numBins(); ++i) {
+    ok &= fuzzyEquals(mh1.bin(i).sumW(), h1.bin(i).sumW()) && fuzzyEquals(mp1.bin(i).mean(), p1.bin(i).mean());
+  }
+  for (size_t i = 0; i < h2.numBins(); ++i) {
+    ok &= fuzzyEquals(mh2.bin(i).sumW(), h2.bin(i).sumW()) && fuzzyEquals(mp2.bin(i).mean(), p2.bin(i).mean());
+  }
+  if (!ok) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  // Per-thread replicas merge in order of creation, so only repeated merges agree exactly
+  MSG_(PAD(70) << "Checking that merges are reproducible: ");
+  fillSharded(sc2, sh12, sh22, sp12, sp22);
+  ok = sc2.merged().sumW() == sc2.merged().sumW() && fuzzyEquals(sc2.merged().sumW(), mc.sumW());
+  const Histo1D mh12 = sh12.merged(), mh12b = sh12.merged();
+  const Histo2D mh22 = sh22.merged(), mh22b = sh22.merged();
+  const Profile1D mp12 = sp12.merged(), mp12b = sp12.merged();
+  for (size_t i = 0; i < h1.numBins(); ++i) {
+    ok &= mh12.bin(i).sumW() == mh12b.bin(i).sumW() && mp12.bin(i).sumWY() == mp12b.bin(i).sumWY();
+    ok &= fuzzyEquals(mh12.bin(i).sumW(), mh1.bin(i).sumW());
+  }
+  for (size_t i = 0; i < h2.numBins(); ++i) ok &= mh22.bin(i).sumW2() == mh22b.bin(i).sumW2();
+  if (!ok) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  // Indexed workers merge in index order, whatever order they were filled in
+  MSG_(PAD(70) << "Checking that indexed workers merge independently of the schedule: ");
+  const Histo1D hw(20, 0, 100, "/hw");
+  Sharded<Histo1D> shw1(hw, NTHREADS), shw2(hw, NTHREADS);
+  vector<thread> workers;
+  for (size_t t = 0; t < NTHREADS; ++t) {
+    workers.push_back(thread([&, t] {
+          for (size_t i = t*NPERTHREAD; i < (t+1)*NPERTHREAD; ++i) shw1.local(t).fill(xs[i]);
+        }));
+  }
+  for (thread& t : workers) t.join();
+  for (size_t t = NTHREADS; t-- > 0; ) {
+    for (size_t i = t*NPERTHREAD; i < (t+1)*NPERTHREAD; ++i) shw2.local(t).fill(xs[i]);
+  }
+  const Histo1D mw1 = shw1.merged(), mw2 = shw2.merged();
+  ok = shw1.numWorkers() == NTHREADS && shw1.numShards() == 0 && mw1.numEntries() == NTHREADS*NPERTHREAD;
+  for (size_t i = 0; i < hw.numBins(); ++i) ok &= mw1.bin(i).sumWX() == mw2.bin(i).sumWX();
+  try {
+    shw1.local(NTHREADS);
+    ok = false;
+  } catch (const RangeError&) { }
+  if (!ok) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking that a reused slot gets a fresh replica: ");
+  {
+    Sharded<Counter> tmp(c);
+    tmp.fill(1);
+  }
+  Sharded<Counter> sc3(c);
+  sc3.fill(1);
+  if (sc3.numShards() != 1 || sc3.merged().numEntries() != c.numEntries() + 1) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking that pending auto-binning is rejected: ");
+  Histo1D ha(10, AUTOBIN_LIN);
+  try {
+    Sharded<Histo1D> sha(ha);
+    MSG_RED("FAIL");
+    return -1;
+  } catch (const UserError&) { }
+  MSG_GREEN("PASS");
+
+  MSG_(PAD(70) << "Checking that reset empties all replicas: ");
+  sh1.reset();
+  if (sh1.merged().numEntries() != 0 || sh1.numShards() != NTHREADS) {
+    MSG_RED("FAIL");
+    return -1;
+  }
+  MSG_GREEN("PASS");
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,65 @@
+// -*- C++ -*-
+//
+// This file is part of YODA -- Yet more Objects for Data Analysis
+// Copyright (C) 2008-2021 The YODA collaboration (see AUTHORS for details)
+//
+#ifndef YODA_TestUtils_h
+#define YODA_TestUtils_h
+
+#include "YODA/AnalysisObject.h"
+#include "YODA/WriterYODA.h"
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+/// @brief Exact serialisation of @a aos via the highest-precision YODA format
+///
+/// @a aos is anything the writer accepts, e.g. an AnalysisObject or a vector
+/// of pointers to them. The writer's previous precision is restored after.
+template <typename T>
+inline std::string written(const T& aos) {
+  std::ostringstream os;
+  YODA::Writer& writer = YODA::WriterYODA::create();
+  const int prevprecision = writer.precision();
+  writer.setPrecision(17);
+  try {
+    writer.write(os, aos);
+  } catch (...) {
+    writer.setPrecision(prevprecision);
+    throw;
+  }
+  writer.setPrecision(prevprecision);
+  return os.str();
+}
+
+
+/// Exact serialisation of the newly read objects @a aos, which are then deleted
+inline std::string writtenAndDeleted(const std::vector<YODA::AnalysisObject*>& aos) {
+  const std::string rtn = written(aos);
+  for (YODA::AnalysisObject* ao : aos) delete ao;
+  return rtn;
+}
+
+
+/// Exact comparison via the highest-precision YODA serialisation
+inline bool sameContent(const YODA::AnalysisObject& a, const YODA::AnalysisObject& b) {
+  return written(a) == written(b);
+}
+
+
+/// Random fill coordinate in [-2, 12], covering [0, 10) axes and both their outflows
+inline double randomCoord() {
+  return -2 + 14*(rand()/static_cast<double>(RAND_MAX));
+}
+
+
+
+/// Random fill weight in [-0.5, 1.5], including negative weights
+inline double randomWeight() {
+  return -0.5 + 2*(rand()/static_cast<double>(RAND_MAX));
+}
+
+
+#endif
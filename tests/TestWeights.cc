@@ -1,5 +1,7 @@
 #include "YODA/Weights.h"
 #include <iostream>
+#include <algorithm>
+#include <iterator>
 
 using namespace std;
 using namespace YODA;
@@ -43,5 +45,33 @@ int main() {
   foo(5);
   foo(Weights(6));
 
+  // Weights with the same keys share one schema, whatever the key order
+  vector<string> rkeys(keys.rbegin(), keys.rend());
+  Weights w5(rkeys, vector<double>{1.0, 2.0, 3.0});
+  cout << "W5 = " << w5 << endl;
+  if (w5.schema() != w1.schema() || w5["FOO"] != 3.0 || w5[0] != 2.0 || w5.keys()[0] != "BAR") return 1;
+  for (Weights::iterator i = w5.begin(); i != w5.end(); ++i) i->second *= 2;
+  if (w5 != Weights(w5.schema(), vector<double>{4.0, 2.0, 6.0})) return 1;
+
+  // The iterators work with the standard algorithms
+  const Weights& cw5 = w5;
+  if (distance(cw5.begin(), cw5.end()) != 3 ||
+      count_if(w5.begin(), w5.end(), [](Weights::iterator::value_type kv) { return kv.second > 3; }) != 2) return 1;
+
+  // Schemas of key sets no longer in use are released, and interned afresh when needed again
+  for (size_t i = 0; i < 1000; ++i) Weights w(vector<string>{"K" + to_string(i)}, 1.0);
+  if (Weights(keys).schema() != w1.schema() || Weights(vector<string>{"K7"}).keys()[0] != "K7") return 1;
+
+  // Mismatched keys and null schemas throw, and missing keys have no index
+  try {
+    w5 += w4;
+    return 1;
+  } catch (const WeightError&) { }
+  try {
+    Weights(WeightsSchema::Ptr(), vector<double>());
+    return 1;
+  } catch (const WeightError&) { }
+  if (w5.schema()->index("QUX") != WeightsSchema::npos || w5.schema()->index("FOO") != 2) return 1;
+
   return 0;
 }